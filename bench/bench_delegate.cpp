@@ -0,0 +1,79 @@
+#include "delegate.h"
+#include "slog.h"
+
+#include "benchmark/benchmark.h"
+
+#include <cstdint>
+#include <functional>
+
+
+/* Appender stand-in, kept out of line so both wrappers make a real call */
+static void __attribute__((noinline)) count_appender(const char* msg) {
+    benchmark::DoNotOptimize(msg);
+}
+
+/* State captured by the lambdas, 24 bytes is past the std::function small buffer */
+struct appender_state {
+    int64_t calls;
+    int64_t bytes;
+    int64_t lines;
+};
+
+/* Call cost of a function pointer appender */
+template <typename Wrapper>
+static void BM_call_function(benchmark::State& state) {
+    Wrapper appender = count_appender;
+    const char* msg = "\n[INFO ][bench] message";
+
+    for (auto _ : state) {
+        appender(msg);
+    }
+}
+BENCHMARK_TEMPLATE(BM_call_function, std::function<void(const char*)>);
+BENCHMARK_TEMPLATE(BM_call_function, slog::appender_fn);
+
+/* Call cost of a lambda capturing a reference */
+template <typename Wrapper>
+static void BM_call_lambda(benchmark::State& state) {
+    appender_state counters = {0, 0, 0};
+    Wrapper appender = [&counters](const char* msg) {
+        counters.calls += 1;
+        benchmark::DoNotOptimize(msg);
+    };
+    const char* msg = "\n[INFO ][bench] message";
+
+    for (auto _ : state) {
+        appender(msg);
+    }
+    benchmark::DoNotOptimize(counters);
+}
+BENCHMARK_TEMPLATE(BM_call_lambda, std::function<void(const char*)>);
+BENCHMARK_TEMPLATE(BM_call_lambda, slog::appender_fn);
+
+/* Building the wrapper from a lambda capturing 24 bytes by value, std::function allocates */
+template <typename Wrapper>
+static void BM_construct_lambda(benchmark::State& state) {
+    appender_state counters = {1, 2, 3};
+    const char* msg = "\n[INFO ][bench] message";
+
+    for (auto _ : state) {
+        Wrapper appender = [counters](const char* text) {
+            benchmark::DoNotOptimize(counters);
+            benchmark::DoNotOptimize(text);
+        };
+        appender(msg);
+    }
+}
+BENCHMARK_TEMPLATE(BM_construct_lambda, std::function<void(const char*)>);
+BENCHMARK_TEMPLATE(BM_construct_lambda, slog::appender_fn);
+
+/* Whole record through the logger with a function pointer appender */
+static void BM_logger_appender(benchmark::State& state) {
+    slog::logger logger("bench");
+    logger.add_appender(count_appender);
+
+    for (auto _ : state) {
+        logger.log(slog::logger::level::info, "connection accepted");
+    }
+}
+BENCHMARK(BM_logger_appender);
@@ -0,0 +1,102 @@
+#include "format.h"
+
+#include "benchmark/benchmark.h"
+
+#include <cstring>
+#include <string>
+
+
+/* Message of the given length, with a control character every dirty_every bytes (0 for none) */
+static std::string make_text(size_t len, size_t dirty_every) {
+    std::string text;
+    for (size_t i = 0; i < len; ++i) {
+        text += dirty_every != 0 && i % dirty_every == dirty_every - 1 ? '\n' : static_cast<char>('a' + i % 26);
+    }
+    return text;
+}
+
+/* Previous implementation, one test and one copy per byte */
+static size_t legacy_json_escaped(char* out, size_t room, const char* data, size_t size) {
+    static constexpr char hex_digits[] = "0123456789abcdef";
+    size_t len = 0;
+
+    for (size_t i = 0; i < size; ++i) {
+        const unsigned char c = static_cast<unsigned char>(data[i]);
+
+        if (c >= 0x20 && c != '"' && c != '\\') {
+            if (len == room) {
+                break;
+            }
+            out[len++] = static_cast<char>(c);
+            continue;
+        }
+
+        char escape = '\0';
+        switch (c) {
+            case '"': escape = '"'; break;
+            case '\\': escape = '\\'; break;
+            case '\n': escape = 'n'; break;
+            case '\r': escape = 'r'; break;
+            case '\t': escape = 't'; break;
+            case '\b': escape = 'b'; break;
+            case '\f': escape = 'f'; break;
+            default: break;
+        }
+
+        if (escape != '\0') {
+            if (room - len < 2) {
+                break;
+            }
+            out[len] = '\\';
+            out[len + 1] = escape;
+            len += 2;
+        } else {
+            if (room - len < 6) {
+                break;
+            }
+            std::memcpy(&out[len], "\\u00", 4);
+            out[len + 4] = hex_digits[c >> 4];
+            out[len + 5] = hex_digits[c & 0xf];
+            len += 6;
+        }
+    }
+
+    return len;
+}
+
+template <size_t (*Escape)(char*, size_t, const char*, size_t)>
+static void run_escape(benchmark::State& state) {
+    const std::string text = make_text(static_cast<size_t>(state.range(0)), static_cast<size_t>(state.range(1)));
+    char out[1024];
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(Escape(out, sizeof(out), text.data(), text.size()));
+        benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * state.range(0));
+}
+
+/* Clean text (dirty 0) and a new line every 64 or 8 bytes */
+static void escape_args(benchmark::internal::Benchmark* bench) {
+    bench->ArgNames({"len", "dirty"});
+    for (int64_t len : {16, 64, 200}) {
+        for (int64_t dirty : {0, 64, 8}) {
+            bench->Args({len, dirty});
+        }
+    }
+}
+
+static void BM_escape_json_legacy(benchmark::State& state) {
+    run_escape<legacy_json_escaped>(state);
+}
+BENCHMARK(BM_escape_json_legacy)->Apply(escape_args);
+
+static void BM_escape_json(benchmark::State& state) {
+    run_escape<slog::fmt::write_json_escaped>(state);
+}
+BENCHMARK(BM_escape_json)->Apply(escape_args);
+
+static void BM_escape_sanitize(benchmark::State& state) {
+    run_escape<slog::fmt::write_sanitized>(state);
+}
+BENCHMARK(BM_escape_sanitize)->Apply(escape_args);
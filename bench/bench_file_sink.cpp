@@ -0,0 +1,88 @@
+#include "file_sink.h"
+#include "mmap_sink.h"
+#include "slog.h"
+
+#include "benchmark/benchmark.h"
+
+#include <cstdio>
+
+
+static const char* const bench_path = "/tmp/slog_bench_file.log";
+
+/* The record as the legacy logger handed it over, one fragment per appender call */
+static const char* const fragments[] = {
+    "\n", "[23:25:16.753]", "[INFO ]", "[bench]", " value ", "42"
+};
+
+/* Naive appender, fputs and fflush for each fragment so each one reaches the file */
+static void BM_file_fputs_fragments(benchmark::State& state) {
+    FILE* file = std::fopen(bench_path, "w");
+
+    for (auto _ : state) {
+        for (const char* fragment : fragments) {
+            std::fputs(fragment, file);
+            std::fflush(file);
+        }
+    }
+
+    std::fclose(file);
+    state.counters["records/s"] = benchmark::Counter(static_cast<double>(state.iterations()),
+                                                     benchmark::Counter::kIsRate);
+}
+BENCHMARK(BM_file_fputs_fragments);
+
+/* Same appender with the whole record, the usual lambda written today */
+static void BM_file_fputs_record(benchmark::State& state) {
+    FILE* file = std::fopen(bench_path, "w");
+    slog::logger logger("bench");
+    logger.add_appender([file](const char* msg) {
+        std::fputs(msg, file);
+        std::fflush(file);
+    });
+
+    for (auto _ : state) {
+        logger.log(slog::logger::level::info, "value ") << 42;
+    }
+
+    std::fclose(file);
+    state.counters["records/s"] = benchmark::Counter(static_cast<double>(state.iterations()),
+                                                     benchmark::Counter::kIsRate);
+}
+BENCHMARK(BM_file_fputs_record);
+
+/* Buffered file sink, the argument is the buffer size */
+static void BM_file_sink(benchmark::State& state) {
+    static char buffer[1 << 20];
+    slog::file_sink sink(buffer, static_cast<size_t>(state.range(0)));
+    sink.open(bench_path, true);
+    slog::logger logger("bench");
+    logger.add_sink(sink);
+
+    for (auto _ : state) {
+        logger.log(slog::logger::level::info, "value ") << 42;
+    }
+
+    sink.flush();
+    state.counters["records/s"] = benchmark::Counter(static_cast<double>(state.iterations()),
+                                                     benchmark::Counter::kIsRate);
+    state.counters["writes/record"] = static_cast<double>(sink.get_write_calls()) /
+                                      static_cast<double>(state.iterations());
+}
+BENCHMARK(BM_file_sink)->ArgName("buffer")->Arg(4096)->Arg(65536)->Arg(1 << 20);
+
+/* Memory mapped file, the argument is the segment size */
+static void BM_mmap_sink(benchmark::State& state) {
+    slog::mmap_sink sink(static_cast<size_t>(state.range(0)));
+    sink.open(bench_path, true);
+    slog::logger logger("bench");
+    logger.add_sink(sink);
+
+    for (auto _ : state) {
+        logger.log(slog::logger::level::info, "value ") << 42;
+    }
+
+    sink.close();
+    state.counters["records/s"] = benchmark::Counter(static_cast<double>(state.iterations()),
+                                                     benchmark::Counter::kIsRate);
+}
+BENCHMARK(BM_mmap_sink)->ArgName("segment")->Arg(1 << 20)->Arg(16 << 20);
@@ -0,0 +1,103 @@
+#include "format.h"
+
+#include "benchmark/benchmark.h"
+
+#include <cstdint>
+#include <cstdlib>
+
+
+/* Values with a realistic spread of lengths, from single digits to full 64 bit */
+static const int64_t values[] = {
+    7, -42, 170, 4096, -65535, 1000000, 123456789, -2147483647, 9876543210LL, INT64_MAX
+};
+static constexpr size_t nbr_values = sizeof(values) / sizeof(values[0]);
+
+/* Previous implementation, one division per digit and a reverse pass */
+template <typename T>
+static size_t legacy_format(char* fielddata, T value, unsigned int radix) {
+    const char* const digits = "0123456789ABCDEF";
+    size_t fieldindex = 0;
+    int first = 0;
+
+    switch (radix) {
+        case 2:
+            fielddata[0] = '0';
+            fielddata[1] = 'b';
+            fieldindex += 2;
+            first += 2;
+            break;
+        case 8:
+            fielddata[0] = '0';
+            fielddata[1] = 'o';
+            fieldindex += 2;
+            first += 2;
+            break;
+        case 16:
+            fielddata[0] = '0';
+            fielddata[1] = 'x';
+            fieldindex += 2;
+            first += 2;
+            break;
+        default:
+            break;
+    }
+
+    T remainder;
+    do {
+        remainder = value % radix;
+        fielddata[fieldindex] = digits[remainder];
+        value /= radix;
+        fieldindex += 1;
+    } while (value != 0);
+
+    int last = static_cast<int>(fieldindex) - 1;
+    while ((last - first) > 0) {
+        char tmp = fielddata[last];
+        fielddata[last] = fielddata[first];
+        fielddata[first] = tmp;
+        first += 1;
+        last -= 1;
+    }
+
+    return fieldindex;
+}
+
+static void BM_integer_legacy(benchmark::State& state) {
+    const unsigned int radix = static_cast<unsigned int>(state.range(0));
+    char field[slog::fmt::max_integer_len];
+    size_t i = 0;
+
+    for (auto _ : state) {
+        /* the legacy code only handled positive values correctly */
+        const uint64_t value = static_cast<uint64_t>(std::llabs(values[i++ % nbr_values]));
+        benchmark::DoNotOptimize(legacy_format(field, value, radix));
+        benchmark::DoNotOptimize(field);
+    }
+}
+BENCHMARK(BM_integer_legacy)->Arg(10)->Arg(16)->Arg(2);
+
+static void BM_integer_format(benchmark::State& state) {
+    const slog::fmt::int_spec spec = {static_cast<uint8_t>(state.range(0)), 0, ' ', true};
+    char field[slog::fmt::max_integer_len];
+    size_t i = 0;
+
+    for (auto _ : state) {
+        const uint64_t value = static_cast<uint64_t>(std::llabs(values[i++ % nbr_values]));
+        benchmark::DoNotOptimize(slog::fmt::write_integer(field, value, spec));
+        benchmark::DoNotOptimize(field);
+    }
+}
+BENCHMARK(BM_integer_format)->Arg(10)->Arg(16)->Arg(2);
+
+/* Signed values and a zero padded width, the common "%08d" case */
+static void BM_integer_format_padded(benchmark::State& state) {
+    const slog::fmt::int_spec spec = {10, 8, '0', true};
+    char field[slog::fmt::max_integer_len];
+    size_t i = 0;
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(slog::fmt::write_integer(field, values[i++ % nbr_values], spec));
+        benchmark::DoNotOptimize(field);
+    }
+}
+BENCHMARK(BM_integer_format_padded);
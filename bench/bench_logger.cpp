@@ -0,0 +1,217 @@
+#include "slog.h"
+
+#include "benchmark/benchmark.h"
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+
+
+/* Appender that only touches the record, so the benchmarks measure the logger itself */
+static void null_appender(const char* msg) {
+    benchmark::DoNotOptimize(msg);
+}
+
+/* Time that moves one millisecond per record, like a busy logger */
+static slog::timedate next_time() {
+    static thread_local uint32_t counter = 0;
+    slog::timedate td;
+    td.setMYear(2024);
+    td.setMMonth(1);
+    td.setMDay(30);
+    td.setMHour(23);
+    td.setMMinute(static_cast<uint8_t>((counter / 60000) % 60));
+    td.setMSecond(static_cast<uint8_t>((counter / 1000) % 60));
+    td.setMMillisecond(static_cast<uint16_t>(counter % 1000));
+    counter += 1;
+    return td;
+}
+
+/* Every benchmark writes one record per iteration, so the time column is the time per record in
+ * nanoseconds, the counter adds the throughput */
+static void set_record_counters(benchmark::State& state) {
+    state.counters["records/s"] = benchmark::Counter(static_cast<double>(state.iterations()),
+                                                     benchmark::Counter::kIsRate);
+}
+
+/* A fresh logger writing to the null appender for each run, the counters are set once the run is done */
+class logger_bench : public benchmark::Fixture {
+public:
+    using benchmark::Fixture::SetUp;
+    using benchmark::Fixture::TearDown;
+
+    void SetUp(benchmark::State&) override {
+        m_logger.reset(new slog::logger("bench"));
+        m_logger->add_appender(null_appender);
+    }
+
+    void TearDown(benchmark::State& state) override {
+        set_record_counters(state);
+        m_logger.reset();
+    }
+
+protected:
+    std::unique_ptr<slog::logger> m_logger;
+};
+
+/* Plain message, without timestamp, with the time and with the date */
+BENCHMARK_DEFINE_F(logger_bench, BM_log_message)(benchmark::State& state) {
+    if (state.range(0) != 0) {
+        m_logger->set_time_provider(next_time);
+        m_logger->set_print_date(state.range(0) == 2);
+    }
+
+    for (auto _ : state) {
+        m_logger->log(slog::logger::level::info, "connection accepted");
+    }
+}
+BENCHMARK_REGISTER_F(logger_bench, BM_log_message)->ArgName("timestamp")->Arg(0)->Arg(1)->Arg(2);
+
+/* Records below the level, through the makro and through log() */
+BENCHMARK_DEFINE_F(logger_bench, BM_log_filtered)(benchmark::State& state) {
+    slog::logger& logger = *m_logger;
+    logger.set_Level(slog::logger::level::warn);
+    int value = 42;
+
+    for (auto _ : state) {
+        if (state.range(0) != 0) {
+            SLOG_DEBUG(logger, "value ") << value;
+        } else {
+            logger.log(slog::logger::level::debug, "value ") << value;
+        }
+        benchmark::DoNotOptimize(value);
+    }
+}
+BENCHMARK_REGISTER_F(logger_bench, BM_log_filtered)->ArgName("makro")->Arg(0)->Arg(1);
+
+/* Debug records below the info level kept by the backtrace buffer, compared with the same
+ * records formatted at the debug level */
+BENCHMARK_DEFINE_F(logger_bench, BM_log_backtrace)(benchmark::State& state) {
+    static slog::backtrace_slot slots[1024];
+    slog::logger& logger = *m_logger;
+    logger.set_time_provider(next_time);
+    if (state.range(0) != 0) {
+        logger.enable_backtrace(slots, 1024);
+    } else {
+        logger.set_Level(slog::logger::level::debug);
+    }
+    int64_t value = 123456789;
+    double ratio = 0.25;
+
+    for (auto _ : state) {
+        SLOG_DEBUG(logger, "value ") << value << " ratio " << ratio << slog::logger::radix::hex << " mask " << value;
+        benchmark::DoNotOptimize(value);
+    }
+}
+BENCHMARK_REGISTER_F(logger_bench, BM_log_backtrace)->ArgName("kept")->Arg(0)->Arg(1);
+
+/* Identical records with the deduplication on, all suppressed but the first one */
+BENCHMARK_DEFINE_F(logger_bench, BM_log_dedup_repeated)(benchmark::State& state) {
+    slog::logger& logger = *m_logger;
+    logger.set_time_provider(next_time);
+    logger.set_dedup_window(std::chrono::seconds(10));
+
+    for (auto _ : state) {
+        SLOG_INFO(logger, "connection refused by server ") << 42;
+    }
+}
+BENCHMARK_REGISTER_F(logger_bench, BM_log_dedup_repeated);
+
+/* Metrics disabled (0) and collected (1), for a written record and a filtered one */
+BENCHMARK_DEFINE_F(logger_bench, BM_log_metrics)(benchmark::State& state) {
+    slog::logger& logger = *m_logger;
+    logger.set_metrics(state.range(0) != 0);
+    const auto lvl = state.range(1) != 0 ? slog::logger::level::debug : slog::logger::level::info;
+    int value = 42;
+
+    for (auto _ : state) {
+        logger.log(lvl, "value ") << value;
+        benchmark::DoNotOptimize(value);
+    }
+}
+BENCHMARK_REGISTER_F(logger_bench, BM_log_metrics)->ArgNames({"metrics", "filtered"})->ArgsProduct({{0, 1}, {0, 1}});
+
+/* One integer per record in each radix */
+BENCHMARK_DEFINE_F(logger_bench, BM_log_integer)(benchmark::State& state) {
+    const auto rdx = static_cast<slog::logger::radix>(state.range(0));
+    int64_t value = 123456789;
+
+    for (auto _ : state) {
+        m_logger->log(slog::logger::level::info, "value ") << rdx << value;
+        value += 7;
+    }
+}
+BENCHMARK_REGISTER_F(logger_bench, BM_log_integer)->ArgName("radix")->Arg(2)->Arg(8)->Arg(10)->Arg(16);
+
+/* The three durations in one record */
+BENCHMARK_DEFINE_F(logger_bench, BM_log_chrono)(benchmark::State& state) {
+    int64_t value = 1500;
+
+    for (auto _ : state) {
+        m_logger->log(slog::logger::level::info, "elapsed ") << std::chrono::seconds(value) << " "
+            << std::chrono::milliseconds(value) << " " << std::chrono::microseconds(value);
+        value += 1;
+    }
+}
+BENCHMARK_REGISTER_F(logger_bench, BM_log_chrono);
+
+/* Same record with the << operator and with a format string */
+BENCHMARK_DEFINE_F(logger_bench, BM_log_stream_vs_format)(benchmark::State& state) {
+    slog::logger& logger = *m_logger;
+    int64_t value = 123456789;
+    const double ratio = 0.25;
+
+    for (auto _ : state) {
+        if (state.range(0) != 0) {
+            SLOG_LOGF(logger, slog::logger::level::info, "id {} ratio {} done", value, ratio);
+        } else {
+            logger.log(slog::logger::level::info, "id ") << value << " ratio " << ratio << " done";
+        }
+        value += 1;
+    }
+}
+BENCHMARK_REGISTER_F(logger_bench, BM_log_stream_vs_format)->ArgName("logf")->Arg(0)->Arg(1);
+
+/* Fan out to one appender or to every slot */
+BENCHMARK_DEFINE_F(logger_bench, BM_log_appenders)(benchmark::State& state) {
+    for (int64_t i = 1; i < state.range(0); ++i) {
+        m_logger->add_appender(null_appender);
+    }
+
+    for (auto _ : state) {
+        m_logger->log(slog::logger::level::info, "value ") << 42;
+    }
+}
+BENCHMARK_REGISTER_F(logger_bench, BM_log_appenders)->ArgName("appenders")->Arg(1)->Arg(MAX_NBR_LOG_APPENDER);
+
+/* Loggers shared by the threads of a benchmark, set up once by the first thread to use them */
+static slog::logger& shared_logger() {
+    static slog::logger logger("shared");
+    static const bool configured = logger.add_appender(null_appender);
+    (void)configured;
+    return logger;
+}
+
+static slog::logger& shared_async_logger() {
+    static slog::async_slot slots[1024];
+    static slog::logger logger("shared_async");
+    static const bool configured = logger.add_appender(null_appender) && logger.start_async(slots, 1024);
+    (void)configured;
+    return logger;
+}
+
+/* Several producer threads on one logger, synchronous or asynchronous */
+static void BM_log_threads(benchmark::State& state) {
+    slog::logger& logger = state.range(0) != 0 ? shared_async_logger() : shared_logger();
+    int64_t value = state.thread_index();
+
+    for (auto _ : state) {
+        logger.log(slog::logger::level::info, "value ") << value;
+        value += 1;
+    }
+    if (state.range(0) != 0 && state.thread_index() == 0) {
+        logger.flush();
+    }
+    set_record_counters(state);
+}
+BENCHMARK(BM_log_threads)->ArgName("async")->Arg(0)->Arg(1)->ThreadRange(1, 8)->UseRealTime();
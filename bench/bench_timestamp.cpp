@@ -0,0 +1,71 @@
+#include "timestamp.h"
+
+#include "benchmark/benchmark.h"
+
+#include <cstdio>
+
+
+/* Time that moves one millisecond per record, like a busy logger */
+static slog::timedate next_time(uint32_t counter) {
+    slog::timedate td;
+    td.setMYear(2024);
+    td.setMMonth(1);
+    td.setMDay(30);
+    td.setMHour(23);
+    td.setMMinute(static_cast<uint8_t>((counter / 60000) % 60));
+    td.setMSecond(static_cast<uint8_t>((counter / 1000) % 60));
+    td.setMMillisecond(static_cast<uint16_t>(counter % 1000));
+    return td;
+}
+
+/* Previous implementation, a full snprintf per record */
+static void BM_timestamp_snprintf(benchmark::State& state) {
+    const bool print_date = state.range(0) != 0;
+    char timestamp[40];
+    uint32_t counter = 0;
+
+    for (auto _ : state) {
+        slog::timedate td = next_time(counter++);
+        if (print_date) {
+            std::snprintf(timestamp, sizeof(timestamp), "[%04d/%02d/%02d %02d:%02d:%02d.%03d]",
+                          td.getMYear(), td.getMMonth(), td.getMDay(),
+                          td.getMHour(), td.getMMinute(), td.getMSecond(), td.getMMillisecond());
+        } else {
+            std::snprintf(timestamp, sizeof(timestamp), "[%02d:%02d:%02d.%03d]",
+                          td.getMHour(), td.getMMinute(), td.getMSecond(), td.getMMillisecond());
+        }
+        benchmark::DoNotOptimize(timestamp);
+    }
+}
+BENCHMARK(BM_timestamp_snprintf)->Arg(0)->Arg(1);
+
+/* Cached rendering, only the changed fields are rewritten */
+static void BM_timestamp_cached(benchmark::State& state) {
+    const bool print_date = state.range(0) != 0;
+    slog::timestamp_cache cache;
+    char timestamp[slog::timestamp_cache::max_len];
+    uint32_t counter = 0;
+
+    for (auto _ : state) {
+        slog::timedate td = next_time(counter++);
+        benchmark::DoNotOptimize(cache.render(td, print_date, timestamp));
+        benchmark::DoNotOptimize(timestamp);
+    }
+}
+BENCHMARK(BM_timestamp_cached)->Arg(0)->Arg(1);
+
+/* Raw ticks, one calendar conversion per second */
+static void BM_timestamp_ticks(benchmark::State& state) {
+    const bool print_date = state.range(0) != 0;
+    slog::timestamp_cache cache;
+    char timestamp[slog::timestamp_cache::max_len];
+    uint64_t ticks = 1706657116753000000ull;
+
+    for (auto _ : state) {
+        /* 1 microsecond per record */
+        ticks += 1000;
+        benchmark::DoNotOptimize(cache.render(ticks, 1000000000ull, print_date, timestamp));
+        benchmark::DoNotOptimize(timestamp);
+    }
+}
+BENCHMARK(BM_timestamp_ticks)->Arg(0)->Arg(1);
@@ -0,0 +1,105 @@
+//
+// Created by lcrgo on 17/10/2026.
+//
+
+#include "async_ring.h"
+
+#include <cstring>
+
+namespace slog {
+
+    async_ring::async_ring() :
+    m_slots(nullptr),
+    m_mask(0),
+    m_enqueue_pos(0),
+    m_dequeue_pos(0) {}
+
+    bool async_ring::init(async_slot* slots, size_t nbr_slots) {
+        /* The number of slots must be a power of two so the position can be masked */
+        if (slots == nullptr || nbr_slots < 2 || (nbr_slots & (nbr_slots - 1)) != 0) {
+            return false;
+        }
+
+        for (size_t i = 0; i < nbr_slots; ++i) {
+            slots[i].sequence.store(i, std::memory_order_relaxed);
+        }
+
+        m_slots = slots;
+        m_mask = nbr_slots - 1;
+        m_enqueue_pos.store(0, std::memory_order_relaxed);
+        m_dequeue_pos.store(0, std::memory_order_release);
+
+        return true;
+    }
+
+    bool async_ring::try_push(const record& rec, uint64_t tick, size_t timestamp_len) {
+        async_slot* slot;
+        size_t pos = m_enqueue_pos.load(std::memory_order_relaxed);
+
+        for (;;) {
+            slot = &m_slots[pos & m_mask];
+            const size_t seq = slot->sequence.load(std::memory_order_acquire);
+            const intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+
+            if (diff == 0) {
+                /* The slot is free, try to claim it */
+                if (m_enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                /* The slot still holds a record from the previous lap, the ring is full */
+                return false;
+            } else {
+                /* Another producer claimed it, reload the position */
+                pos = m_enqueue_pos.load(std::memory_order_relaxed);
+            }
+        }
+
+        /* Records are always smaller than the slot, copy it with the null terminator */
+        size_t size = rec.size < sizeof(slot->data) ? rec.size : sizeof(slot->data) - 1;
+        std::memcpy(slot->data, rec.data, size);
+        slot->data[size] = '\0';
+        slot->size = size;
+        slot->lvl = rec.lvl;
+        slot->backtrace = rec.backtrace;
+        slot->site = rec.site;
+        slot->tick = tick;
+        slot->timestamp_len = timestamp_len;
+
+        /* Publish the record to the consumer */
+        slot->sequence.store(pos + 1, std::memory_order_release);
+
+        return true;
+    }
+
+    async_slot* async_ring::peek(size_t offset) const {
+        const size_t pos = m_dequeue_pos.load(std::memory_order_relaxed) + offset;
+        async_slot* slot = &m_slots[pos & m_mask];
+
+        if (offset > m_mask || slot->sequence.load(std::memory_order_acquire) != pos + 1) {
+            return nullptr;
+        }
+
+        return slot;
+    }
+
+    void async_ring::release(size_t count) {
+        size_t pos = m_dequeue_pos.load(std::memory_order_relaxed);
+
+        for (size_t i = 0; i < count; ++i, ++pos) {
+            /* Hand the slot to the producers of the next lap */
+            m_slots[pos & m_mask].sequence.store(pos + m_mask + 1, std::memory_order_release);
+        }
+
+        m_dequeue_pos.store(pos, std::memory_order_release);
+    }
+
+    size_t async_ring::pushed() const {
+        return m_enqueue_pos.load(std::memory_order_acquire);
+    }
+
+    size_t async_ring::consumed() const {
+        return m_dequeue_pos.load(std::memory_order_acquire);
+    }
+
+} // slog
@@ -0,0 +1,97 @@
+//
+// Created by lcrgo on 17/10/2026.
+//
+
+#ifndef SMALL_LOG_ASYNC_RING_H
+#define SMALL_LOG_ASYNC_RING_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include "record.h"
+
+namespace slog {
+
+    /**
+     * @brief Storage for one record in the asynchronous ring. The slots are provided by the user
+     *        (usually a static array) so the ring never allocates.
+     */
+    struct async_slot {
+        std::atomic<size_t> sequence;
+        level lvl;
+        bool backtrace;       /* replayed from the backtrace buffer */
+        const call_site* site;
+        size_t size;
+        uint64_t tick;        /* raw time of a timestamp rendered by the consumer */
+        size_t timestamp_len; /* 0, or length of the timestamp reserved after the new line */
+        char data[MAX_LOG_RECORD_LEN];
+    };
+
+    /**
+     * @brief Bounded lock-free multi producer / single consumer ring of records.
+     *        Each slot carries a sequence number telling if it is free for the producers or
+     *        ready for the consumer, so producers only contend on the enqueue position.
+     */
+    class async_ring {
+    public:
+        async_ring();
+        /* disable copy constructor */
+        async_ring(const async_ring&) = delete;
+        /* disable copy assignment */
+        async_ring& operator=(const async_ring&) = delete;
+
+        /**
+         * @brief Attach the ring to its storage, must be called before any other function and
+         *        while there are no producers nor consumer
+         * @param slots, slot storage
+         * @param nbr_slots, number of slots, must be a power of two
+         * @return true if the storage is valid, false otherwise
+         */
+        bool init(async_slot* slots, size_t nbr_slots);
+
+        /**
+         * @brief Copy a record into the ring (producers)
+         * @param rec, record to be copied
+         * @param tick, raw time of a deferred timestamp
+         * @param timestamp_len, length reserved in the record for the deferred timestamp, 0 if none
+         * @return true if the record was queued, false if the ring is full
+         */
+        bool try_push(const record& rec, uint64_t tick = 0, size_t timestamp_len = 0);
+
+        /**
+         * @brief Get a ready record without removing it (consumer). The consumer may update the
+         *        record in place until it is released.
+         * @param offset, position relative to the oldest record
+         * @return slot holding the record, nullptr if that record is not ready
+         */
+        async_slot* peek(size_t offset) const;
+
+        /**
+         * @brief Give the oldest records back to the producers (consumer)
+         * @param count, number of records to release, they must have been peeked
+         */
+        void release(size_t count);
+
+        /**
+         * @brief Number of records claimed by the producers so far, ready or not
+         * @return size_t, total number of pushed records
+         */
+        size_t pushed() const;
+
+        /**
+         * @brief Number of records released by the consumer so far
+         * @return size_t, total number of consumed records
+         */
+        size_t consumed() const;
+
+    private:
+        async_slot* m_slots;
+        size_t m_mask;
+        alignas(64) std::atomic<size_t> m_enqueue_pos;
+        alignas(64) std::atomic<size_t> m_dequeue_pos;
+    };
+
+} // slog
+
+#endif //SMALL_LOG_ASYNC_RING_H
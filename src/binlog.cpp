@@ -0,0 +1,391 @@
+//
+// Created by lcrgo on 17/10/2026.
+//
+
+#include "binlog.h"
+
+#include <cinttypes>
+#include <cstdio>
+#include <thread>
+
+namespace slog {
+
+    /* Site ids are unique in the process, 0 means not used yet and pending_id that the id is
+     * being given */
+    static std::atomic<uint32_t> next_site_id(1);
+    static constexpr uint32_t pending_id = UINT32_MAX;
+
+    /* Description of the first sites, replayed to the sinks added after their first use. The
+     * format and the types are static, an entry is written once before its id is published */
+    struct site_definition {
+        const char* fmt;
+        const uint8_t* types;
+        size_t nbr_args;
+    };
+    static site_definition site_definitions[MAX_BIN_SITES];
+
+    static uint32_t register_site(bin_site& site, const char* fmt, const uint8_t* types, size_t nbr_args) {
+        uint32_t id = site.id.load(std::memory_order_acquire);
+        if (id != 0 && id != pending_id) {
+            return id;
+        }
+
+        /* Only the first caller gives the id, the others wait for it */
+        id = 0;
+        if (!site.id.compare_exchange_strong(id, pending_id, std::memory_order_acquire)) {
+            while ((id = site.id.load(std::memory_order_acquire)) == pending_id) {
+                std::this_thread::yield();
+            }
+            return id;
+        }
+
+        id = next_site_id.fetch_add(1, std::memory_order_relaxed);
+        if (id < MAX_BIN_SITES) {
+            site_definitions[id] = site_definition{fmt, types, nbr_args};
+        }
+        site.id.store(id, std::memory_order_release);
+
+        return id;
+    }
+
+    static size_t encode_definition(char* data, uint32_t id, const char* fmt, const uint8_t* types, size_t nbr_args) {
+        size_t fmt_len = std::strlen(fmt);
+        const size_t room = MAX_LOG_RECORD_LEN - 1 - (1 + sizeof(uint32_t) + 1 + nbr_args + sizeof(uint16_t));
+        if (fmt_len > room) {
+            fmt_len = room;
+        }
+
+        bin::encoder enc = {data, 0, 0};
+        enc.put(bin::definition_tag);
+        enc.put(id);
+        enc.put(static_cast<uint8_t>(nbr_args));
+        std::memcpy(&data[enc.size], types, nbr_args);
+        enc.size += nbr_args;
+        enc.put(static_cast<uint16_t>(fmt_len));
+        std::memcpy(&data[enc.size], fmt, fmt_len);
+        enc.size += fmt_len;
+        data[enc.size] = '\0';
+
+        return enc.size;
+    }
+
+    binary_logger::binary_logger(const char* logger_name) :
+    m_level(level::info),
+    m_tick_source(system_clock_ns),
+    m_ticks_per_second(1000000000) {
+
+        /* Store the given logger name up to the buffer size, the excess will be trimmed */
+        std::snprintf(m_logger_name, sizeof(m_logger_name), "%s", logger_name);
+
+        for (int i = 0; i < MAX_NBR_LOG_APPENDER; ++i) {
+            m_sinks[i].store(nullptr, std::memory_order_relaxed);
+        }
+        for (std::atomic<uint64_t>& word : m_defined) {
+            word.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    binary_logger::~binary_logger() {}
+
+    const char *binary_logger::get_name() const {
+        return m_logger_name;
+    }
+
+    binary_logger::level binary_logger::get_Level() const {
+        return m_level.load(std::memory_order_relaxed);
+    }
+
+    void binary_logger::set_Level(level log_level) {
+        m_level.store(log_level, std::memory_order_relaxed);
+    }
+
+    void binary_logger::set_tick_source(tick_source source, uint64_t ticks_per_second) {
+        if (source != nullptr && ticks_per_second != 0) {
+            m_tick_source = source;
+            m_ticks_per_second = ticks_per_second;
+        }
+    }
+
+    bool binary_logger::add_sink(sink& output) {
+        std::lock_guard<std::mutex> lock(m_config_mutex);
+
+        for (int i = 0; i < MAX_NBR_LOG_APPENDER; ++i) {
+            if (m_sinks[i].load(std::memory_order_relaxed) == nullptr) {
+                /* Every stream starts with the header */
+                char data[sizeof(bin::magic) + sizeof(uint32_t) + sizeof(uint64_t) + 1 + MAX_LOG_NAME_LEN];
+                bin::encoder enc = {data, 0, 0};
+                const uint8_t name_len = static_cast<uint8_t>(std::strlen(m_logger_name));
+
+                enc.put(bin::magic);
+                enc.put(bin::byte_order);
+                enc.put(m_ticks_per_second);
+                enc.put(name_len);
+                std::memcpy(&data[enc.size], m_logger_name, name_len);
+                enc.size += name_len;
+                data[enc.size] = '\0';
+
+                output.write(record{data, enc.size, level::disabled});
+
+                /* The sites already used are described before the sink gets their records, the
+                 * lock keeps new definitions out until the sink is in place */
+                char definition[MAX_LOG_RECORD_LEN];
+                for (uint32_t id = 1; id < MAX_BIN_SITES; ++id) {
+                    if (is_defined(id)) {
+                        const site_definition& site = site_definitions[id];
+                        const size_t size = encode_definition(definition, id, site.fmt, site.types, site.nbr_args);
+                        output.write(record{definition, size, level::disabled});
+                    }
+                }
+
+                m_sinks[i].store(&output, std::memory_order_release);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    uint32_t binary_logger::define_site(bin_site &site, const char *fmt, const uint8_t *types, size_t nbr_args) {
+        const uint32_t id = register_site(site, fmt, types, nbr_args);
+
+        /* Each logger describes the site once to its sinks, the definition is written before
+         * the bit is set so no record of the site reaches a sink before it */
+        std::lock_guard<std::mutex> lock(m_config_mutex);
+        if (!is_defined(id)) {
+            char data[MAX_LOG_RECORD_LEN];
+            emit(data, encode_definition(data, id, fmt, types, nbr_args), level::disabled);
+            if (id < MAX_BIN_SITES) {
+                m_defined[id / 64].fetch_or(uint64_t(1) << (id % 64), std::memory_order_release);
+            }
+        }
+
+        return id;
+    }
+
+    void binary_logger::emit(char *data, size_t size, level log_level) {
+        data[size] = '\0';
+        const record rec = {data, size, log_level};
+
+        for (int i = 0; i < MAX_NBR_LOG_APPENDER; ++i) {
+            sink* output = m_sinks[i].load(std::memory_order_acquire);
+            if (output != nullptr) {
+                output->write(rec);
+            }
+        }
+    }
+
+    binary_decoder::binary_decoder() :
+    m_ticks_per_second(1),
+    m_print_date(false),
+    m_header_read(false),
+    m_skipped(0) {}
+
+    void binary_decoder::set_print_date(bool print_date) {
+        m_print_date = print_date;
+    }
+
+    size_t binary_decoder::get_skipped() const {
+        return m_skipped;
+    }
+
+    /* Bounds checked reader over the stream */
+    namespace {
+        struct reader {
+            const char* data;
+            size_t size;
+            size_t pos;
+
+            bool has(size_t count) const {
+                return size - pos >= count;
+            }
+
+            template <typename T>
+            bool get(T& value) {
+                if (!has(sizeof(value))) {
+                    return false;
+                }
+                std::memcpy(&value, &data[pos], sizeof(value));
+                pos += sizeof(value);
+                return true;
+            }
+
+            bool get_bytes(std::string& value, size_t count) {
+                if (!has(count)) {
+                    return false;
+                }
+                value.assign(&data[pos], count);
+                pos += count;
+                return true;
+            }
+        };
+    }
+
+    const binary_decoder::site_info *binary_decoder::find_site(uint32_t id) const {
+        for (const site_info& site : m_sites) {
+            if (site.id == id) {
+                return &site;
+            }
+        }
+        return nullptr;
+    }
+
+    size_t binary_decoder::decode(const char *data, size_t size, const std::function<void(const record &)> &output) {
+        reader rd = {data, size, 0};
+
+        if (!m_header_read) {
+            char magic[sizeof(bin::magic)];
+            uint32_t byte_order;
+            uint8_t name_len;
+
+            if (!rd.get(magic) || std::memcmp(magic, bin::magic, sizeof(magic)) != 0 ||
+                !rd.get(byte_order) || byte_order != bin::byte_order ||
+                !rd.get(m_ticks_per_second) || m_ticks_per_second == 0 ||
+                !rd.get(name_len) || !rd.get_bytes(m_name, name_len)) {
+                return 0;
+            }
+            m_header_read = true;
+        }
+
+        while (rd.has(1)) {
+            const size_t start = rd.pos;
+            char tag;
+            rd.get(tag);
+
+            if (tag == bin::definition_tag) {
+                site_info site;
+                uint16_t fmt_len;
+
+                if (!rd.get(site.id) || !rd.get(site.nbr_args) || site.nbr_args > bin::max_args ||
+                    !rd.has(site.nbr_args)) {
+                    return start;
+                }
+                std::memcpy(site.types, &rd.data[rd.pos], site.nbr_args);
+                rd.pos += site.nbr_args;
+                if (!rd.get(fmt_len) || !rd.get_bytes(site.format, fmt_len)) {
+                    return start;
+                }
+                m_sites.push_back(site);
+            } else if (tag == bin::record_tag) {
+                uint16_t length;
+                if (!rd.get(length) || !rd.has(length) || !decode_record(&data[rd.pos], length, output)) {
+                    return start;
+                }
+                rd.pos += length;
+            } else {
+                return start;
+            }
+        }
+
+        return rd.pos;
+    }
+
+    bool binary_decoder::decode_record(const char *data, size_t size, const std::function<void(const record &)> &output) {
+        reader rd = {data, size, 0};
+        uint32_t id;
+        uint8_t lvl;
+        uint64_t tick;
+
+        if (!rd.get(id) || !rd.get(lvl) || !rd.get(tick)) {
+            return false;
+        }
+
+        /* The record can't be rendered without its site, the next ones still can */
+        const site_info* site = find_site(id);
+        if (site == nullptr) {
+            m_skipped += 1;
+            return true;
+        }
+
+        /* Same layout as logger::write_prefix() */
+        std::string text = "\n";
+        char field[48];
+        const timedate td = ticks_to_timedate(tick, m_ticks_per_second);
+        if (m_print_date) {
+            std::snprintf(field, sizeof(field), "[%04d/%02d/%02d %02d:%02d:%02d.%03d]",
+                          td.getMYear(), td.getMMonth(), td.getMDay(),
+                          td.getMHour(), td.getMMinute(), td.getMSecond(), td.getMMillisecond());
+        } else {
+            std::snprintf(field, sizeof(field), "[%02d:%02d:%02d.%03d]",
+                          td.getMHour(), td.getMMinute(), td.getMSecond(), td.getMMillisecond());
+        }
+        text += field;
+        text += get_print_level_str(static_cast<level>(lvl));
+        text += "[" + m_name + "] ";
+
+        /* Read the arguments first, so extra arguments are skipped even without placeholder */
+        std::string args[bin::max_args];
+        for (size_t arg = 0; arg < site->nbr_args; ++arg) {
+            int64_t svalue;
+            uint64_t uvalue;
+            double fvalue;
+            char cvalue;
+            uint16_t len;
+
+            switch (static_cast<bin::arg_type>(site->types[arg])) {
+                case bin::arg_type::int64:
+                    if (!rd.get(svalue)) return false;
+                    std::snprintf(field, sizeof(field), "%" PRId64, svalue);
+                    args[arg] = field;
+                    break;
+                case bin::arg_type::uint64:
+                    if (!rd.get(uvalue)) return false;
+                    std::snprintf(field, sizeof(field), "%" PRIu64, uvalue);
+                    args[arg] = field;
+                    break;
+                case bin::arg_type::boolean:
+                    if (!rd.get(cvalue)) return false;
+                    args[arg] = cvalue != 0 ? "true" : "false";
+                    break;
+                case bin::arg_type::character:
+                    if (!rd.get(cvalue)) return false;
+                    args[arg] = cvalue;
+                    break;
+                case bin::arg_type::float64:
+                    if (!rd.get(fvalue)) return false;
+                    std::snprintf(field, sizeof(field), "%.17g", fvalue);
+                    args[arg] = field;
+                    break;
+                case bin::arg_type::string:
+                    if (!rd.get(len) || !rd.get_bytes(args[arg], len)) return false;
+                    break;
+                case bin::arg_type::seconds:
+                    if (!rd.get(svalue)) return false;
+                    std::snprintf(field, sizeof(field), "%" PRId64 "s", svalue);
+                    args[arg] = field;
+                    break;
+                case bin::arg_type::milliseconds:
+                    if (!rd.get(svalue)) return false;
+                    std::snprintf(field, sizeof(field), "%" PRId64 "ms", svalue);
+                    args[arg] = field;
+                    break;
+                case bin::arg_type::microseconds:
+                    if (!rd.get(svalue)) return false;
+                    std::snprintf(field, sizeof(field), "%" PRId64 "us", svalue);
+                    args[arg] = field;
+                    break;
+                default:
+                    return false;
+            }
+        }
+
+        /* Render the format string, each {} takes the next argument, {{ and }} are literal braces */
+        const std::string& fmt = site->format;
+        size_t arg = 0;
+        for (size_t i = 0; i < fmt.size(); ++i) {
+            if ((fmt[i] == '{' || fmt[i] == '}') && i + 1 < fmt.size() && fmt[i + 1] == fmt[i]) {
+                text += fmt[i];
+                i += 1;
+            } else if (fmt[i] == '{' && i + 1 < fmt.size() && fmt[i + 1] == '}' && arg < site->nbr_args) {
+                text += args[arg];
+                arg += 1;
+                i += 1;
+            } else {
+                text += fmt[i];
+            }
+        }
+
+        output(record{text.c_str(), text.size(), static_cast<level>(lvl)});
+
+        return true;
+    }
+
+} // slog
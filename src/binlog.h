@@ -0,0 +1,346 @@
+//
+// Created by lcrgo on 17/10/2026.
+//
+
+#ifndef SMALL_LOG_BINLOG_H
+#define SMALL_LOG_BINLOG_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#include "slog.h"
+#include "tick.h"
+
+namespace slog {
+
+#ifndef MAX_BIN_SITES
+#define MAX_BIN_SITES 1024 /* Binary call sites whose definitions are kept for the sinks added later */
+#endif
+
+    /* Binary stream layout (host byte order)
+     *  header     : "SLOGBIN2" | u32 0x01020304 | u64 ticks per second | u8 name length | name
+     *  definition : 'D' | u32 site id | u8 number of args | u8 arg type[] | u16 format length | format
+     *  record     : 'R' | u16 length of the rest | u32 site id | u8 level | u64 tick | arg[]
+     * Fixed size arguments are stored as they are in memory, strings as u16 length + bytes.
+     * Each call site is described once by a definition, placed before its first record; a sink
+     * added later gets the known definitions right after its header. The record length lets a
+     * decoder skip the records of a site it doesn't know. */
+    namespace bin {
+        constexpr char magic[8] = {'S', 'L', 'O', 'G', 'B', 'I', 'N', '2'};
+        constexpr uint32_t byte_order = 0x01020304;
+        constexpr char definition_tag = 'D';
+        constexpr char record_tag = 'R';
+        constexpr size_t record_header_size = 1 + sizeof(uint16_t) + sizeof(uint32_t) + sizeof(uint8_t) +
+                                              sizeof(uint64_t);
+        constexpr size_t max_args = 32;
+
+        /* argument type codes */
+        enum class arg_type : uint8_t {
+            int64 = 'i', uint64 = 'u', boolean = 'b', character = 'c', float64 = 'f', string = 's',
+            seconds = 'S', milliseconds = 'M', microseconds = 'U'
+        };
+
+        template <typename T, typename = void>
+        struct arg_traits;
+
+        template <typename T>
+        struct arg_traits<T, std::enable_if_t<std::is_integral<T>::value && std::is_signed<T>::value &&
+                                              !std::is_same<T, char>::value>> {
+            static constexpr arg_type type = arg_type::int64;
+            static constexpr size_t size = sizeof(int64_t);
+        };
+
+        template <typename T>
+        struct arg_traits<T, std::enable_if_t<std::is_integral<T>::value && std::is_unsigned<T>::value &&
+                                              !std::is_same<T, bool>::value>> {
+            static constexpr arg_type type = arg_type::uint64;
+            static constexpr size_t size = sizeof(uint64_t);
+        };
+
+        template <>
+        struct arg_traits<bool> {
+            static constexpr arg_type type = arg_type::boolean;
+            static constexpr size_t size = 1;
+        };
+
+        template <>
+        struct arg_traits<char> {
+            static constexpr arg_type type = arg_type::character;
+            static constexpr size_t size = 1;
+        };
+
+        template <typename T>
+        struct arg_traits<T, std::enable_if_t<std::is_floating_point<T>::value>> {
+            static constexpr arg_type type = arg_type::float64;
+            static constexpr size_t size = sizeof(double);
+        };
+
+        template <typename T>
+        struct arg_traits<T, std::enable_if_t<std::is_convertible<T, std::string_view>::value>> {
+            static constexpr arg_type type = arg_type::string;
+            static constexpr size_t size = sizeof(uint16_t);
+        };
+
+        template <>
+        struct arg_traits<std::chrono::seconds> {
+            static constexpr arg_type type = arg_type::seconds;
+            static constexpr size_t size = sizeof(int64_t);
+        };
+
+        template <>
+        struct arg_traits<std::chrono::milliseconds> {
+            static constexpr arg_type type = arg_type::milliseconds;
+            static constexpr size_t size = sizeof(int64_t);
+        };
+
+        template <>
+        struct arg_traits<std::chrono::microseconds> {
+            static constexpr arg_type type = arg_type::microseconds;
+            static constexpr size_t size = sizeof(int64_t);
+        };
+
+        template <typename T>
+        using traits = arg_traits<std::decay_t<T>>;
+
+        /* Record being encoded, strings share whatever is left after the fixed size arguments */
+        struct encoder {
+            char* data;
+            size_t size;
+            size_t string_room;
+
+            template <typename T>
+            void put(const T& value) {
+                std::memcpy(&data[size], &value, sizeof(value));
+                size += sizeof(value);
+            }
+
+            void put_string(std::string_view str) {
+                size_t len = str.size() < string_room ? str.size() : string_room;
+                if (len > UINT16_MAX) {
+                    len = UINT16_MAX;
+                }
+                string_room -= len;
+                put(static_cast<uint16_t>(len));
+                std::memcpy(&data[size], str.data(), len);
+                size += len;
+            }
+
+            template <typename T>
+            void encode(const T& value) {
+                using type = std::decay_t<T>;
+                constexpr arg_type code = traits<T>::type;
+
+                if constexpr (code == arg_type::int64) {
+                    put(static_cast<int64_t>(value));
+                } else if constexpr (code == arg_type::uint64) {
+                    put(static_cast<uint64_t>(value));
+                } else if constexpr (code == arg_type::boolean || code == arg_type::character) {
+                    put(static_cast<char>(value));
+                } else if constexpr (code == arg_type::float64) {
+                    put(static_cast<double>(value));
+                } else if constexpr (code == arg_type::string) {
+                    if constexpr (std::is_pointer<type>::value) {
+                        put_string(value != nullptr ? std::string_view(value) : std::string_view());
+                    } else {
+                        put_string(std::string_view(value));
+                    }
+                } else {
+                    put(static_cast<int64_t>(value.count()));
+                }
+            }
+        };
+    } // bin
+
+    /**
+     * @brief Static state of a binary call site, created by the SLOG_BIN makro.
+     *        The id is unique in the process, 0 until the site is first used.
+     */
+    struct bin_site {
+        std::atomic<uint32_t> id{0};
+    };
+
+    /**
+     * @brief Logger with deferred formatting. The hot path only stores the call site id, a raw
+     *        tick and the raw argument bytes, in a compact binary stream handed to the sinks.
+     *        The slog_decode tool (or binary_decoder) turns the stream back into text records.
+     *        Each logger describes a call site to its sinks the first time it uses it. Only the
+     *        first MAX_BIN_SITES sites are remembered, the later ones are described again before
+     *        each of their records.
+     */
+    class binary_logger {
+    public:
+        using level = slog::level;
+
+        /* default constructor */
+        explicit binary_logger(const char* logger_name);
+        /* default destructor */
+        virtual ~binary_logger();
+        /* disable copy constructor */
+        binary_logger(const binary_logger&) = delete;
+        /* disable copy assignment */
+        binary_logger& operator=(const binary_logger&) = delete;
+
+        /**
+         * @brief Get the logger name
+         * @return const char*, logger name
+         */
+        const char *get_name() const;
+
+        /**
+         * @brief Get the current log level
+         * @return level, log level
+         */
+        level get_Level() const;
+        /**
+         * @brief Set the current log level
+         * @param log_level, log level
+         */
+        void set_Level(level log_level);
+
+        /**
+         * @brief Check if a record with the given level would be logged
+         * @param log_level, level of the record
+         * @return true if the record would be logged, false otherwise
+         */
+        bool is_enabled(level log_level) const {
+            return log_level >= m_level.load(std::memory_order_relaxed) && log_level != level::disabled;
+        }
+
+        /**
+         * @brief Add a sink that receives the binary stream. The stream header and the
+         *        definitions of the call sites already used are written to it right away.
+         *        The sink is NOT owned by the logger and must outlive it.
+         * @param output, sink
+         * @return true if sink is added successfully, false otherwise
+         */
+        bool add_sink(sink& output);
+
+        /**
+         * @brief Set the raw time source. By default the system clock in nanoseconds is used.
+         *        Must be set before adding the sinks, the frequency is part of the stream header.
+         * @param source, tick source, ticks counted since the Unix epoch
+         * @param ticks_per_second, tick frequency
+         */
+        void set_tick_source(tick_source source, uint64_t ticks_per_second);
+
+        /**
+         * @brief Write a record, usually called through the SLOG_BIN makro
+         * @param site, static call site state
+         * @param log_level, level of the record
+         * @param fmt, format string with one {} per argument, must be a string literal
+         * @param args, arguments
+         */
+        template <typename... Args>
+        void write(bin_site& site, level log_level, const char* fmt, const Args&... args) {
+            static constexpr size_t fixed_size = bin::record_header_size + (size_t(0) + ... + bin::traits<Args>::size);
+            static_assert(fixed_size < MAX_LOG_RECORD_LEN, "too many arguments for MAX_LOG_RECORD_LEN");
+            static_assert(sizeof...(Args) <= bin::max_args, "too many arguments");
+
+            uint32_t id = site.id.load(std::memory_order_acquire);
+            if (!is_defined(id)) {
+                static constexpr uint8_t types[] = {static_cast<uint8_t>(bin::traits<Args>::type)..., 0};
+                id = define_site(site, fmt, types, sizeof...(Args));
+            }
+
+            char data[MAX_LOG_RECORD_LEN];
+            bin::encoder enc = {data, 0, MAX_LOG_RECORD_LEN - 1 - fixed_size};
+            enc.put(bin::record_tag);
+            enc.put(uint16_t(0));
+            enc.put(id);
+            enc.put(static_cast<uint8_t>(log_level));
+            enc.put(m_tick_source());
+            (enc.encode(args), ...);
+
+            const uint16_t length = static_cast<uint16_t>(enc.size - 1 - sizeof(uint16_t));
+            std::memcpy(&data[1], &length, sizeof(length));
+            emit(data, enc.size, log_level);
+        }
+
+    private:
+        /* private member functions */
+        bool is_defined(uint32_t id) const {
+            return id < MAX_BIN_SITES && ((m_defined[id / 64].load(std::memory_order_acquire) >> (id % 64)) & 1) != 0;
+        }
+        uint32_t define_site(bin_site& site, const char* fmt, const uint8_t* types, size_t nbr_args);
+        void emit(char* data, size_t size, level log_level);
+
+        /* member variables */
+        std::atomic<uint64_t> m_defined[(MAX_BIN_SITES + 63) / 64]; /* site ids described to the sinks */
+        std::atomic<level> m_level;
+        tick_source m_tick_source;
+        uint64_t m_ticks_per_second;
+        std::atomic<sink*> m_sinks[MAX_NBR_LOG_APPENDER];
+        std::mutex m_config_mutex;
+        char m_logger_name[MAX_LOG_NAME_LEN];
+    };
+
+    /**
+     * @brief Turns a binary stream back into the text records the logger would have produced,
+     *        used by the slog_decode tool. It is meant for offline use and does allocate.
+     */
+    class binary_decoder {
+    public:
+        binary_decoder();
+
+        /**
+         * @brief Print the date in the timestamps, like logger::set_print_date()
+         * @param print_date, true to print the date, false otherwise
+         */
+        void set_print_date(bool print_date);
+
+        /**
+         * @brief Decode a stream
+         * @param data, stream bytes
+         * @param size, number of bytes
+         * @param output, called once per decoded text record
+         * @return size_t, number of bytes decoded, less than size if the stream is truncated or invalid
+         */
+        size_t decode(const char* data, size_t size, const std::function<void(const record&)>& output);
+
+        /**
+         * @brief Number of records skipped because their call site was never described, e.g.
+         *        when the stream doesn't start at the beginning of the logging
+         * @return size_t, number of records skipped
+         */
+        size_t get_skipped() const;
+
+    private:
+        struct site_info {
+            uint32_t id;
+            uint8_t nbr_args;
+            uint8_t types[bin::max_args];
+            std::string format;
+        };
+
+        bool decode_record(const char* data, size_t size, const std::function<void(const record&)>& output);
+        const site_info* find_site(uint32_t id) const;
+
+        std::string m_name;
+        uint64_t m_ticks_per_second;
+        bool m_print_date;
+        bool m_header_read;
+        size_t m_skipped;
+        std::vector<site_info> m_sites;
+    };
+
+} // slog
+
+/* Binary logging makro, the format string uses {} as placeholder for each argument.
+ * The level is checked first, filtered calls don't evaluate the arguments */
+#define SLOG_BIN(logger, log_level, ...) \
+    do { \
+        if ((logger).is_enabled(log_level)) { \
+            static slog::bin_site slog_bin_site_; \
+            (logger).write(slog_bin_site_, log_level, __VA_ARGS__); \
+        } \
+    } while (0)
+
+#endif //SMALL_LOG_BINLOG_H
@@ -0,0 +1,100 @@
+//
+// Created by lcrgo on 17/10/2026.
+//
+
+#ifndef SMALL_LOG_DELEGATE_H
+#define SMALL_LOG_DELEGATE_H
+
+#include <cstddef>
+#include <cstring>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace slog {
+
+#ifndef MAX_DELEGATE_SIZE
+#define MAX_DELEGATE_SIZE (4 * sizeof(void*)) /* Max size of the callables stored by a delegate */
+#endif
+
+    template <typename Signature, size_t Capacity = MAX_DELEGATE_SIZE>
+    class delegate;
+
+    /**
+     * @brief Fixed capacity callable wrapper used instead of std::function, it never allocates.
+     *        The callable is copied into an inline buffer of Capacity bytes and must be trivially
+     *        copyable and destructible (function pointers, lambdas capturing references, pointers
+     *        or plain values); a larger or non trivial callable fails the build.
+     *        Function pointers and lambdas without captures are called directly through a
+     *        function pointer, the other callables through one extra indirection.
+     */
+    template <typename R, typename... Args, size_t Capacity>
+    class delegate<R(Args...), Capacity> {
+    public:
+        using function_type = R (*)(Args...);
+
+        /* empty delegate */
+        constexpr delegate() noexcept : m_function(nullptr), m_invoke(nullptr), m_storage() {}
+
+        constexpr delegate(std::nullptr_t) noexcept : delegate() {}
+
+        /**
+         * @brief Wrap a callable
+         * @param callable, function pointer, lambda or function object invocable with Args
+         */
+        template <typename F, typename T = std::decay_t<F>,
+                  std::enable_if_t<!std::is_same<T, delegate>::value &&
+                                   std::is_invocable_r<R, T&, Args...>::value, bool> = true>
+        delegate(F&& callable) noexcept : delegate() {
+            if constexpr (std::is_convertible<T, function_type>::value) {
+                /* A null function pointer gives an empty delegate */
+                m_function = static_cast<function_type>(callable);
+            } else {
+                static_assert(sizeof(T) <= Capacity, "callable too large for the delegate, raise MAX_DELEGATE_SIZE");
+                static_assert(alignof(T) <= alignof(std::max_align_t), "callable alignment not supported by the delegate");
+                static_assert(std::is_trivially_copyable<T>::value && std::is_trivially_destructible<T>::value,
+                              "the delegate only stores trivially copyable callables, capture by reference");
+
+                ::new (static_cast<void*>(m_storage)) T(std::forward<F>(callable));
+                m_invoke = &invoke<T>;
+            }
+        }
+
+        /**
+         * @brief Call the wrapped callable, the delegate must not be empty
+         * @param args, arguments
+         * @return R, what the callable returns
+         */
+        R operator()(Args... args) const {
+            if (m_function != nullptr) {
+                return m_function(std::forward<Args>(args)...);
+            }
+            return m_invoke(m_storage, std::forward<Args>(args)...);
+        }
+
+        /**
+         * @brief Check if the delegate wraps a callable
+         * @return true if it is not empty, false otherwise
+         */
+        explicit operator bool() const noexcept {
+            return m_function != nullptr || m_invoke != nullptr;
+        }
+
+        friend bool operator==(const delegate& callable, std::nullptr_t) noexcept { return !callable; }
+        friend bool operator!=(const delegate& callable, std::nullptr_t) noexcept { return static_cast<bool>(callable); }
+
+    private:
+        template <typename T>
+        static R invoke(void* storage, Args... args) {
+            return (*std::launder(static_cast<T*>(storage)))(std::forward<Args>(args)...);
+        }
+
+        /* member variables */
+        function_type m_function;
+        R (*m_invoke)(void*, Args...);
+        alignas(std::max_align_t) mutable unsigned char m_storage[Capacity];
+    };
+
+} // slog
+
+#endif //SMALL_LOG_DELEGATE_H
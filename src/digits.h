@@ -0,0 +1,49 @@
+//
+// Created by lcrgo on 17/10/2026.
+//
+
+#ifndef SMALL_LOG_DIGITS_H
+#define SMALL_LOG_DIGITS_H
+
+#include <cstdint>
+
+namespace slog {
+namespace digits {
+
+    /* "00" "01" ... "99", lets the formatters write two decimal digits per step */
+    extern const char pairs[200];
+
+    /**
+     * @brief Write exactly two decimal digits
+     * @param out, destination, 2 characters are written
+     * @param value, value to write, must be below 100
+     */
+    inline void write2(char* out, uint32_t value) {
+        out[0] = pairs[2 * value];
+        out[1] = pairs[2 * value + 1];
+    }
+
+    /**
+     * @brief Write exactly three decimal digits
+     * @param out, destination, 3 characters are written
+     * @param value, value to write, must be below 1000
+     */
+    inline void write3(char* out, uint32_t value) {
+        out[0] = static_cast<char>('0' + value / 100);
+        write2(&out[1], value % 100);
+    }
+
+    /**
+     * @brief Write exactly four decimal digits
+     * @param out, destination, 4 characters are written
+     * @param value, value to write, must be below 10000
+     */
+    inline void write4(char* out, uint32_t value) {
+        write2(&out[0], value / 100);
+        write2(&out[2], value % 100);
+    }
+
+} // digits
+} // slog
+
+#endif //SMALL_LOG_DIGITS_H
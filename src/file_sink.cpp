@@ -0,0 +1,183 @@
+//
+// Created by lcrgo on 17/10/2026.
+//
+
+#include "file_sink.h"
+
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace slog {
+
+    file_sink::file_sink(char* buffer, size_t buffer_size) :
+    m_buffer(buffer),
+    m_buffer_size(buffer != nullptr ? buffer_size : 0),
+    m_used(0),
+    m_fd(-1),
+    m_owns_fd(false),
+    m_sync(false),
+    m_flush_level(level::error),
+    m_flush_interval(0),
+    m_oldest_record(std::chrono::steady_clock::now()),
+    m_write_calls(0),
+    m_dropped_bytes(0) {}
+
+    file_sink::~file_sink() {
+        close();
+    }
+
+    bool file_sink::open(const char* path, bool truncate) {
+        const int flags = O_WRONLY | O_CREAT | O_CLOEXEC | (truncate ? O_TRUNC : O_APPEND);
+        const int fd = ::open(path, flags, 0644);
+        if (fd < 0) {
+            return false;
+        }
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        write_buffer();
+        close_fd();
+        m_fd = fd;
+        m_owns_fd = true;
+
+        return true;
+    }
+
+    void file_sink::attach(int fd) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        write_buffer();
+        close_fd();
+        m_fd = fd;
+        m_owns_fd = false;
+    }
+
+    void file_sink::close() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        write_buffer();
+        close_fd();
+    }
+
+    void file_sink::set_flush_level(level flush_level) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_flush_level = flush_level;
+    }
+
+    void file_sink::set_flush_interval(std::chrono::milliseconds interval) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_flush_interval = interval;
+    }
+
+    void file_sink::set_sync(bool sync) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_sync = sync;
+    }
+
+    void file_sink::write(const record& rec) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        append(rec);
+        if ((rec.lvl >= m_flush_level && rec.lvl != level::disabled) || interval_elapsed()) {
+            write_buffer();
+        }
+    }
+
+    void file_sink::write(span<const record> records) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        bool urgent = false;
+
+        /* The whole batch is coalesced, an urgent record flushes it once at the end */
+        for (const record& rec : records) {
+            append(rec);
+            urgent = urgent || (rec.lvl >= m_flush_level && rec.lvl != level::disabled);
+        }
+        if (urgent || interval_elapsed()) {
+            write_buffer();
+        }
+    }
+
+    void file_sink::flush() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        write_buffer();
+    }
+
+    void file_sink::poll() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (interval_elapsed()) {
+            write_buffer();
+        }
+    }
+
+    size_t file_sink::get_write_calls() const {
+        return m_write_calls.load(std::memory_order_relaxed);
+    }
+
+    size_t file_sink::get_dropped_bytes() const {
+        return m_dropped_bytes.load(std::memory_order_relaxed);
+    }
+
+    void file_sink::append(const record& rec) {
+        if (m_used + rec.size > m_buffer_size) {
+            write_buffer();
+        }
+
+        if (rec.size > m_buffer_size) {
+            /* Too large for the buffer, which is empty by now, no point in copying it */
+            write_fd(rec.data, rec.size);
+        } else {
+            if (m_used == 0 && m_flush_interval.count() != 0) {
+                m_oldest_record = std::chrono::steady_clock::now();
+            }
+            std::memcpy(&m_buffer[m_used], rec.data, rec.size);
+            m_used += rec.size;
+        }
+    }
+
+    void file_sink::write_buffer() {
+        if (m_used != 0) {
+            write_fd(m_buffer, m_used);
+            m_used = 0;
+        }
+    }
+
+    void file_sink::write_fd(const char* data, size_t size) {
+        if (m_fd < 0) {
+            m_dropped_bytes.fetch_add(size, std::memory_order_relaxed);
+            return;
+        }
+
+        /* Partial writes are resumed, errors drop what is left. Nothing written would loop
+         * forever, it is an error too */
+        while (size > 0) {
+            m_write_calls.fetch_add(1, std::memory_order_relaxed);
+            const ssize_t written = ::write(m_fd, data, size);
+            if (written <= 0) {
+                if (written < 0 && errno == EINTR) {
+                    continue;
+                }
+                m_dropped_bytes.fetch_add(size, std::memory_order_relaxed);
+                return;
+            }
+            data += written;
+            size -= static_cast<size_t>(written);
+        }
+
+        if (m_sync) {
+            ::fdatasync(m_fd);
+        }
+    }
+
+    bool file_sink::interval_elapsed() const {
+        return m_flush_interval.count() != 0 && m_used != 0 &&
+               std::chrono::steady_clock::now() - m_oldest_record >= m_flush_interval;
+    }
+
+    void file_sink::close_fd() {
+        if (m_fd >= 0 && m_owns_fd) {
+            ::close(m_fd);
+        }
+        m_fd = -1;
+        m_owns_fd = false;
+    }
+
+} // slog
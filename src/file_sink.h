@@ -0,0 +1,126 @@
+//
+// Created by lcrgo on 17/10/2026.
+//
+
+#ifndef SMALL_LOG_FILE_SINK_H
+#define SMALL_LOG_FILE_SINK_H
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <mutex>
+
+#include "sink.h"
+
+namespace slog {
+
+    /**
+     * @brief Sink writing the records to a file descriptor (POSIX). The records are gathered in a
+     *        user provided buffer and written with a single write(2) call when:
+     *         - the next record does not fit in the buffer
+     *         - a record at or above the flush level arrives (error by default)
+     *         - the oldest buffered record waited longer than the flush interval, checked when a
+     *           record arrives and when the sink is polled (about every 10 ms by the asynchronous
+     *           worker, by logger::poll() in synchronous mode)
+     *         - flush() is called, by logger::flush() or when the sink is destroyed
+     *        Records larger than the buffer are written directly. Optionally each write is
+     *        followed by fdatasync(2) so the records survive a power loss.
+     *        The sink is thread safe and never allocates.
+     */
+    class file_sink : public sink {
+    public:
+        /**
+         * @brief Create a sink, not attached to any file yet
+         * @param buffer, record buffer, NOT owned by the sink and must outlive it
+         * @param buffer_size, buffer size, the larger the fewer system calls
+         */
+        file_sink(char* buffer, size_t buffer_size);
+        /* flushes the buffer and closes the file when it was opened by the sink */
+        ~file_sink() override;
+
+        /**
+         * @brief Open a file and write the next records to it, the current file is flushed and
+         *        closed first
+         * @param path, file path, created when missing
+         * @param truncate, true to discard the current content, false to append
+         * @return true if the file was opened, false otherwise
+         */
+        bool open(const char* path, bool truncate = false);
+
+        /**
+         * @brief Write the next records to an already open file descriptor (like 1 for stdout).
+         *        The descriptor is NOT closed by the sink.
+         * @param fd, file descriptor
+         */
+        void attach(int fd);
+
+        /**
+         * @brief Flush the buffer and close (or detach) the file, the next records are dropped
+         */
+        void close();
+
+        /**
+         * @brief Set the lowest level flushed right away, by default error and fatal records
+         * @param flush_level, level, level::disabled to never flush on a record
+         */
+        void set_flush_level(level flush_level);
+
+        /**
+         * @brief Set the longest time a record may wait in the buffer. The sink has no thread of
+         *        its own, the interval is checked when a record arrives and by poll(), which the
+         *        asynchronous worker calls about every 10 ms. In synchronous mode a quiet logger
+         *        only flushes when the application calls logger::poll(). Disabled (0) by default.
+         * @param interval, flush interval, 0 to disable
+         */
+        void set_flush_interval(std::chrono::milliseconds interval);
+
+        /**
+         * @brief Call fdatasync(2) after every write
+         * @param sync, true to synchronize the data with the disk, false otherwise (default)
+         */
+        void set_sync(bool sync);
+
+        using sink::write;
+        void write(const record& rec) override;
+        void write(span<const record> records) override;
+        void flush() override;
+        void poll() override;
+
+        /**
+         * @brief Number of write(2) calls done so far
+         * @return size_t, number of system calls
+         */
+        size_t get_write_calls() const;
+
+        /**
+         * @brief Number of bytes lost because the file could not be written
+         * @return size_t, number of bytes dropped
+         */
+        size_t get_dropped_bytes() const;
+
+    private:
+        /* private member functions, called with the mutex held */
+        void append(const record& rec);
+        void write_buffer();
+        void write_fd(const char* data, size_t size);
+        bool interval_elapsed() const;
+        void close_fd();
+
+        /* member variables */
+        char* m_buffer;
+        size_t m_buffer_size;
+        size_t m_used;
+        int m_fd;
+        bool m_owns_fd;
+        bool m_sync;
+        level m_flush_level;
+        std::chrono::milliseconds m_flush_interval;
+        std::chrono::steady_clock::time_point m_oldest_record; /* arrival of the first buffered record */
+        std::atomic<size_t> m_write_calls;
+        std::atomic<size_t> m_dropped_bytes;
+        std::mutex m_mutex;
+    };
+
+} // slog
+
+#endif //SMALL_LOG_FILE_SINK_H
@@ -0,0 +1,203 @@
+//
+// Created by lcrgo on 17/10/2026.
+//
+
+#include "flight_recorder.h"
+
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include <unistd.h>
+
+namespace slog {
+
+    /* Slot sequence while a record is copied into it */
+    static constexpr size_t busy = SIZE_MAX;
+
+    /* Recorder dumped by the crash handler */
+    static std::atomic<flight_recorder*> crash_recorder(nullptr);
+
+    static constexpr int crash_signals[] = {SIGSEGV, SIGABRT, SIGBUS, SIGILL, SIGFPE};
+    static constexpr size_t nbr_crash_signals = sizeof(crash_signals) / sizeof(crash_signals[0]);
+
+    /* Handlers replaced by the crash handler, called after the dump */
+    static struct sigaction previous_actions[nbr_crash_signals];
+
+    /* Copy the bytes of a record into the words of a slot */
+    static void store_words(std::atomic<size_t>* words, const char* data, size_t size) {
+        for (size_t i = 0; i < size; i += sizeof(size_t)) {
+            const size_t len = size - i < sizeof(size_t) ? size - i : sizeof(size_t);
+            size_t word = 0;
+            std::memcpy(&word, &data[i], len);
+            words[i / sizeof(size_t)].store(word, std::memory_order_relaxed);
+        }
+    }
+
+    /* Copy the words of a slot back into bytes */
+    static void load_words(const std::atomic<size_t>* words, char* data, size_t size) {
+        for (size_t i = 0; i < size; i += sizeof(size_t)) {
+            const size_t len = size - i < sizeof(size_t) ? size - i : sizeof(size_t);
+            const size_t word = words[i / sizeof(size_t)].load(std::memory_order_relaxed);
+            std::memcpy(&data[i], &word, len);
+        }
+    }
+
+    flight_recorder::flight_recorder(flight_slot* slots, size_t nbr_slots) :
+    m_slots(nullptr),
+    m_mask(0),
+    m_head(0),
+    m_dump_fd(STDERR_FILENO),
+    m_dump_level(level::fatal) {
+
+        /* The number of slots must be a power of two so the position can be masked */
+        if (slots != nullptr && nbr_slots != 0 && (nbr_slots & (nbr_slots - 1)) == 0) {
+            for (size_t i = 0; i < nbr_slots; ++i) {
+                slots[i].sequence.store(0, std::memory_order_relaxed);
+                slots[i].size.store(0, std::memory_order_relaxed);
+            }
+            m_slots = slots;
+            m_mask = nbr_slots - 1;
+        }
+    }
+
+    flight_recorder::~flight_recorder() {
+        flight_recorder* self = this;
+        crash_recorder.compare_exchange_strong(self, nullptr);
+    }
+
+    void flight_recorder::set_dump_fd(int fd) {
+        m_dump_fd.store(fd, std::memory_order_relaxed);
+    }
+
+    void flight_recorder::set_dump_level(level dump_level) {
+        m_dump_level.store(dump_level, std::memory_order_relaxed);
+    }
+
+    void flight_recorder::write(const record& rec) {
+        if (m_slots != nullptr) {
+            const size_t pos = m_head.fetch_add(1, std::memory_order_relaxed);
+            flight_slot& slot = m_slots[pos & m_mask];
+
+            /* A writer one lap ahead still owns the slot, this record is the one dropped */
+            if (slot.sequence.exchange(busy, std::memory_order_acquire) != busy) {
+                const size_t size = rec.size < MAX_LOG_RECORD_LEN ? rec.size : MAX_LOG_RECORD_LEN;
+                store_words(slot.data, rec.data, size);
+                slot.size.store(size, std::memory_order_relaxed);
+                slot.sequence.store(pos + 1, std::memory_order_release);
+            }
+        }
+
+        const level dump_level = m_dump_level.load(std::memory_order_relaxed);
+        if (rec.lvl >= dump_level && dump_level != level::disabled) {
+            dump(m_dump_fd.load(std::memory_order_relaxed));
+        }
+    }
+
+    /* write(2) the whole buffer, the only output call used by the dump */
+    static void write_all(int fd, const char* data, size_t size) {
+        while (size > 0) {
+            const ssize_t written = ::write(fd, data, size);
+            if (written < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                return;
+            }
+            data += written;
+            size -= static_cast<size_t>(written);
+        }
+    }
+
+    void flight_recorder::dump(int fd) const {
+        static constexpr char header[] = "\n--- flight recorder dump begin ---";
+        static constexpr char trailer[] = "\n--- flight recorder dump end ---\n";
+
+        write_all(fd, header, sizeof(header) - 1);
+
+        if (m_slots != nullptr) {
+            const size_t head = m_head.load(std::memory_order_acquire);
+            const size_t nbr_slots = m_mask + 1;
+            char data[MAX_LOG_RECORD_LEN];
+
+            for (size_t pos = head > nbr_slots ? head - nbr_slots : 0; pos < head; ++pos) {
+                const flight_slot& slot = m_slots[pos & m_mask];
+
+                /* Copy the record and keep it only if it was not rewritten meanwhile */
+                if (slot.sequence.load(std::memory_order_acquire) != pos + 1) {
+                    continue;
+                }
+                size_t size = slot.size.load(std::memory_order_relaxed);
+                size = size < MAX_LOG_RECORD_LEN ? size : MAX_LOG_RECORD_LEN;
+                load_words(slot.data, data, size);
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (slot.sequence.load(std::memory_order_relaxed) != pos + 1) {
+                    continue;
+                }
+
+                write_all(fd, data, size);
+            }
+        }
+
+        write_all(fd, trailer, sizeof(trailer) - 1);
+    }
+
+    bool flight_recorder::install_crash_handler() {
+        crash_recorder.store(this, std::memory_order_release);
+
+        struct sigaction action;
+        std::memset(&action, 0, sizeof(action));
+        action.sa_sigaction = crash_handler;
+        sigemptyset(&action.sa_mask);
+        /* The handler runs once, then the previous handler is back */
+        action.sa_flags = SA_SIGINFO | SA_RESETHAND | SA_NODEFER;
+
+        for (size_t i = 0; i < nbr_crash_signals; ++i) {
+            struct sigaction previous;
+            if (sigaction(crash_signals[i], &action, &previous) != 0) {
+                return false;
+            }
+            /* Installed again, the handler found is this one and the saved one is kept */
+            if (!(previous.sa_flags & SA_SIGINFO) || previous.sa_sigaction != crash_handler) {
+                previous_actions[i] = previous;
+            }
+        }
+        return true;
+    }
+
+    size_t flight_recorder::get_recorded() const {
+        return m_head.load(std::memory_order_relaxed);
+    }
+
+    void flight_recorder::crash_handler(int signal, siginfo_t* info, void* context) {
+        const int saved_errno = errno;
+        const flight_recorder* recorder = crash_recorder.exchange(nullptr, std::memory_order_acquire);
+
+        if (recorder != nullptr) {
+            recorder->dump(recorder->m_dump_fd.load(std::memory_order_relaxed));
+        }
+
+        size_t index = 0;
+        while (index < nbr_crash_signals && crash_signals[index] != signal) {
+            index += 1;
+        }
+        if (index == nbr_crash_signals) {
+            return;
+        }
+
+        /* Hand the signal over to the previous handler, it also gets the next ones */
+        const struct sigaction& previous = previous_actions[index];
+        sigaction(signal, &previous, nullptr);
+        errno = saved_errno;
+
+        if (previous.sa_flags & SA_SIGINFO) {
+            if (previous.sa_sigaction != nullptr) {
+                previous.sa_sigaction(signal, info, context);
+            }
+        } else if (previous.sa_handler == SIG_DFL) {
+            raise(signal);
+        } else if (previous.sa_handler != SIG_IGN) {
+            previous.sa_handler(signal);
+        }
+    }
+
+} // slog
@@ -0,0 +1,97 @@
+//
+// Created by lcrgo on 17/10/2026.
+//
+
+#ifndef SMALL_LOG_FLIGHT_RECORDER_H
+#define SMALL_LOG_FLIGHT_RECORDER_H
+
+#include <atomic>
+#include <csignal>
+#include <cstddef>
+
+#include "sink.h"
+
+namespace slog {
+
+    /**
+     * @brief Storage for one record of the flight recorder, provided by the user (usually a
+     *        static array) so the recorder never allocates.
+     */
+    struct flight_slot {
+        std::atomic<size_t> sequence; /* position + 1 of the record held, busy while written */
+        std::atomic<size_t> size;
+        /* record bytes, copied by words with relaxed atomics since a dump may read them while
+         * they are written */
+        std::atomic<size_t> data[(MAX_LOG_RECORD_LEN + sizeof(size_t) - 1) / sizeof(size_t)];
+    };
+
+    /**
+     * @brief In memory ring keeping the last records, dumped to a file descriptor when a fatal
+     *        record arrives or when the process crashes. Recording a record is a copy into the
+     *        ring, without lock nor system call.
+     *        Add it with logger::add_sink(recorder, capture_level) to keep records below the
+     *        logger level, for example the debug records, without writing them anywhere else.
+     */
+    class flight_recorder : public sink {
+    public:
+        /**
+         * @brief Create a recorder
+         * @param slots, ring storage, NOT owned by the recorder and must outlive it
+         * @param nbr_slots, number of records kept, must be a power of two
+         */
+        flight_recorder(flight_slot* slots, size_t nbr_slots);
+        /* uninstalls the crash handler when it dumps this recorder */
+        ~flight_recorder() override;
+
+        /**
+         * @brief Set where the records are dumped, by default stderr (2)
+         * @param fd, file descriptor, NOT closed by the recorder
+         */
+        void set_dump_fd(int fd);
+
+        /**
+         * @brief Set the lowest level that triggers a dump, by default fatal
+         * @param dump_level, level, level::disabled to never dump on a record
+         */
+        void set_dump_level(level dump_level);
+
+        using sink::write;
+        void write(const record& rec) override;
+
+        /**
+         * @brief Write the recorded records, oldest first, framed by a header and a trailer line.
+         *        Only async-signal-safe calls are used so it can run in a signal handler.
+         *        Records overwritten while dumping are skipped.
+         * @param fd, file descriptor
+         */
+        void dump(int fd) const;
+
+        /**
+         * @brief Dump this recorder, to its dump file descriptor, when the process receives
+         *        SIGSEGV, SIGABRT, SIGBUS, SIGILL or SIGFPE. The handlers installed before are
+         *        kept and called after the dump, or the default action of the signal runs (core
+         *        dump, exit status). Only one recorder can be installed.
+         * @return true if the handlers were installed, false otherwise
+         */
+        bool install_crash_handler();
+
+        /**
+         * @brief Number of records recorded so far, including the overwritten ones
+         * @return size_t, number of records
+         */
+        size_t get_recorded() const;
+
+    private:
+        static void crash_handler(int signal, siginfo_t* info, void* context);
+
+        /* member variables */
+        flight_slot* m_slots;
+        size_t m_mask;
+        std::atomic<size_t> m_head;
+        std::atomic<int> m_dump_fd;
+        std::atomic<level> m_dump_level;
+    };
+
+} // slog
+
+#endif //SMALL_LOG_FLIGHT_RECORDER_H
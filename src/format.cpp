@@ -0,0 +1,356 @@
+//
+// Created by lcrgo on 17/10/2026.
+//
+
+#include "format.h"
+#include "digits.h"
+
+#include <charconv>
+#include <cmath>
+#include <cstring>
+
+/* The escaped strings are scanned with the widest vector extension enabled for the build,
+ * define SLOG_NO_SIMD to keep the byte by byte scan */
+#if !defined(SLOG_NO_SIMD) && defined(__AVX2__)
+#define SLOG_SCAN_AVX2
+#endif
+#if !defined(SLOG_NO_SIMD) && defined(__SSE2__)
+#define SLOG_SCAN_SSE2
+#endif
+#if defined(SLOG_SCAN_AVX2) || defined(SLOG_SCAN_SSE2)
+#include <immintrin.h>
+#endif
+
+namespace slog {
+namespace fmt {
+
+    /* Number of decimal digits, four digits per step */
+    static size_t count_decimal(uint64_t value) {
+        size_t count = 1;
+
+        for (;;) {
+            if (value < 10) return count;
+            if (value < 100) return count + 1;
+            if (value < 1000) return count + 2;
+            if (value < 10000) return count + 3;
+            value /= 10000;
+            count += 4;
+        }
+    }
+
+    /* Number of digits in a power of two base */
+    static size_t count_pow2(uint64_t value, unsigned int shift) {
+        size_t count = 0;
+
+        do {
+            count += 1;
+            value >>= shift;
+        } while (value != 0);
+
+        return count;
+    }
+
+    /* Write the decimal digits ending at end, two digits per step */
+    static void write_decimal(char* end, uint64_t value) {
+        while (value >= 100) {
+            end -= 2;
+            digits::write2(end, static_cast<uint32_t>(value % 100));
+            value /= 100;
+        }
+
+        if (value >= 10) {
+            digits::write2(end - 2, static_cast<uint32_t>(value));
+        } else {
+            *(end - 1) = static_cast<char>('0' + value);
+        }
+    }
+
+    /* Write the digits of a power of two base ending at end, one shift per digit */
+    static void write_pow2(char* end, uint64_t value, unsigned int shift, bool uppercase) {
+        const char* const table = uppercase ? "0123456789ABCDEF" : "0123456789abcdef";
+        const uint64_t mask = (1u << shift) - 1;
+
+        do {
+            *--end = table[value & mask];
+            value >>= shift;
+        } while (value != 0);
+    }
+
+    size_t write_integer(char* out, uint64_t magnitude, bool negative, const int_spec& spec) {
+        unsigned int shift = 0;
+        char prefix = '\0';
+
+        switch (spec.base) {
+            case 2:
+                shift = 1;
+                prefix = 'b';
+                break;
+            case 8:
+                shift = 3;
+                prefix = 'o';
+                break;
+            case 16:
+                shift = 4;
+                prefix = 'x';
+                break;
+            default:
+                break;
+        }
+
+        /* The final length is known up front so every character is written in place */
+        const size_t nbr_digits = shift != 0 ? count_pow2(magnitude, shift) : count_decimal(magnitude);
+        const size_t body = (negative ? 1 : 0) + (prefix != '\0' ? 2 : 0) + nbr_digits;
+        const size_t width = spec.width < max_integer_len ? spec.width : max_integer_len;
+        const size_t padding = width > body ? width - body : 0;
+        size_t pos = 0;
+
+        if (padding != 0 && spec.fill != '0') {
+            std::memset(out, spec.fill, padding);
+            pos += padding;
+        }
+        if (negative) {
+            out[pos++] = '-';
+        }
+        if (prefix != '\0') {
+            out[pos++] = '0';
+            out[pos++] = prefix;
+        }
+        if (padding != 0 && spec.fill == '0') {
+            std::memset(&out[pos], '0', padding);
+            pos += padding;
+        }
+
+        pos += nbr_digits;
+        if (shift != 0) {
+            write_pow2(&out[pos], magnitude, shift, spec.uppercase);
+        } else {
+            write_decimal(&out[pos], magnitude);
+        }
+
+        return pos;
+    }
+
+    template <typename T>
+    static size_t write_floating(char* out, T value, const float_spec& spec) {
+        char* const end = out + max_float_len;
+        const int precision = spec.precision < max_float_precision ? spec.precision : max_float_precision;
+        std::to_chars_result result;
+
+        switch (spec.format) {
+            case float_format::fixed:
+                result = std::to_chars(out, end, value, std::chars_format::fixed, precision);
+                if (result.ec == std::errc()) {
+                    break;
+                }
+                /* too large for the fixed format */
+                /* intentional fall through */
+            case float_format::scientific:
+                result = std::to_chars(out, end, value, std::chars_format::scientific, precision);
+                break;
+            default:
+                result = std::to_chars(out, end, value);
+                break;
+        }
+
+        /* Pad in place, the digits are moved right by the padding */
+        const size_t len = static_cast<size_t>(result.ptr - out);
+        const size_t width = spec.width < max_float_len ? spec.width : max_float_len;
+        if (width <= len) {
+            return len;
+        }
+
+        const size_t padding = width - len;
+        if (spec.fill == '0' && std::isfinite(value)) {
+            const size_t sign = out[0] == '-' ? 1 : 0;
+            std::memmove(&out[sign + padding], &out[sign], len - sign);
+            std::memset(&out[sign], '0', padding);
+        } else {
+            /* zeros in front of nan or inf would read as a number */
+            std::memmove(&out[padding], out, len);
+            std::memset(out, spec.fill == '0' ? ' ' : spec.fill, padding);
+        }
+
+        return width;
+    }
+
+    size_t write_float(char* out, double value, const float_spec& spec) {
+        return write_floating(out, value, spec);
+    }
+
+    size_t write_float(char* out, float value, const float_spec& spec) {
+        return write_floating(out, value, spec);
+    }
+
+    static constexpr char hex_digits_lower[] = "0123456789abcdef";
+
+    /* Bytes escaped in JSON strings, the others are copied as they are */
+    struct json_escape {
+        static bool escaped(unsigned char c) {
+            return c < 0x20 || c == '"' || c == '\\';
+        }
+
+        /* Short escapes when JSON has one, \u00XX for the other control characters */
+        static size_t write(char* out, size_t room, unsigned char c) {
+            char escape;
+            switch (c) {
+                case '"': escape = '"'; break;
+                case '\\': escape = '\\'; break;
+                case '\n': escape = 'n'; break;
+                case '\r': escape = 'r'; break;
+                case '\t': escape = 't'; break;
+                case '\b': escape = 'b'; break;
+                case '\f': escape = 'f'; break;
+                default: escape = '\0'; break;
+            }
+
+            if (escape != '\0') {
+                if (room < 2) {
+                    return 0;
+                }
+                out[0] = '\\';
+                out[1] = escape;
+                return 2;
+            }
+            if (room < 6) {
+                return 0;
+            }
+            std::memcpy(out, "\\u00", 4);
+            out[4] = hex_digits_lower[c >> 4];
+            out[5] = hex_digits_lower[c & 0xf];
+            return 6;
+        }
+    };
+
+    /* Control characters escaped in the text records, so a string can't start a new line */
+    struct control_escape {
+        static bool escaped(unsigned char c) {
+            return c < 0x20 || c == 0x7f;
+        }
+
+        /* \n, \r and \t, \xHH for the other control characters */
+        static size_t write(char* out, size_t room, unsigned char c) {
+            if (c == '\n' || c == '\r' || c == '\t') {
+                if (room < 2) {
+                    return 0;
+                }
+                out[0] = '\\';
+                out[1] = c == '\n' ? 'n' : c == '\r' ? 'r' : 't';
+                return 2;
+            }
+            if (room < 4) {
+                return 0;
+            }
+            out[0] = '\\';
+            out[1] = 'x';
+            out[2] = hex_digits_lower[c >> 4];
+            out[3] = hex_digits_lower[c & 0xf];
+            return 4;
+        }
+    };
+
+#if defined(SLOG_SCAN_AVX2)
+    /* 0xff in the bytes escaped by the JSON strings */
+    static inline __m256i dirty_bytes(__m256i bytes, json_escape) {
+        const __m256i control = _mm256_cmpeq_epi8(_mm256_min_epu8(bytes, _mm256_set1_epi8(0x1f)), bytes);
+        const __m256i quote = _mm256_cmpeq_epi8(bytes, _mm256_set1_epi8('"'));
+        const __m256i backslash = _mm256_cmpeq_epi8(bytes, _mm256_set1_epi8('\\'));
+        return _mm256_or_si256(control, _mm256_or_si256(quote, backslash));
+    }
+
+    /* 0xff in the control characters */
+    static inline __m256i dirty_bytes(__m256i bytes, control_escape) {
+        const __m256i control = _mm256_cmpeq_epi8(_mm256_min_epu8(bytes, _mm256_set1_epi8(0x1f)), bytes);
+        const __m256i del = _mm256_cmpeq_epi8(bytes, _mm256_set1_epi8(0x7f));
+        return _mm256_or_si256(control, del);
+    }
+#endif
+
+#if defined(SLOG_SCAN_SSE2)
+    /* 0xff in the bytes escaped by the JSON strings */
+    static inline __m128i dirty_bytes(__m128i bytes, json_escape) {
+        /* unsigned bytes <= 0x1f are the ones left unchanged by min(byte, 0x1f) */
+        const __m128i control = _mm_cmpeq_epi8(_mm_min_epu8(bytes, _mm_set1_epi8(0x1f)), bytes);
+        const __m128i quote = _mm_cmpeq_epi8(bytes, _mm_set1_epi8('"'));
+        const __m128i backslash = _mm_cmpeq_epi8(bytes, _mm_set1_epi8('\\'));
+        return _mm_or_si128(control, _mm_or_si128(quote, backslash));
+    }
+
+    /* 0xff in the control characters */
+    static inline __m128i dirty_bytes(__m128i bytes, control_escape) {
+        const __m128i control = _mm_cmpeq_epi8(_mm_min_epu8(bytes, _mm_set1_epi8(0x1f)), bytes);
+        const __m128i del = _mm_cmpeq_epi8(bytes, _mm_set1_epi8(0x7f));
+        return _mm_or_si128(control, del);
+    }
+#endif
+
+    /* Number of leading bytes copied as they are, 32 or 16 bytes per step when SIMD is available */
+    template <typename Escape>
+    static size_t clean_prefix(const char* data, size_t size) {
+        size_t i = 0;
+
+#if defined(SLOG_SCAN_AVX2)
+        for (; i + 32 <= size; i += 32) {
+            const __m256i bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&data[i]));
+            const uint32_t mask = static_cast<uint32_t>(_mm256_movemask_epi8(dirty_bytes(bytes, Escape())));
+            if (mask != 0) {
+                return i + static_cast<size_t>(__builtin_ctz(mask));
+            }
+        }
+#endif
+#if defined(SLOG_SCAN_SSE2)
+        for (; i + 16 <= size; i += 16) {
+            const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&data[i]));
+            const uint32_t mask = static_cast<uint32_t>(_mm_movemask_epi8(dirty_bytes(bytes, Escape())));
+            if (mask != 0) {
+                return i + static_cast<size_t>(__builtin_ctz(mask));
+            }
+        }
+#endif
+        for (; i < size; ++i) {
+            if (Escape::escaped(static_cast<unsigned char>(data[i]))) {
+                break;
+            }
+        }
+
+        return i;
+    }
+
+    /* Copy the clean runs in one piece and escape the bytes found between them */
+    template <typename Escape>
+    static size_t write_escaped(char* out, size_t room, const char* data, size_t size) {
+        size_t len = 0;
+
+        while (size > 0 && len < room) {
+            /* Never scan past what fits */
+            const size_t clean = clean_prefix<Escape>(data, size < room - len ? size : room - len);
+            std::memcpy(&out[len], data, clean);
+            len += clean;
+            data += clean;
+            size -= clean;
+
+            if (size == 0 || len == room) {
+                break;
+            }
+
+            const size_t escape_len = Escape::write(&out[len], room - len, static_cast<unsigned char>(*data));
+            if (escape_len == 0) {
+                break;
+            }
+            len += escape_len;
+            data += 1;
+            size -= 1;
+        }
+
+        return len;
+    }
+
+    size_t write_json_escaped(char* out, size_t room, const char* data, size_t size) {
+        return write_escaped<json_escape>(out, room, data, size);
+    }
+
+    size_t write_sanitized(char* out, size_t room, const char* data, size_t size) {
+        return write_escaped<control_escape>(out, room, data, size);
+    }
+
+} // fmt
+} // slog
@@ -0,0 +1,335 @@
+//
+// Created by lcrgo on 17/10/2026.
+//
+
+#ifndef SMALL_LOG_FORMAT_H
+#define SMALL_LOG_FORMAT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <type_traits>
+
+namespace slog {
+namespace fmt {
+
+    /* longest integer rendering: sign, radix prefix and 64 binary digits, or the max width */
+    constexpr size_t max_integer_len = 72;
+
+    /* longest floating point rendering, or the max width */
+    constexpr size_t max_float_len = 72;
+
+    /* highest precision of the fixed and scientific formats */
+    constexpr uint8_t max_float_precision = 32;
+
+    /* floating point formats */
+    enum class float_format : uint8_t {
+        shortest,   /* fewest digits that read back to the same value, the precision is not used */
+        fixed,      /* precision digits after the decimal point */
+        scientific  /* one digit, the decimal point, precision digits and the exponent */
+    };
+
+    /**
+     * @brief How an integer is rendered
+     *  base      : 2, 8, 10 or 16, other bases print as decimal
+     *  width     : minimum field width, up to max_integer_len
+     *  fill      : padding character; '0' pads between the sign/prefix and the digits, any other
+     *              character pads on the left
+     *  uppercase : letters case of the hexadecimal digits
+     */
+    struct int_spec {
+        uint8_t base;
+        uint8_t width;
+        char fill;
+        bool uppercase;
+    };
+
+    /**
+     * @brief Render an integer given as sign and magnitude
+     * @param out, destination, at least max_integer_len characters, not null terminated
+     * @param magnitude, absolute value
+     * @param negative, true to print the minus sign
+     * @param spec, rendering options
+     * @return size_t, number of characters written
+     */
+    size_t write_integer(char* out, uint64_t magnitude, bool negative, const int_spec& spec);
+
+    /**
+     * @brief Render any integral value, the whole int64_t and uint64_t ranges are supported
+     * @param out, destination, at least max_integer_len characters, not null terminated
+     * @param value, value to render
+     * @param spec, rendering options
+     * @return size_t, number of characters written
+     */
+    template <typename T, std::enable_if_t<std::is_integral<T>::value, bool> = true>
+    size_t write_integer(char* out, T value, const int_spec& spec) {
+        if constexpr (std::is_signed<T>::value) {
+            /* 0 - value in unsigned arithmetic is also right for the minimum value */
+            const bool negative = value < 0;
+            const uint64_t magnitude = negative ? 0 - static_cast<uint64_t>(value) : static_cast<uint64_t>(value);
+            return write_integer(out, magnitude, negative, spec);
+        } else {
+            return write_integer(out, static_cast<uint64_t>(value), false, spec);
+        }
+    }
+
+    /**
+     * @brief How a floating point value is rendered
+     *  format    : shortest, fixed or scientific
+     *  precision : digits after the decimal point, up to max_float_precision
+     *  width     : minimum field width, up to max_float_len
+     *  fill      : padding character; '0' pads between the sign and the digits, any other
+     *              character pads on the left
+     */
+    struct float_spec {
+        float_format format;
+        uint8_t precision;
+        uint8_t width;
+        char fill;
+    };
+
+    /**
+     * @brief Render a floating point value, nan and infinities print as "nan", "inf" and "-inf".
+     *        Fixed values too long for the field are printed in scientific format.
+     * @param out, destination, at least max_float_len characters, not null terminated
+     * @param value, value to render
+     * @param spec, rendering options
+     * @return size_t, number of characters written
+     */
+    size_t write_float(char* out, double value, const float_spec& spec);
+    /* float overload, the shortest format uses the digits of the float value */
+    size_t write_float(char* out, float value, const float_spec& spec);
+
+    /**
+     * @brief Copy text escaped as the content of a JSON string: the quote, the backslash and the
+     *        control characters are escaped, the other bytes (UTF-8 included) are copied as they are.
+     *        Clean text is scanned 16 (SSE2) or 32 (AVX2) bytes at a time and copied in one piece
+     * @param out, destination, not null terminated
+     * @param room, number of characters available at out
+     * @param data, text
+     * @param size, text length
+     * @return size_t, number of characters written, the text is cut before an escape sequence
+     *         that does not fit
+     */
+    size_t write_json_escaped(char* out, size_t room, const char* data, size_t size);
+
+    /**
+     * @brief Copy text with its control characters escaped, so it can't break a line or inject
+     *        terminal sequences: \n, \r and \t, \xHH for the other ones and DEL. The other
+     *        bytes are copied as they are.
+     * @param out, destination, not null terminated
+     * @param room, number of characters available at out
+     * @param data, text
+     * @param size, text length
+     * @return size_t, number of characters written, the text is cut before an escape sequence
+     *         that does not fit
+     */
+    size_t write_sanitized(char* out, size_t room, const char* data, size_t size);
+
+    /**
+     * @brief One piece of a parsed format string, either literal text or a placeholder.
+     *        Placeholders are written {} or {:spec}, spec being [0][width][.precision][type]:
+     *  0         : pad with zeros instead of spaces
+     *  width     : minimum field width, up to 255
+     *  precision : digits after the decimal point, floating point arguments only
+     *  type      : d, b, o, x (lower case digits) or X for integers, f (fixed) or e (scientific)
+     *              for floating point values, s for strings
+     * {{ and }} are literal braces.
+     */
+    struct format_piece {
+        bool is_arg = false;
+        size_t begin = 0;       /* literal text position in the format string */
+        size_t len = 0;         /* literal text length */
+        size_t arg = 0;         /* argument index */
+        char type = '\0';       /* '\0' when not given */
+        uint8_t width = 0;
+        char fill = ' ';
+        int precision = -1;     /* -1 when not given */
+    };
+
+    /* result of parsing a format string */
+    struct format_info {
+        bool valid = true;
+        size_t nbr_pieces = 0;
+        size_t nbr_args = 0;
+    };
+
+    /* read a decimal number up to 255, false if there is none or it is too large */
+    constexpr bool parse_number(std::string_view str, size_t& pos, int& value) {
+        const size_t start = pos;
+        value = 0;
+
+        while (pos < str.size() && str[pos] >= '0' && str[pos] <= '9') {
+            value = value * 10 + (str[pos] - '0');
+            if (value > 255) {
+                return false;
+            }
+            pos += 1;
+        }
+
+        return pos != start;
+    }
+
+    /**
+     * @brief Parse a format string, usable at compile time
+     * @param str, format string
+     * @param pieces, destination of the pieces, nullptr to only count them
+     * @return format_info, validity and number of pieces and arguments
+     */
+    constexpr format_info parse_format(std::string_view str, format_piece* pieces) {
+        format_info info;
+        size_t literal = 0;
+        size_t pos = 0;
+
+        /* a literal piece ends before pos, an escaped brace is its own piece of one character */
+        auto add_literal = [&](size_t end) {
+            if (end > literal) {
+                if (pieces != nullptr) {
+                    pieces[info.nbr_pieces].begin = literal;
+                    pieces[info.nbr_pieces].len = end - literal;
+                }
+                info.nbr_pieces += 1;
+            }
+        };
+
+        while (pos < str.size()) {
+            const char c = str[pos];
+
+            if ((c == '{' || c == '}') && pos + 1 < str.size() && str[pos + 1] == c) {
+                add_literal(pos + 1);
+                pos += 2;
+                literal = pos;
+            } else if (c == '{') {
+                format_piece piece;
+                int number = 0;
+
+                add_literal(pos);
+                pos += 1;
+
+                if (pos < str.size() && str[pos] == ':') {
+                    pos += 1;
+                    if (pos < str.size() && str[pos] == '0') {
+                        piece.fill = '0';
+                        pos += 1;
+                    }
+                    if (pos < str.size() && str[pos] >= '1' && str[pos] <= '9') {
+                        if (!parse_number(str, pos, number)) {
+                            info.valid = false;
+                            return info;
+                        }
+                        piece.width = static_cast<uint8_t>(number);
+                    }
+                    if (pos < str.size() && str[pos] == '.') {
+                        pos += 1;
+                        if (!parse_number(str, pos, number)) {
+                            info.valid = false;
+                            return info;
+                        }
+                        piece.precision = number;
+                    }
+                    if (pos < str.size() && std::string_view("dboxXfes").find(str[pos]) != std::string_view::npos) {
+                        piece.type = str[pos];
+                        pos += 1;
+                    }
+                }
+
+                if (pos >= str.size() || str[pos] != '}') {
+                    info.valid = false;
+                    return info;
+                }
+                pos += 1;
+                literal = pos;
+
+                piece.is_arg = true;
+                piece.arg = info.nbr_args;
+                if (pieces != nullptr) {
+                    pieces[info.nbr_pieces] = piece;
+                }
+                info.nbr_pieces += 1;
+                info.nbr_args += 1;
+            } else if (c == '}') {
+                /* a closing brace must be doubled */
+                info.valid = false;
+                return info;
+            } else {
+                pos += 1;
+            }
+        }
+
+        add_literal(pos);
+
+        return info;
+    }
+
+    /* pieces of a format string, at least one so the array is never empty */
+    template <size_t N>
+    struct format_pieces {
+        format_piece items[N > 0 ? N : 1];
+    };
+
+    template <size_t N>
+    constexpr format_pieces<N> make_format_pieces(std::string_view str) {
+        format_pieces<N> result{};
+        parse_format(str, result.items);
+        return result;
+    }
+
+    /**
+     * @brief Compile time parsed format string
+     * @tparam S, type with a static constexpr value() returning the format string, see SLOG_FMT
+     */
+    template <typename S>
+    struct parsed_format {
+        static constexpr std::string_view text = S::value();
+        static constexpr format_info info = parse_format(text, nullptr);
+
+        static constexpr format_pieces<info.nbr_pieces> pieces = make_format_pieces<info.nbr_pieces>(text);
+    };
+
+    /**
+     * @brief Check a placeholder type against an argument type
+     * @tparam T, argument type
+     * @param piece, placeholder
+     * @return true if the argument can be printed with this placeholder
+     */
+    template <typename T>
+    constexpr bool accepts(const format_piece& piece) {
+        const bool integral = std::is_integral<T>::value;
+        const bool floating = std::is_floating_point<T>::value;
+        const bool text = std::is_convertible<T, std::string_view>::value;
+
+        if (piece.precision >= 0 && !floating) {
+            return false;
+        }
+
+        switch (piece.type) {
+            case 'd':
+            case 'b':
+            case 'o':
+            case 'x':
+            case 'X':
+                return integral;
+            case 'f':
+            case 'e':
+                return floating;
+            case 's':
+                return text;
+            default:
+                return true;
+        }
+    }
+
+} // fmt
+} // slog
+
+/* Turns a string literal into a type carrying it, so a format string can be checked at compile
+ * time by the templates it is passed to */
+#define SLOG_FMT(str) \
+    [] { \
+        struct slog_format_string_ { \
+            static constexpr std::string_view value() { return str; } \
+        }; \
+        return slog_format_string_{}; \
+    }()
+
+#endif //SMALL_LOG_FORMAT_H
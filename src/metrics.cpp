@@ -0,0 +1,137 @@
+//
+// Created by lcrgo on 17/10/2026.
+//
+
+#include "metrics.h"
+
+namespace slog {
+
+    uint64_t metrics_snapshot::calls(size_t slot) const {
+        uint64_t total = 0;
+        for (uint64_t count : latency[slot]) {
+            total += count;
+        }
+        return total;
+    }
+
+    uint64_t metrics_snapshot::percentile_ns(size_t slot, double ratio) const {
+        const uint64_t total = calls(slot);
+        if (total == 0) {
+            return 0;
+        }
+
+        /* Rank of the call holding the percentile, counted from 1 */
+        uint64_t rank = static_cast<uint64_t>(ratio * static_cast<double>(total) + 0.999999);
+        rank = rank == 0 ? 1 : rank > total ? total : rank;
+
+        uint64_t seen = 0;
+        for (size_t i = 0; i < METRICS_LATENCY_BUCKETS; ++i) {
+            seen += latency[slot][i];
+            if (seen >= rank) {
+                return bucket_limit_ns(i);
+            }
+        }
+        return bucket_limit_ns(METRICS_LATENCY_BUCKETS - 1);
+    }
+
+#ifndef SLOG_NO_METRICS
+
+    /* Shard of the calling thread, given the first time the thread counts. The first threads
+     * own their shard, the later ones share the last one */
+    static size_t thread_shard() {
+        static std::atomic<size_t> next_shard(0);
+        thread_local const size_t shard = next_shard.fetch_add(1, std::memory_order_relaxed);
+        return shard < METRICS_SHARDS - 1 ? shard : METRICS_SHARDS - 1;
+    }
+
+    /* A shard owned by a single thread is updated without a locked instruction */
+    static void add(std::atomic<uint64_t>& counter, uint64_t value, size_t shard) {
+        if (shard < METRICS_SHARDS - 1) {
+            counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+        } else {
+            counter.fetch_add(value, std::memory_order_relaxed);
+        }
+    }
+
+    logger_metrics::logger_metrics() :
+    m_enabled(false) {
+
+        for (counters& entry : m_shards) {
+            for (size_t i = 0; i < nbr_levels; ++i) {
+                entry.records[i].store(0, std::memory_order_relaxed);
+                entry.filtered[i].store(0, std::memory_order_relaxed);
+            }
+            entry.bytes.store(0, std::memory_order_relaxed);
+        }
+        for (auto& slot : m_latency) {
+            for (std::atomic<uint64_t>& count : slot) {
+                count.store(0, std::memory_order_relaxed);
+            }
+        }
+    }
+
+    void logger_metrics::set_enabled(bool enabled) {
+        m_enabled.store(enabled, std::memory_order_relaxed);
+    }
+
+    void logger_metrics::count_filtered(level log_level) {
+        const size_t index = static_cast<size_t>(log_level);
+        if (index < nbr_levels) {
+            const size_t shard = thread_shard();
+            add(m_shards[shard].filtered[index], 1, shard);
+        }
+    }
+
+    void logger_metrics::count_records(span<const record> records) {
+        const size_t shard = thread_shard();
+        uint64_t bytes = 0;
+
+        for (const record& rec : records) {
+            const size_t index = static_cast<size_t>(rec.lvl);
+            if (index < nbr_levels) {
+                add(m_shards[shard].records[index], 1, shard);
+            }
+            bytes += rec.size;
+        }
+        add(m_shards[shard].bytes, bytes, shard);
+    }
+
+    void logger_metrics::count_latency(size_t slot, uint64_t ns) {
+        /* Bucket i holds the durations of i significant bits */
+#if defined(__GNUC__) || defined(__clang__)
+        size_t bucket = ns == 0 ? 0 : 64 - static_cast<size_t>(__builtin_clzll(ns));
+#else
+        size_t bucket = 0;
+        while (ns != 0 && bucket < METRICS_LATENCY_BUCKETS) {
+            ns >>= 1;
+            bucket += 1;
+        }
+#endif
+        if (bucket >= METRICS_LATENCY_BUCKETS) {
+            bucket = METRICS_LATENCY_BUCKETS - 1;
+        }
+        m_latency[slot][bucket].fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void logger_metrics::snapshot(metrics_snapshot& out) const {
+        for (const counters& entry : m_shards) {
+            for (size_t i = 0; i < nbr_levels; ++i) {
+                out.records[i] += entry.records[i].load(std::memory_order_relaxed);
+                out.filtered[i] += entry.filtered[i].load(std::memory_order_relaxed);
+            }
+            out.bytes += entry.bytes.load(std::memory_order_relaxed);
+        }
+        for (size_t slot = 0; slot < MAX_NBR_LOG_APPENDER; ++slot) {
+            for (size_t i = 0; i < METRICS_LATENCY_BUCKETS; ++i) {
+                out.latency[slot][i] += m_latency[slot][i].load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+#else
+
+    logger_metrics::logger_metrics() {}
+
+#endif
+
+} // slog
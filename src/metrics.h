@@ -0,0 +1,157 @@
+//
+// Created by lcrgo on 17/10/2026.
+//
+
+#ifndef SMALL_LOG_METRICS_H
+#define SMALL_LOG_METRICS_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include "record.h"
+#include "sink.h"
+
+namespace slog {
+
+#ifndef METRICS_SHARDS
+#define METRICS_SHARDS 4 /* Copies of the record counters of a logger, one per thread and a shared one */
+#endif
+
+#ifndef METRICS_LATENCY_BUCKETS
+#define METRICS_LATENCY_BUCKETS 24 /* Sink latency histogram buckets, powers of two nanoseconds up to 8 ms */
+#endif
+
+    /* Number of levels counted, level::disabled excluded */
+    constexpr size_t nbr_levels = static_cast<size_t>(level::disabled);
+
+    /**
+     * @brief Copy of the metrics of a logger at one point in time, see logger::get_metrics().
+     *        The counters only grow, the difference of two snapshots is the activity between them.
+     *        The counters stay still while the metrics are disabled, async_dropped is always set.
+     */
+    struct metrics_snapshot {
+        uint64_t records[nbr_levels];  /* records handed to the sinks, per level */
+        uint64_t filtered[nbr_levels]; /* calls below the logger level, per level */
+        uint64_t bytes;                /* size of the records handed to the sinks */
+        uint64_t async_dropped;        /* records dropped because the ring was full */
+        uint64_t latency[MAX_NBR_LOG_APPENDER][METRICS_LATENCY_BUCKETS]; /* sink calls per duration, per slot */
+
+        /**
+         * @brief Exclusive upper bound of a latency bucket. Bucket 0 counts the calls under 1 ns,
+         *        bucket i the calls of [2^(i-1), 2^i) ns and the last bucket all the longer ones.
+         * @param bucket, bucket index
+         * @return uint64_t, bound in nanoseconds, UINT64_MAX for the last bucket
+         */
+        static constexpr uint64_t bucket_limit_ns(size_t bucket) {
+            return bucket + 1 < METRICS_LATENCY_BUCKETS ? uint64_t(1) << bucket : UINT64_MAX;
+        }
+
+        /**
+         * @brief Number of sink calls timed for a slot
+         * @param slot, appender or sink slot, in the order they were added
+         * @return uint64_t, number of calls
+         */
+        uint64_t calls(size_t slot) const;
+
+        /**
+         * @brief Latency percentile of a slot, rounded up to its bucket limit
+         * @param slot, appender or sink slot, in the order they were added
+         * @param ratio, percentile between 0 and 1, e.g. 0.99
+         * @return uint64_t, upper bound in nanoseconds of the bucket holding the percentile, 0
+         *         when there was no call
+         */
+        uint64_t percentile_ns(size_t slot, double ratio) const;
+    };
+
+    /**
+     * @brief Counters of a logger. The record counters are split in per thread shards so
+     *        threads logging at the same time don't share a cache line: the first
+     *        METRICS_SHARDS - 1 threads own a shard and update it with relaxed loads and stores,
+     *        the later threads share the last shard and use relaxed atomic increments. The sink
+     *        latency histograms are shared, a timed sink call already costs two clock reads. The
+     *        snapshot adds the shards up. The counting functions are only called once enabled()
+     *        was checked. Empty when the library is built with SLOG_NO_METRICS.
+     */
+    class logger_metrics {
+    public:
+        logger_metrics();
+        /* default destructor, not virtual: only held by value in the logger */
+        ~logger_metrics() = default;
+        /* disable copy constructor */
+        logger_metrics(const logger_metrics&) = delete;
+        /* disable copy assignment */
+        logger_metrics& operator=(const logger_metrics&) = delete;
+
+#ifndef SLOG_NO_METRICS
+        /**
+         * @brief Tell if the metrics are collected
+         * @return true if the metrics are collected, false otherwise
+         */
+        bool enabled() const {
+            return m_enabled.load(std::memory_order_relaxed);
+        }
+
+        /**
+         * @brief Start or stop collecting, the counters are kept
+         * @param enabled, true to collect the metrics
+         */
+        void set_enabled(bool enabled);
+
+        /**
+         * @brief Count a call below the logger level
+         * @param log_level, level of the call
+         */
+        void count_filtered(level log_level);
+
+        /**
+         * @brief Count the records handed to the sinks and their size
+         * @param records, records dispatched together
+         */
+        void count_records(span<const record> records);
+
+        /**
+         * @brief Add a sink call to the latency histogram of its slot
+         * @param slot, appender or sink slot
+         * @param ns, time spent in the call
+         */
+        void count_latency(size_t slot, uint64_t ns);
+
+        /**
+         * @brief Add the shards up into a snapshot
+         * @param out, snapshot zeroed by the caller, async_dropped is left as it is
+         */
+        void snapshot(metrics_snapshot& out) const;
+#else
+        constexpr bool enabled() const { return false; }
+        void set_enabled(bool) {}
+        void count_filtered(level) {}
+        void count_records(span<const record>) {}
+        void count_latency(size_t, uint64_t) {}
+        void snapshot(metrics_snapshot&) const {}
+#endif
+
+    private:
+#ifndef SLOG_NO_METRICS
+        struct alignas(64) counters {
+            std::atomic<uint64_t> records[nbr_levels];
+            std::atomic<uint64_t> filtered[nbr_levels];
+            std::atomic<uint64_t> bytes;
+        };
+
+        static_assert(METRICS_SHARDS >= 1, "METRICS_SHARDS must be at least 1");
+
+        /* member variables */
+        std::atomic<bool> m_enabled;
+        counters m_shards[METRICS_SHARDS];
+        std::atomic<uint64_t> m_latency[MAX_NBR_LOG_APPENDER][METRICS_LATENCY_BUCKETS];
+#endif
+    };
+
+#ifdef SLOG_NO_METRICS
+    static_assert(sizeof(logger_metrics) == 1, "compiled out metrics must be an empty member of the logger");
+#endif
+
+} // slog
+
+#endif //SMALL_LOG_METRICS_H
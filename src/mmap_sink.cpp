@@ -0,0 +1,245 @@
+//
+// Created by lcrgo on 17/10/2026.
+//
+
+#include "mmap_sink.h"
+
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+
+namespace slog {
+
+    mmap_sink::mmap_sink(size_t segment_size) :
+    m_segment_size(segment_size > MAX_LOG_RECORD_LEN ? segment_size : MAX_LOG_RECORD_LEN),
+    m_page_size(static_cast<size_t>(sysconf(_SC_PAGESIZE))),
+    m_fd(-1),
+    m_current(nullptr),
+    m_writers(0),
+    m_rolls(0),
+    m_dropped_bytes(0) {
+
+        for (segment& seg : m_segments) {
+            seg.map = nullptr;
+            seg.map_len = 0;
+            seg.start = 0;
+            seg.data = nullptr;
+            seg.offset.store(0, std::memory_order_relaxed);
+            seg.end.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    mmap_sink::~mmap_sink() {
+        close();
+    }
+
+    /* Last non zero byte of the file, the zeros after it were preallocated but never written */
+    static off_t trim_zeros(int fd, off_t size) {
+        char chunk[4096];
+
+        while (size > 0) {
+            const off_t len = size < static_cast<off_t>(sizeof(chunk)) ? size : static_cast<off_t>(sizeof(chunk));
+            if (pread(fd, chunk, static_cast<size_t>(len), size - len) != len) {
+                break;
+            }
+            for (off_t i = len; i > 0; --i) {
+                if (chunk[i - 1] != '\0') {
+                    return size - len + i;
+                }
+            }
+            size -= len;
+        }
+
+        return size;
+    }
+
+    bool mmap_sink::open(const char* path, bool truncate) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        close_locked();
+
+        const int fd = ::open(path, O_RDWR | O_CREAT | O_CLOEXEC | (truncate ? O_TRUNC : 0), 0644);
+        if (fd < 0) {
+            return false;
+        }
+
+        struct stat st;
+        if (fstat(fd, &st) != 0) {
+            ::close(fd);
+            return false;
+        }
+
+        const off_t start = trim_zeros(fd, st.st_size);
+        m_fd = fd;
+        if (!map_segment(m_segments[0], static_cast<uint64_t>(start))) {
+            ::close(fd);
+            m_fd = -1;
+            return false;
+        }
+
+        m_rolls.store(0, std::memory_order_relaxed);
+        m_current.store(&m_segments[0], std::memory_order_seq_cst);
+
+        return true;
+    }
+
+    void mmap_sink::close() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        close_locked();
+    }
+
+    void mmap_sink::write(const record& rec) {
+        if (rec.size > m_segment_size) {
+            m_dropped_bytes.fetch_add(rec.size, std::memory_order_relaxed);
+            return;
+        }
+
+        for (;;) {
+            /* Announce the writer before using the segment, so it is not unmapped under it */
+            m_writers.fetch_add(1, std::memory_order_seq_cst);
+            segment* seg = m_current.load(std::memory_order_seq_cst);
+            if (seg == nullptr) {
+                m_writers.fetch_sub(1, std::memory_order_release);
+                m_dropped_bytes.fetch_add(rec.size, std::memory_order_relaxed);
+                return;
+            }
+
+            const size_t pos = seg->offset.fetch_add(rec.size, std::memory_order_seq_cst);
+            if (pos + rec.size <= m_segment_size) {
+                std::memcpy(&seg->data[pos], rec.data, rec.size);
+                m_writers.fetch_sub(1, std::memory_order_release);
+                return;
+            }
+
+            /* Does not fit, the segment ends at the first reservation that failed */
+            size_t end = seg->end.load(std::memory_order_relaxed);
+            while (pos < end && !seg->end.compare_exchange_weak(end, pos, std::memory_order_relaxed)) {}
+            m_writers.fetch_sub(1, std::memory_order_release);
+
+            if (!roll(seg)) {
+                m_dropped_bytes.fetch_add(rec.size, std::memory_order_relaxed);
+                return;
+            }
+        }
+    }
+
+    void mmap_sink::flush() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        segment* seg = m_current.load(std::memory_order_acquire);
+        if (seg != nullptr) {
+            msync(seg->map, seg->map_len, MS_ASYNC);
+        }
+    }
+
+    uint64_t mmap_sink::get_size() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        const segment* seg = m_current.load(std::memory_order_acquire);
+        return seg != nullptr ? seg->start + used(*seg) : 0;
+    }
+
+    size_t mmap_sink::get_rolls() const {
+        return m_rolls.load(std::memory_order_relaxed);
+    }
+
+    size_t mmap_sink::get_dropped_bytes() const {
+        return m_dropped_bytes.load(std::memory_order_relaxed);
+    }
+
+    bool mmap_sink::map_segment(segment& seg, uint64_t start) {
+        /* The mapping must start on a page, the segment starts right after the last record */
+        const uint64_t map_start = start - start % m_page_size;
+        const size_t map_len = static_cast<size_t>(start - map_start) + m_segment_size;
+
+        if (posix_fallocate(m_fd, static_cast<off_t>(start), static_cast<off_t>(m_segment_size)) != 0) {
+            return false;
+        }
+
+        /* Fault the pages in now, on the roll, rather than on the first record of each page */
+        int flags = MAP_SHARED;
+#ifdef MAP_POPULATE
+        flags |= MAP_POPULATE;
+#endif
+        void* map = mmap(nullptr, map_len, PROT_READ | PROT_WRITE, flags, m_fd, static_cast<off_t>(map_start));
+        if (map == MAP_FAILED) {
+            return false;
+        }
+
+        seg.map = static_cast<char*>(map);
+        seg.map_len = map_len;
+        seg.start = start;
+        seg.data = seg.map + (start - map_start);
+        seg.offset.store(0, std::memory_order_relaxed);
+        seg.end.store(m_segment_size, std::memory_order_relaxed);
+
+        return true;
+    }
+
+    void mmap_sink::unmap_segment(segment& seg) {
+        if (seg.map != nullptr) {
+            munmap(seg.map, seg.map_len);
+            seg.map = nullptr;
+            seg.data = nullptr;
+        }
+    }
+
+    size_t mmap_sink::used(const segment& seg) const {
+        const size_t offset = seg.offset.load(std::memory_order_acquire);
+        const size_t end = seg.end.load(std::memory_order_acquire);
+        return offset < end ? offset : end;
+    }
+
+    void mmap_sink::wait_writers() const {
+        while (m_writers.load(std::memory_order_seq_cst) != 0) {
+            std::this_thread::yield();
+        }
+    }
+
+    bool mmap_sink::roll(segment* full) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        /* Another writer already rolled, or the file was closed */
+        segment* current = m_current.load(std::memory_order_seq_cst);
+        if (current != full) {
+            return current != nullptr;
+        }
+
+        /* The writers that reserved room in the full segment are still copying */
+        wait_writers();
+
+        segment* next = full == &m_segments[0] ? &m_segments[1] : &m_segments[0];
+        const uint64_t start = full->start + used(*full);
+        const bool mapped = map_segment(*next, start);
+
+        m_current.store(mapped ? next : nullptr, std::memory_order_seq_cst);
+        if (!mapped) {
+            /* Keep the file readable, without the preallocated tail */
+            ftruncate(m_fd, static_cast<off_t>(start));
+        }
+        unmap_segment(*full);
+        m_rolls.fetch_add(1, std::memory_order_relaxed);
+
+        return mapped;
+    }
+
+    void mmap_sink::close_locked() {
+        segment* seg = m_current.exchange(nullptr, std::memory_order_seq_cst);
+
+        if (seg != nullptr) {
+            wait_writers();
+            const uint64_t size = seg->start + used(*seg);
+            unmap_segment(*seg);
+            ftruncate(m_fd, static_cast<off_t>(size));
+        }
+
+        if (m_fd >= 0) {
+            ::close(m_fd);
+            m_fd = -1;
+        }
+    }
+
+} // slog
@@ -0,0 +1,117 @@
+//
+// Created by lcrgo on 17/10/2026.
+//
+
+#ifndef SMALL_LOG_MMAP_SINK_H
+#define SMALL_LOG_MMAP_SINK_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+
+#include "sink.h"
+
+namespace slog {
+
+    /**
+     * @brief Sink copying the records into a memory mapped file (POSIX). The file grows by
+     *        segments, each one preallocated and mapped once, so writing a record is a memcpy
+     *        into the page cache: writers reserve their bytes by advancing an atomic offset and
+     *        copy without any lock. When a segment is full the sink rolls to the next one, right
+     *        after the last record, and close() truncates the file to the bytes really written.
+     *
+     *        Crash consistency:
+     *         - the page cache belongs to the kernel, every record copied before the process
+     *           crashes (abort, SIGKILL...) is in the file, in logging order
+     *         - the file keeps the preallocated length, the records are followed by zero bytes;
+     *           open() in append mode trims them and continues after the last record
+     *         - a record being copied when the process dies can be cut, or leave a zero filled
+     *           hole when a later record finished first
+     *         - a power loss or kernel crash only keeps what was written back to the disk,
+     *           flush() starts the write back
+     *         - append mode assumes text records, binary streams should be opened truncated
+     */
+    class mmap_sink : public sink {
+    public:
+        /**
+         * @brief Create a sink, not attached to any file yet
+         * @param segment_size, bytes preallocated and mapped at a time, at least MAX_LOG_RECORD_LEN
+         */
+        explicit mmap_sink(size_t segment_size = 1024 * 1024);
+        /* closes the file */
+        ~mmap_sink() override;
+
+        /**
+         * @brief Open a file and map its first segment, the current file is closed first
+         * @param path, file path, created when missing
+         * @param truncate, true to discard the current content, false to append
+         * @return true if the file was opened and mapped, false otherwise
+         */
+        bool open(const char* path, bool truncate = false);
+
+        /**
+         * @brief Unmap the file and truncate it to the bytes written, the next records are dropped
+         */
+        void close();
+
+        using sink::write;
+        void write(const record& rec) override;
+
+        /**
+         * @brief Start writing the mapped records back to the disk (msync(2) MS_ASYNC)
+         */
+        void flush() override;
+
+        /**
+         * @brief Length of the file content, the bytes written so far
+         * @return uint64_t, file length in bytes
+         */
+        uint64_t get_size() const;
+
+        /**
+         * @brief Number of segments the sink rolled to since the file was opened
+         * @return size_t, number of rolls
+         */
+        size_t get_rolls() const;
+
+        /**
+         * @brief Number of bytes lost, no file open or the file could not grow
+         * @return size_t, number of bytes dropped
+         */
+        size_t get_dropped_bytes() const;
+
+    private:
+        /* mapped part of the file */
+        struct segment {
+            char* map;
+            size_t map_len;
+            uint64_t start;             /* file offset of the first byte of the segment */
+            char* data;                 /* first byte of the segment, the mapping is page aligned */
+            std::atomic<size_t> offset; /* bytes reserved by the writers, can exceed the segment */
+            std::atomic<size_t> end;    /* first reservation that did not fit */
+        };
+
+        /* private member functions */
+        bool map_segment(segment& seg, uint64_t start);
+        void unmap_segment(segment& seg);
+        size_t used(const segment& seg) const;
+        void wait_writers() const;
+        bool roll(segment* full);
+        void close_locked();
+
+        /* member variables */
+        const size_t m_segment_size;
+        const size_t m_page_size;
+        int m_fd;
+        segment m_segments[2];
+        std::atomic<segment*> m_current;
+        std::atomic<size_t> m_writers;
+        std::atomic<size_t> m_rolls;
+        std::atomic<size_t> m_dropped_bytes;
+        mutable std::mutex m_mutex; /* open, close, flush and roll */
+    };
+
+} // slog
+
+#endif //SMALL_LOG_MMAP_SINK_H
@@ -0,0 +1,50 @@
+//
+// Created by lcrgo on 17/10/2026.
+//
+
+#include "rate_limit.h"
+
+namespace slog {
+
+    bool every_ms_site::allow(uint64_t interval_ms, uint64_t now_ns, uint64_t& suppressed) {
+        uint64_t next = m_next.load(std::memory_order_relaxed);
+
+        /* Only one of the calls reaching the deadline together moves it and is logged */
+        if (now_ns < next || !m_next.compare_exchange_strong(next, now_ns + interval_ms * 1000000,
+                                                             std::memory_order_relaxed)) {
+            m_suppressed.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+
+        suppressed = m_suppressed.exchange(0, std::memory_order_relaxed);
+        return true;
+    }
+
+    bool token_bucket_site::allow(uint64_t per_second, uint64_t burst, uint64_t now_ns, uint64_t& suppressed) {
+        if (per_second == 0) {
+            m_suppressed.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+
+        /* Each record moves the arrival time by one emission interval, the call is allowed while
+         * the arrival time is less than burst intervals ahead of now */
+        const uint64_t interval = 1000000000 / per_second;
+        const uint64_t limit = (burst != 0 ? burst : 1) * interval;
+        uint64_t arrival = m_arrival.load(std::memory_order_relaxed);
+
+        for (;;) {
+            const uint64_t next = (arrival > now_ns ? arrival : now_ns) + interval;
+            if (next - now_ns > limit) {
+                m_suppressed.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+            if (m_arrival.compare_exchange_weak(arrival, next, std::memory_order_relaxed)) {
+                break;
+            }
+        }
+
+        suppressed = m_suppressed.exchange(0, std::memory_order_relaxed);
+        return true;
+    }
+
+} // slog
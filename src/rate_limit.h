@@ -0,0 +1,93 @@
+//
+// Created by lcrgo on 17/10/2026.
+//
+
+#ifndef SMALL_LOG_RATE_LIMIT_H
+#define SMALL_LOG_RATE_LIMIT_H
+
+#include <atomic>
+#include <cstdint>
+
+namespace slog {
+
+    /**
+     * @brief Static state of a call site logging one call out of n, created by the
+     *        SLOG_*_EVERY_N makros. Only a relaxed counter increment is done per call.
+     */
+    class every_n_site {
+    public:
+        constexpr every_n_site() : m_count(0) {}
+
+        /**
+         * @brief Count a call and tell if it should be logged: the first one and then one every n
+         * @param n, period, 0 and 1 log every call
+         * @param suppressed, set to the number of calls suppressed since the last logged one
+         * @return true if the call should be logged, false otherwise
+         */
+        bool allow(uint64_t n, uint64_t& suppressed) {
+            const uint64_t count = m_count.fetch_add(1, std::memory_order_relaxed);
+
+            if (n <= 1) {
+                return true;
+            }
+            if (count % n != 0) {
+                return false;
+            }
+            suppressed = count == 0 ? 0 : n - 1;
+            return true;
+        }
+
+    private:
+        std::atomic<uint64_t> m_count;
+    };
+
+    /**
+     * @brief Static state of a call site logging at most once per interval, created by the
+     *        SLOG_*_EVERY_MS makros. Suppressed calls only read the deadline and count themselves.
+     */
+    class every_ms_site {
+    public:
+        constexpr every_ms_site() : m_next(0), m_suppressed(0) {}
+
+        /**
+         * @brief Count a call and tell if it should be logged: the first one and then the first
+         *        one after each interval
+         * @param interval_ms, interval in milliseconds
+         * @param now_ns, current monotonic time in nanoseconds (steady_clock_ns())
+         * @param suppressed, set to the number of calls suppressed since the last logged one
+         * @return true if the call should be logged, false otherwise
+         */
+        bool allow(uint64_t interval_ms, uint64_t now_ns, uint64_t& suppressed);
+
+    private:
+        std::atomic<uint64_t> m_next;
+        std::atomic<uint64_t> m_suppressed;
+    };
+
+    /**
+     * @brief Static state of a call site limited by a token bucket, created by the SLOG_*_RATE
+     *        makros. The bucket holds up to burst tokens and refills at the given rate, it is
+     *        kept as the theoretical arrival time of the next call (GCRA) in a single atomic.
+     */
+    class token_bucket_site {
+    public:
+        constexpr token_bucket_site() : m_arrival(0), m_suppressed(0) {}
+
+        /**
+         * @brief Count a call and tell if it should be logged, that is if a token is available
+         * @param per_second, refill rate in records per second, 0 suppresses every call
+         * @param burst, bucket size, at least 1
+         * @param now_ns, current monotonic time in nanoseconds (steady_clock_ns())
+         * @param suppressed, set to the number of calls suppressed since the last logged one
+         * @return true if the call should be logged, false otherwise
+         */
+        bool allow(uint64_t per_second, uint64_t burst, uint64_t now_ns, uint64_t& suppressed);
+
+    private:
+        std::atomic<uint64_t> m_arrival;
+        std::atomic<uint64_t> m_suppressed;
+    };
+
+} // slog
+
+#endif //SMALL_LOG_RATE_LIMIT_H
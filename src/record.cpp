@@ -0,0 +1,30 @@
+//
+// Created by lcrgo on 17/10/2026.
+//
+
+#include "record.h"
+
+namespace slog {
+
+    const char *get_print_level_str(level log_level) {
+        switch (log_level) {
+            case level::trace:
+                return "[TRACE]";
+            case level::debug:
+                return "[DEBUG]";
+            case level::info:
+                return "[INFO ]";
+            case level::warn:
+                return "[WARN ]";
+            case level::error:
+                return "[ERROR]";
+            case level::fatal:
+                return "[FATAL]";
+            case level::disabled:
+                return "[DISAB]";
+            default:
+                return "[UNKNW]";
+        }
+    }
+
+} // slog
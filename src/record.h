@@ -0,0 +1,94 @@
+//
+// Created by lcrgo on 17/10/2026.
+//
+
+#ifndef SMALL_LOG_RECORD_H
+#define SMALL_LOG_RECORD_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace slog {
+
+#ifndef MAX_LOG_RECORD_LEN
+#define MAX_LOG_RECORD_LEN 256 /* Max formatted record length including null terminator */
+#endif
+
+    /* log level enumeration */
+    enum class level {trace=0, debug, info, warn, error, fatal, disabled};
+
+    /**
+     * @brief Get the level as it is printed in the records, e.g. "[INFO ]"
+     * @param log_level, level
+     * @return const char*, level string, always 7 characters long
+     */
+    const char* get_print_level_str(level log_level);
+
+    /**
+     * @brief Name of a source file without its directories, usable at compile time
+     * @param path, file path, usually __FILE__
+     * @return const char*, file name, points into path
+     */
+    constexpr const char* file_basename(const char* path) {
+        const char* name = path;
+        for (const char* c = path; *c != '\0'; ++c) {
+            if (*c == '/' || *c == '\\') {
+                name = c + 1;
+            }
+        }
+        return name;
+    }
+
+    /**
+     * @brief Static description of a logging statement, made at compile time by the SLOG_<LEVEL>
+     *        makros (one per call site, see SLOG_CALL_SITE). Only its address is handed around,
+     *        it is unique and stable for the whole program run.
+     */
+    struct call_site {
+        const char* file;     /* file name without its directories */
+        const char* function;
+        uint32_t line;
+        level lvl;
+    };
+
+    /**
+     * @brief A fully formatted log record. The data is the complete line as it should be
+     *        written by the sink (including the leading new line) and is always null terminated,
+     *        the size does NOT include the null terminator.
+     *        Records replayed from the logger backtrace buffer are flagged, they are older than
+     *        the record that triggered them and below the logger level.
+     *        Records logged through the SLOG_<LEVEL> makros carry their call site, nullptr otherwise.
+     */
+    struct record {
+        const char* data;
+        size_t size;
+        level lvl;
+        bool backtrace = false;
+        const call_site* site = nullptr;
+    };
+
+    /**
+     * @brief Minimal non owning view over a contiguous sequence of objects, used to hand
+     *        batches of records to the sinks (std::span is only available from C++20).
+     */
+    template <typename T>
+    class span {
+    public:
+        constexpr span() : m_data(nullptr), m_size(0) {}
+        constexpr span(T* data, size_t size) : m_data(data), m_size(size) {}
+
+        constexpr T* data() const { return m_data; }
+        constexpr size_t size() const { return m_size; }
+        constexpr bool empty() const { return m_size == 0; }
+        constexpr T& operator[](size_t index) const { return m_data[index]; }
+        constexpr T* begin() const { return m_data; }
+        constexpr T* end() const { return m_data + m_size; }
+
+    private:
+        T* m_data;
+        size_t m_size;
+    };
+
+} // slog
+
+#endif //SMALL_LOG_RECORD_H
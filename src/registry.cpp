@@ -0,0 +1,259 @@
+//
+// Created by lcrgo on 17/10/2026.
+//
+
+#include "registry.h"
+
+#include <cstring>
+
+namespace slog {
+
+    /* Specificity of a pattern for a logger name, -1 if it does not match */
+    static int match(std::string_view pattern, std::string_view name) {
+        if (pattern == "*") {
+            return 0;
+        }
+
+        /* "net.*" matches the descendants of net */
+        if (pattern.size() >= 2 && pattern.substr(pattern.size() - 2) == ".*") {
+            const std::string_view prefix = pattern.substr(0, pattern.size() - 1);
+            return name.size() > prefix.size() && name.substr(0, prefix.size()) == prefix ?
+                   static_cast<int>(prefix.size()) : -1;
+        }
+
+        /* "net" matches net and its descendants */
+        if (name.substr(0, pattern.size()) == pattern &&
+            (name.size() == pattern.size() || name[pattern.size()] == '.')) {
+            return static_cast<int>(pattern.size());
+        }
+
+        return -1;
+    }
+
+    registry::registry() :
+    m_used(0),
+    m_size(0),
+    m_version(0),
+    m_rules(),
+    m_nbr_rules(0) {
+
+        for (slot& entry : m_slots) {
+            entry.hash.store(0, std::memory_order_relaxed);
+            entry.output.store(nullptr, std::memory_order_relaxed);
+        }
+    }
+
+    registry::~registry() {}
+
+    bool registry::add(logger& output) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        const std::string_view name(output.get_name());
+        const uint64_t hash = name_hash(name);
+
+        if (m_size.load(std::memory_order_relaxed) >= MAX_REGISTERED_LOGGERS) {
+            return false;
+        }
+
+        bool taken = false;
+        slot* free_slot = insert_slot(name, hash, taken);
+        if (free_slot == nullptr && !taken) {
+            /* The removed loggers fill the table, they are dropped by rebuilding it */
+            rebuild();
+            free_slot = insert_slot(name, hash, taken);
+        }
+        if (free_slot == nullptr) {
+            return false;
+        }
+
+        apply_rules(output);
+
+        /* The hash is set before the logger is published to the lock free lookups */
+        free_slot->hash.store(hash, std::memory_order_relaxed);
+        free_slot->output.store(&output, std::memory_order_release);
+        m_size.fetch_add(1, std::memory_order_relaxed);
+
+        return true;
+    }
+
+    registry::slot* registry::insert_slot(std::string_view name, uint64_t hash, bool& taken) {
+        slot* free_slot = nullptr;
+
+        /* Probe up to the first empty slot, the name must not be taken */
+        size_t index = hash & (nbr_slots - 1);
+        for (;; index = (index + 1) & (nbr_slots - 1)) {
+            slot& entry = m_slots[index];
+            const uint64_t entry_hash = entry.hash.load(std::memory_order_relaxed);
+            logger* entry_output = entry.output.load(std::memory_order_relaxed);
+
+            if (entry_hash == 0) {
+                break;
+            }
+            if (entry_output == nullptr) {
+                /* Removed logger, the slot can be reused */
+                if (free_slot == nullptr) {
+                    free_slot = &entry;
+                }
+            } else if (entry_hash == hash && name == entry_output->get_name()) {
+                taken = true;
+                return nullptr;
+            }
+        }
+
+        if (free_slot == nullptr) {
+            /* Always keep an empty slot so the probing ends */
+            if (m_used + 1 >= nbr_slots) {
+                return nullptr;
+            }
+            free_slot = &m_slots[index];
+            m_used += 1;
+        }
+        return free_slot;
+    }
+
+    void registry::rebuild() {
+        logger* outputs[MAX_REGISTERED_LOGGERS];
+        uint64_t hashes[MAX_REGISTERED_LOGGERS];
+        size_t nbr_outputs = 0;
+
+        for (slot& entry : m_slots) {
+            logger* output = entry.output.load(std::memory_order_relaxed);
+            if (output != nullptr && nbr_outputs < MAX_REGISTERED_LOGGERS) {
+                outputs[nbr_outputs] = output;
+                hashes[nbr_outputs] = entry.hash.load(std::memory_order_relaxed);
+                nbr_outputs += 1;
+            }
+        }
+
+        /* The lookups running meanwhile see the version change and start again */
+        m_version.store(m_version.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        for (slot& entry : m_slots) {
+            entry.output.store(nullptr, std::memory_order_relaxed);
+            entry.hash.store(0, std::memory_order_relaxed);
+        }
+        for (size_t i = 0; i < nbr_outputs; ++i) {
+            size_t index = hashes[i] & (nbr_slots - 1);
+            while (m_slots[index].hash.load(std::memory_order_relaxed) != 0) {
+                index = (index + 1) & (nbr_slots - 1);
+            }
+            m_slots[index].hash.store(hashes[i], std::memory_order_relaxed);
+            m_slots[index].output.store(outputs[i], std::memory_order_relaxed);
+        }
+        m_used = nbr_outputs;
+
+        m_version.store(m_version.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    bool registry::remove(logger& output) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        for (slot& entry : m_slots) {
+            if (entry.output.load(std::memory_order_relaxed) == &output) {
+                /* Keep the hash, the slot still links the probing sequence */
+                entry.output.store(nullptr, std::memory_order_release);
+                m_size.fetch_sub(1, std::memory_order_relaxed);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    logger* registry::find(std::string_view name, uint64_t hash) const {
+        for (;;) {
+            const uint32_t version = m_version.load(std::memory_order_acquire);
+            logger* found = nullptr;
+
+            if ((version & 1) == 0) {
+                size_t index = hash & (nbr_slots - 1);
+                for (;; index = (index + 1) & (nbr_slots - 1)) {
+                    const slot& entry = m_slots[index];
+                    const uint64_t entry_hash = entry.hash.load(std::memory_order_acquire);
+
+                    if (entry_hash == 0) {
+                        break;
+                    }
+                    if (entry_hash == hash) {
+                        logger* entry_output = entry.output.load(std::memory_order_acquire);
+                        if (entry_output != nullptr && name == entry_output->get_name()) {
+                            found = entry_output;
+                            break;
+                        }
+                    }
+                }
+            }
+
+            /* Only trusted when no rebuild started or ended meanwhile */
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if ((version & 1) == 0 && m_version.load(std::memory_order_relaxed) == version) {
+                return found;
+            }
+        }
+    }
+
+    bool registry::set_level(std::string_view pattern, level log_level) {
+        /* Only "*" or a trailing ".*" are wildcards */
+        const size_t star = pattern.find('*');
+        if (pattern.empty() || pattern.size() >= sizeof(rule::pattern) ||
+            (star != std::string_view::npos && star != pattern.size() - 1) ||
+            (star != std::string_view::npos && pattern.size() > 1 && pattern[star - 1] != '.')) {
+            return false;
+        }
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        rule* target = nullptr;
+        for (size_t i = 0; i < m_nbr_rules; ++i) {
+            if (std::string_view(m_rules[i].pattern, m_rules[i].len) == pattern) {
+                target = &m_rules[i];
+                break;
+            }
+        }
+        if (target == nullptr) {
+            if (m_nbr_rules >= MAX_LEVEL_RULES) {
+                return false;
+            }
+            target = &m_rules[m_nbr_rules];
+            std::memcpy(target->pattern, pattern.data(), pattern.size());
+            target->pattern[pattern.size()] = '\0';
+            target->len = pattern.size();
+            m_nbr_rules += 1;
+        }
+        target->lvl = log_level;
+
+        /* Every logger is resolved again, a more specific pattern still wins */
+        for (slot& entry : m_slots) {
+            logger* output = entry.output.load(std::memory_order_relaxed);
+            if (output != nullptr) {
+                apply_rules(*output);
+            }
+        }
+
+        return true;
+    }
+
+    size_t registry::size() const {
+        return m_size.load(std::memory_order_relaxed);
+    }
+
+    void registry::apply_rules(logger& output) const {
+        const std::string_view name(output.get_name());
+        int best = -1;
+        level log_level = level::info;
+
+        /* Later patterns win over the earlier ones of the same specificity */
+        for (size_t i = 0; i < m_nbr_rules; ++i) {
+            const int specificity = match(std::string_view(m_rules[i].pattern, m_rules[i].len), name);
+            if (specificity >= 0 && specificity >= best) {
+                best = specificity;
+                log_level = m_rules[i].lvl;
+            }
+        }
+
+        if (best >= 0) {
+            output.set_Level(log_level);
+        }
+    }
+
+} // slog
@@ -0,0 +1,143 @@
+//
+// Created by lcrgo on 17/10/2026.
+//
+
+#ifndef SMALL_LOG_REGISTRY_H
+#define SMALL_LOG_REGISTRY_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string_view>
+
+#include "slog.h"
+
+namespace slog {
+
+#ifndef MAX_REGISTERED_LOGGERS
+#define MAX_REGISTERED_LOGGERS 64 /* Max number of loggers in a registry */
+#endif
+
+#ifndef MAX_LEVEL_RULES
+#define MAX_LEVEL_RULES 16 /* Max number of level patterns kept by a registry */
+#endif
+
+    /**
+     * @brief Hash of a logger name (64 bit FNV-1a), usable at compile time
+     * @param name, logger name
+     * @return uint64_t, hash, never 0
+     */
+    constexpr uint64_t name_hash(std::string_view name) {
+        uint64_t hash = 0xcbf29ce484222325ull;
+        for (char c : name) {
+            hash = (hash ^ static_cast<uint8_t>(c)) * 0x100000001b3ull;
+        }
+        return hash != 0 ? hash : 1;
+    }
+
+    /**
+     * @brief Set of loggers found by their dotted hierarchical name ("net.tcp.rx") and whose
+     *        levels are set by name pattern. The storage is fixed, nothing is allocated.
+     *        The registry only stores the level into the loggers (one atomic store each), the
+     *        logging hot path keeps reading the level cached in the logger.
+     *        The loggers are NOT owned by the registry and must be removed before they are
+     *        destroyed.
+     */
+    class registry {
+    public:
+        registry();
+        /* default destructor */
+        virtual ~registry();
+        /* disable copy constructor */
+        registry(const registry&) = delete;
+        /* disable copy assignment */
+        registry& operator=(const registry&) = delete;
+
+        /**
+         * @brief Add a logger, the level patterns set so far are applied to it. When the slots
+         *        left by the removed loggers fill the table it is rebuilt without them.
+         * @param output, logger, found by its name
+         * @return true if the logger was added, false if the name is taken or the registry full
+         */
+        bool add(logger& output);
+
+        /**
+         * @brief Remove a logger
+         * @param output, logger
+         * @return true if the logger was removed, false if it was not in the registry
+         */
+        bool remove(logger& output);
+
+        /**
+         * @brief Find a logger by name, without lock
+         * @param name, logger name
+         * @return logger*, logger, nullptr if there is none with that name
+         */
+        logger* find(std::string_view name) const {
+            return find(name, name_hash(name));
+        }
+
+        /**
+         * @brief Find a logger by name and precomputed hash, without lock. A lookup running
+         *        while add() rebuilds the table starts again.
+         * @param name, logger name
+         * @param hash, name_hash(name), e.g. computed at compile time
+         * @return logger*, logger, nullptr if there is none with that name
+         */
+        logger* find(std::string_view name, uint64_t hash) const;
+
+        /**
+         * @brief Set the level of the loggers matching a pattern, now and when they are added.
+         *        The most specific pattern matching a logger decides its level:
+         *         "net"   : the net logger and its descendants (net.tcp, net.tcp.rx, ...)
+         *         "net.*" : the descendants of net only
+         *         "*"     : every logger
+         *        Loggers matching no pattern keep their own level.
+         * @param pattern, logger name, name followed by ".*" or "*"
+         * @param log_level, level
+         * @return true if the pattern was stored, false if it is invalid or there are already
+         *         MAX_LEVEL_RULES patterns
+         */
+        bool set_level(std::string_view pattern, level log_level);
+
+        /**
+         * @brief Number of registered loggers
+         * @return size_t, number of loggers
+         */
+        size_t size() const;
+
+    private:
+        /* hash table slot, a removed logger leaves its hash so the probing goes on */
+        struct slot {
+            std::atomic<uint64_t> hash;
+            std::atomic<logger*> output;
+        };
+
+        struct rule {
+            char pattern[MAX_LOG_NAME_LEN + 2];
+            size_t len;
+            level lvl;
+        };
+
+        /* private member functions */
+        slot* insert_slot(std::string_view name, uint64_t hash, bool& taken);
+        void rebuild();
+        void apply_rules(logger& output) const;
+
+        /* member variables */
+        static constexpr size_t nbr_slots = 2 * MAX_REGISTERED_LOGGERS;
+        static_assert((nbr_slots & (nbr_slots - 1)) == 0, "MAX_REGISTERED_LOGGERS must be a power of two");
+
+        slot m_slots[nbr_slots];
+        size_t m_used;   /* slots holding a logger or a removed one */
+        std::atomic<size_t> m_size;
+        std::atomic<uint32_t> m_version; /* odd while the slots are rebuilt, the lookups retry */
+        rule m_rules[MAX_LEVEL_RULES];
+        size_t m_nbr_rules;
+        std::mutex m_mutex;
+    };
+
+} // slog
+
+#endif //SMALL_LOG_REGISTRY_H
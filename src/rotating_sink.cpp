@@ -0,0 +1,423 @@
+//
+// Created by lcrgo on 17/10/2026.
+//
+
+#include "rotating_sink.h"
+#include "tick.h"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace slog {
+
+    /* Rotated file name suffix, '0' stands for a digit */
+    static constexpr char generation_pattern[] = "0000-00-00_00-00-00.000";
+    static constexpr size_t generation_time_len = sizeof(generation_pattern) - 1;
+
+    /* Tell if a suffix is a rotation time, optionally followed by a sequence number */
+    static bool parse_generation(const char* suffix, unsigned& sequence) {
+        for (size_t i = 0; i < generation_time_len; ++i) {
+            const bool digit = suffix[i] >= '0' && suffix[i] <= '9';
+            if (generation_pattern[i] == '0' ? !digit : suffix[i] != generation_pattern[i]) {
+                return false;
+            }
+        }
+
+        sequence = 0;
+        const char* rest = &suffix[generation_time_len];
+        if (*rest == '\0') {
+            return true;
+        }
+        if (*rest != '.' || rest[1] == '\0') {
+            return false;
+        }
+        for (rest += 1; *rest != '\0'; ++rest) {
+            if (*rest < '0' || *rest > '9' || sequence > 100000) {
+                return false;
+            }
+            sequence = sequence * 10 + static_cast<unsigned>(*rest - '0');
+        }
+        return true;
+    }
+
+    /* Order of two rotated files by their suffix: time first, then sequence number */
+    static bool generation_before(const char* suffix, const char* other) {
+        const int order = std::strncmp(suffix, other, generation_time_len);
+        if (order != 0) {
+            return order < 0;
+        }
+        unsigned sequence = 0;
+        unsigned other_sequence = 0;
+        parse_generation(suffix, sequence);
+        parse_generation(other, other_sequence);
+        return sequence < other_sequence;
+    }
+
+    rotating_file_sink::rotating_file_sink() :
+    m_max_size(0),
+    m_interval(0),
+    m_max_files(MAX_ROTATING_FILES),
+    m_time_provider(nullptr),
+    m_path(),
+    m_next_path(),
+    m_generations(),
+    m_nbr_generations(0),
+    m_oldest_generation(0),
+    m_fd(-1),
+    m_standby_fd(-1),
+    m_retired_fd(-1),
+    m_written(0),
+    m_stop(false),
+    m_rotations(0),
+    m_dropped_bytes(0) {}
+
+    rotating_file_sink::~rotating_file_sink() {
+        close();
+    }
+
+    void rotating_file_sink::set_max_size(uint64_t max_size) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_max_size = max_size;
+    }
+
+    void rotating_file_sink::set_interval(std::chrono::seconds interval) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_interval = interval;
+        m_deadline = std::chrono::steady_clock::now() + interval;
+    }
+
+    void rotating_file_sink::set_max_files(size_t max_files) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_max_files = max_files < MAX_ROTATING_FILES ? max_files : MAX_ROTATING_FILES;
+    }
+
+    void rotating_file_sink::set_time_provider(time_provider_fn time_provider) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_time_provider = time_provider;
+    }
+
+    bool rotating_file_sink::open(const char* path) {
+        close();
+
+        /* Room is kept for the ".next" and the timestamp suffixes */
+        if (path == nullptr || std::strlen(path) + 32 > MAX_ROTATING_PATH_LEN) {
+            return false;
+        }
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        std::snprintf(m_path, sizeof(m_path), "%s", path);
+        std::snprintf(m_next_path, sizeof(m_next_path), "%s.next", path);
+
+        recover_standby();
+        m_fd = ::open(m_path, O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+        if (m_fd < 0) {
+            return false;
+        }
+        m_standby_fd = ::open(m_next_path, O_WRONLY | O_CREAT | O_TRUNC | O_APPEND | O_CLOEXEC, 0644);
+
+        struct stat st;
+        m_written = fstat(m_fd, &st) == 0 ? static_cast<uint64_t>(st.st_size) : 0;
+        m_deadline = std::chrono::steady_clock::now() + m_interval;
+        scan_generations();
+        m_stop = false;
+        m_worker = std::thread(&rotating_file_sink::rotate_run, this);
+
+        return true;
+    }
+
+    void rotating_file_sink::close() {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stop = true;
+        }
+        m_rotate_cv.notify_one();
+
+        if (m_worker.joinable()) {
+            m_worker.join();
+        }
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_fd >= 0) {
+            ::close(m_fd);
+            m_fd = -1;
+        }
+        if (m_standby_fd >= 0) {
+            ::close(m_standby_fd);
+            ::unlink(m_next_path);
+            m_standby_fd = -1;
+        }
+    }
+
+    void rotating_file_sink::write(const record& rec) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        if (m_fd < 0) {
+            m_dropped_bytes.fetch_add(rec.size, std::memory_order_relaxed);
+            return;
+        }
+
+        /* Swap to the standby file, the background thread does the slow work */
+        if (m_written != 0 && m_standby_fd >= 0 && m_retired_fd < 0 && rotation_due(rec.size)) {
+            m_retired_fd = m_fd;
+            m_fd = m_standby_fd;
+            m_standby_fd = -1;
+            m_written = 0;
+            m_deadline = std::chrono::steady_clock::now() + m_interval;
+            m_rotate_cv.notify_one();
+        }
+
+        write_fd(m_fd, rec.data, rec.size);
+        m_written += rec.size;
+    }
+
+    void rotating_file_sink::flush() {
+        std::unique_lock<std::mutex> lock(m_mutex);
+
+        while (m_retired_fd >= 0 && m_worker.joinable()) {
+            m_done_cv.wait_for(lock, std::chrono::milliseconds(10));
+        }
+    }
+
+    size_t rotating_file_sink::get_rotations() const {
+        return m_rotations.load(std::memory_order_relaxed);
+    }
+
+    size_t rotating_file_sink::get_dropped_bytes() const {
+        return m_dropped_bytes.load(std::memory_order_relaxed);
+    }
+
+    bool rotating_file_sink::rotation_due(size_t size) const {
+        return (m_max_size != 0 && m_written + size > m_max_size) ||
+               (m_interval.count() != 0 && std::chrono::steady_clock::now() >= m_deadline);
+    }
+
+    void rotating_file_sink::rotate_run() {
+        std::unique_lock<std::mutex> lock(m_mutex);
+
+        for (;;) {
+            if (m_retired_fd >= 0 || (m_standby_fd < 0 && !m_stop)) {
+                const int retired = m_retired_fd;
+                const size_t max_files = m_max_files;
+                lock.unlock();
+
+                if (retired >= 0) {
+                    retire(retired, max_files);
+                }
+                /* Also retried here when the standby file could not be opened before */
+                const int standby = ::open(m_next_path, O_WRONLY | O_CREAT | O_TRUNC | O_APPEND | O_CLOEXEC, 0644);
+
+                lock.lock();
+                if (m_standby_fd >= 0) {
+                    ::close(m_standby_fd);
+                }
+                m_standby_fd = standby;
+                if (retired >= 0) {
+                    m_retired_fd = -1;
+                    m_rotations.fetch_add(1, std::memory_order_relaxed);
+                    m_done_cv.notify_all();
+                }
+                if (standby >= 0 || m_retired_fd >= 0) {
+                    continue;
+                }
+            }
+
+            /* Pending rotations are finished before stopping */
+            if (m_stop) {
+                break;
+            }
+
+            m_rotate_cv.wait_for(lock, std::chrono::milliseconds(100));
+        }
+    }
+
+    void rotating_file_sink::retire(int fd, size_t max_files) {
+        ::close(fd);
+
+        /* The records written since the swap are in the standby file, it takes the path over */
+        if (max_files == 0) {
+            ::unlink(m_path);
+            ::rename(m_next_path, m_path);
+            return;
+        }
+
+        /* Delete the oldest generations to make room for the new one */
+        while (m_nbr_generations >= max_files) {
+            ::unlink(m_generations[m_oldest_generation]);
+            m_oldest_generation = (m_oldest_generation + 1) % MAX_ROTATING_FILES;
+            m_nbr_generations -= 1;
+        }
+
+        const timedate td = m_time_provider != nullptr ? m_time_provider() :
+                            ticks_to_timedate(system_clock_ns(), 1000000000);
+        char* name = m_generations[(m_oldest_generation + m_nbr_generations) % MAX_ROTATING_FILES];
+
+        /* Without a valid name the old records are dropped rather than overwriting a file */
+        if (!generation_name(name, td)) {
+            ::unlink(m_path);
+            ::rename(m_next_path, m_path);
+            return;
+        }
+
+        ::rename(m_path, name);
+        ::rename(m_next_path, m_path);
+        m_nbr_generations += 1;
+    }
+
+    bool rotating_file_sink::generation_name(char* name, const timedate& td) const {
+        /* A coarse clock can give two rotations the same time, a sequence number tells them apart */
+        for (unsigned sequence = 0; sequence < 1000; ++sequence) {
+            int len = std::snprintf(name, MAX_ROTATING_PATH_LEN, "%s.%04d-%02d-%02d_%02d-%02d-%02d.%03d", m_path,
+                                    td.getMYear(), td.getMMonth(), td.getMDay(),
+                                    td.getMHour(), td.getMMinute(), td.getMSecond(), td.getMMillisecond());
+            if (len > 0 && len < MAX_ROTATING_PATH_LEN && sequence != 0) {
+                len += std::snprintf(name + len, static_cast<size_t>(MAX_ROTATING_PATH_LEN - len), ".%u", sequence);
+            }
+            if (len <= 0 || len >= MAX_ROTATING_PATH_LEN) {
+                return false;
+            }
+            if (::access(name, F_OK) != 0) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void rotating_file_sink::recover_standby() {
+        /* An earlier run swapped to the standby file and stopped before renaming it, its records
+         * are the newest ones */
+        struct stat st;
+        if (::stat(m_next_path, &st) != 0 || st.st_size == 0) {
+            return;
+        }
+        if (::stat(m_path, &st) != 0 || st.st_size == 0) {
+            ::rename(m_next_path, m_path);
+            return;
+        }
+
+        const int in = ::open(m_next_path, O_RDONLY | O_CLOEXEC);
+        const int out = ::open(m_path, O_WRONLY | O_APPEND | O_CLOEXEC);
+        bool copied = in >= 0 && out >= 0;
+        char buffer[4096];
+        while (copied) {
+            const ssize_t nbr_read = ::read(in, buffer, sizeof(buffer));
+            if (nbr_read < 0 && errno == EINTR) {
+                continue;
+            }
+            if (nbr_read <= 0) {
+                copied = nbr_read == 0;
+                break;
+            }
+            const size_t dropped = m_dropped_bytes.load(std::memory_order_relaxed);
+            write_fd(out, buffer, static_cast<size_t>(nbr_read));
+            copied = m_dropped_bytes.load(std::memory_order_relaxed) == dropped;
+        }
+        if (in >= 0) {
+            ::close(in);
+        }
+        if (out >= 0) {
+            ::close(out);
+        }
+
+        /* Kept aside rather than truncated when the copy failed */
+        if (!copied) {
+            char name[MAX_ROTATING_PATH_LEN];
+            if (std::snprintf(name, sizeof(name), "%s.recovered", m_next_path) < static_cast<int>(sizeof(name))) {
+                ::rename(m_next_path, name);
+            }
+        }
+    }
+
+    void rotating_file_sink::scan_generations() {
+        m_nbr_generations = 0;
+        m_oldest_generation = 0;
+
+        /* The rotated files are "<dir>/<name>.<time>[.<sequence>]" */
+        char dir_path[MAX_ROTATING_PATH_LEN];
+        const char* slash = std::strrchr(m_path, '/');
+        const size_t prefix_len = slash != nullptr ? static_cast<size_t>(slash - m_path) + 1 : 0;
+        std::snprintf(dir_path, sizeof(dir_path), "%.*s", static_cast<int>(prefix_len), m_path);
+        if (prefix_len == 0) {
+            std::snprintf(dir_path, sizeof(dir_path), ".");
+        }
+        const char* base = &m_path[prefix_len];
+        const size_t base_len = std::strlen(base);
+        const size_t suffix_pos = std::strlen(m_path) + 1;
+
+        DIR* dir = opendir(dir_path);
+        if (dir == nullptr) {
+            return;
+        }
+
+        /* Keep the newest generations, oldest first */
+        unsigned sequence;
+        for (int pass = 0; pass < 2; ++pass) {
+            while (const dirent* entry = readdir(dir)) {
+                const char* name = entry->d_name;
+                if (std::strncmp(name, base, base_len) != 0 || name[base_len] != '.' ||
+                    !parse_generation(&name[base_len + 1], sequence)) {
+                    continue;
+                }
+                const char* suffix = &name[base_len + 1];
+
+                char path[MAX_ROTATING_PATH_LEN];
+                const int len = std::snprintf(path, sizeof(path), "%s.%s", m_path, suffix);
+                if (len < 0 || len >= static_cast<int>(sizeof(path))) {
+                    continue;
+                }
+
+                if (pass == 0) {
+                    size_t pos = m_nbr_generations;
+                    while (pos > 0 && generation_before(suffix, &m_generations[pos - 1][suffix_pos])) {
+                        pos -= 1;
+                    }
+                    if (m_nbr_generations < m_max_files) {
+                        std::memmove(m_generations[pos + 1], m_generations[pos],
+                                     (m_nbr_generations - pos) * sizeof(m_generations[0]));
+                        m_nbr_generations += 1;
+                    } else if (pos == 0) {
+                        continue;
+                    } else {
+                        /* The oldest one kept makes room */
+                        std::memmove(m_generations[0], m_generations[1], (pos - 1) * sizeof(m_generations[0]));
+                        pos -= 1;
+                    }
+                    std::memcpy(m_generations[pos], path, static_cast<size_t>(len) + 1);
+                } else {
+                    /* The older ones are pruned like the rotation does */
+                    bool kept = false;
+                    for (size_t i = 0; i < m_nbr_generations && !kept; ++i) {
+                        kept = std::strcmp(m_generations[i], path) == 0;
+                    }
+                    if (!kept) {
+                        ::unlink(path);
+                    }
+                }
+            }
+            rewinddir(dir);
+        }
+        closedir(dir);
+    }
+
+    void rotating_file_sink::write_fd(int fd, const char* data, size_t size) {
+        /* Partial writes are resumed, errors drop what is left */
+        while (size > 0) {
+            const ssize_t written = ::write(fd, data, size);
+            if (written <= 0) {
+                if (written < 0 && errno == EINTR) {
+                    continue;
+                }
+                m_dropped_bytes.fetch_add(size, std::memory_order_relaxed);
+                return;
+            }
+            data += written;
+            size -= static_cast<size_t>(written);
+        }
+    }
+
+} // slog
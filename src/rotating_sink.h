@@ -0,0 +1,152 @@
+//
+// Created by lcrgo on 17/10/2026.
+//
+
+#ifndef SMALL_LOG_ROTATING_SINK_H
+#define SMALL_LOG_ROTATING_SINK_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+
+#include "sink.h"
+#include "tick.h"
+#include "timedate.h"
+
+namespace slog {
+
+#ifndef MAX_ROTATING_FILES
+#define MAX_ROTATING_FILES 16 /* Max number of rotated files kept */
+#endif
+
+#ifndef MAX_ROTATING_PATH_LEN
+#define MAX_ROTATING_PATH_LEN 256 /* Max path length including null terminator */
+#endif
+
+    /**
+     * @brief Sink writing to a file that is rotated by size and/or time (POSIX). The records are
+     *        always written to the given path; on rotation the file is renamed after the rotation
+     *        time, for example "app.log" -> "app.log.2024-01-30_23-25-16.753", and the oldest
+     *        rotated files beyond the number of generations are deleted. When a file already has
+     *        that name a sequence number is added, "app.log.2024-01-30_23-25-16.753.1".
+     *
+     *        Rotation never blocks the logging threads: a background thread keeps the next file
+     *        open in advance ("<path>.next"). The record that reaches a limit only swaps the file
+     *        descriptors, the background thread then closes the old file, renames both files,
+     *        deletes the oldest generation and opens the next standby file. When rotations come
+     *        faster than that, the current file simply grows until the standby file is ready.
+     *
+     *        open() picks up where an earlier run stopped: records left in the standby file are
+     *        appended to the file, and the rotated files found next to it count as generations.
+     */
+    class rotating_file_sink : public sink {
+    public:
+        rotating_file_sink();
+        /* closes the file and stops the background thread */
+        ~rotating_file_sink() override;
+
+        /**
+         * @brief Set the size limit, the file is rotated before a record would exceed it
+         * @param max_size, limit in bytes, 0 for no limit (default)
+         */
+        void set_max_size(uint64_t max_size);
+
+        /**
+         * @brief Set the time limit, the file is rotated by the first record after it
+         * @param interval, longest time a file is written, 0 for no limit (default)
+         */
+        void set_interval(std::chrono::seconds interval);
+
+        /**
+         * @brief Set the number of rotated files kept
+         * @param max_files, number of generations, up to MAX_ROTATING_FILES (default)
+         */
+        void set_max_files(size_t max_files);
+
+        /**
+         * @brief Set the clock used to name the rotated files, called by the background thread.
+         *        By default the system clock (UTC) is used. Must be set before open().
+         * @param time_provider, function returning the current time
+         */
+        void set_time_provider(time_provider_fn time_provider);
+
+        /**
+         * @brief Open the file, in append mode, and start the background thread. The current
+         *        file is closed first. A non empty standby file left by an earlier run is appended
+         *        to the file, and the oldest rotated files beyond the number of generations are
+         *        deleted.
+         * @param path, file path, shorter than MAX_ROTATING_PATH_LEN minus 32 characters
+         * @return true if the file was opened, false otherwise
+         */
+        bool open(const char* path);
+
+        /**
+         * @brief Finish the pending rotation, stop the background thread and close the file.
+         *        The next records are dropped.
+         */
+        void close();
+
+        using sink::write;
+        void write(const record& rec) override;
+
+        /**
+         * @brief Wait for the pending rotation, if any, to be done
+         */
+        void flush() override;
+
+        /**
+         * @brief Number of rotations done so far
+         * @return size_t, number of rotations
+         */
+        size_t get_rotations() const;
+
+        /**
+         * @brief Number of bytes lost because the file could not be written
+         * @return size_t, number of bytes dropped
+         */
+        size_t get_dropped_bytes() const;
+
+    private:
+        /* private member functions */
+        bool rotation_due(size_t size) const;
+        void rotate_run();
+        void retire(int fd, size_t max_files);
+        bool generation_name(char* name, const timedate& td) const;
+        void recover_standby();
+        void scan_generations();
+        void write_fd(int fd, const char* data, size_t size);
+
+        /* member variables, the generations are only used by the background thread */
+        uint64_t m_max_size;
+        std::chrono::seconds m_interval;
+        size_t m_max_files;
+        time_provider_fn m_time_provider;
+        char m_path[MAX_ROTATING_PATH_LEN];
+        char m_next_path[MAX_ROTATING_PATH_LEN];
+        char m_generations[MAX_ROTATING_FILES][MAX_ROTATING_PATH_LEN];
+        size_t m_nbr_generations;
+        size_t m_oldest_generation;
+
+        /* state shared with the background thread, guarded by the mutex */
+        int m_fd;
+        int m_standby_fd;
+        int m_retired_fd;
+        uint64_t m_written;
+        std::chrono::steady_clock::time_point m_deadline;
+        bool m_stop;
+        std::mutex m_mutex;
+        std::condition_variable m_rotate_cv;
+        std::condition_variable m_done_cv;
+        std::thread m_worker;
+
+        std::atomic<size_t> m_rotations;
+        std::atomic<size_t> m_dropped_bytes;
+    };
+
+} // slog
+
+#endif //SMALL_LOG_ROTATING_SINK_H
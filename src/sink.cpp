@@ -0,0 +1,34 @@
+//
+// Created by lcrgo on 17/10/2026.
+//
+
+#include "sink.h"
+
+namespace slog {
+
+    sink::~sink() {}
+
+    void sink::write(span<const record> records) {
+        for (const record& rec : records) {
+            write(rec);
+        }
+    }
+
+    void sink::flush() {}
+
+    void sink::poll() {}
+
+    appender_sink::appender_sink(appender_fn appender) :
+    m_appender(appender) {}
+
+    void appender_sink::write(const record& rec) {
+        if (m_appender != nullptr) {
+            m_appender(rec.data);
+        }
+    }
+
+    void appender_sink::set_appender(appender_fn appender) {
+        m_appender = appender;
+    }
+
+} // slog
@@ -0,0 +1,82 @@
+//
+// Created by lcrgo on 17/10/2026.
+//
+
+#ifndef SMALL_LOG_SINK_H
+#define SMALL_LOG_SINK_H
+
+#include "delegate.h"
+#include "record.h"
+
+namespace slog {
+
+#ifndef MAX_NBR_LOG_APPENDER
+#define MAX_NBR_LOG_APPENDER 3 /* Max number of appenders and sinks of a logger */
+#endif
+
+    /* Classic appender function, receives the null terminated record */
+    using appender_fn = delegate<void(const char*)>;
+
+    /**
+     * @brief Record oriented output interface. A sink receives every log record exactly once,
+     *        as a single buffer carrying its own length, so it can write the whole line with one
+     *        system call or one lock.
+     */
+    class sink {
+    public:
+        sink() = default;
+        virtual ~sink();
+        sink(const sink&) = delete;
+        sink& operator=(const sink&) = delete;
+
+        /**
+         * @brief Write a single record
+         * @param rec, record to be written
+         */
+        virtual void write(const record& rec) = 0;
+
+        /**
+         * @brief Write a batch of records. The default implementation writes them one by one,
+         *        sinks that can coalesce writes should override it.
+         * @param records, records to be written, in the order they were logged
+         */
+        virtual void write(span<const record> records);
+
+        /**
+         * @brief Push any buffered record to its final destination. Called by logger::flush()
+         *        and when the logger stops, the default implementation does nothing.
+         */
+        virtual void flush();
+
+        /**
+         * @brief Time based upkeep, like flushing records that waited too long. Called about every
+         *        10 ms by the logger asynchronous worker, or by logger::poll(). The default
+         *        implementation does nothing.
+         */
+        virtual void poll();
+    };
+
+    /**
+     * @brief Adapter that exposes a classic `void(const char*)` appender function as a sink.
+     */
+    class appender_sink : public sink {
+    public:
+        appender_sink() = default;
+        explicit appender_sink(appender_fn appender);
+
+        using sink::write;
+        void write(const record& rec) override;
+
+        /**
+         * @brief Set the appender function called for every record
+         * @param appender, appender function
+         */
+        void set_appender(appender_fn appender);
+
+    private:
+        appender_fn m_appender;
+    };
+
+} // slog
+
+#endif //SMALL_LOG_SINK_H
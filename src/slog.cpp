@@ -3,52 +3,168 @@
 //
 
 #include "slog.h"
+#include "timestamp.h"
+#include "format.h"
 
+#include <cmath>
 #include <cstdio>
 
 namespace slog {
 
+    /* Raw items of the records kept by the backtrace buffer, in host byte order. The codes
+     * match the binary logger argument types */
+    namespace raw {
+        constexpr char text = 's';      /* u16 length | bytes */
+        constexpr char int64 = 'i';     /* fmt::int_spec | int64_t */
+        constexpr char uint64 = 'u';    /* fmt::int_spec | uint64_t */
+        constexpr char float64 = 'f';   /* fmt::float_spec | double */
+        constexpr char float32 = 'F';   /* fmt::float_spec | float */
+        constexpr char tick = 't';      /* u64 tick, first item with a tick source */
+        constexpr char timestamp = 'T'; /* u8 length | rendered time, first item with a time provider */
+        constexpr char site = 'c';      /* call_site pointer, after the time */
+        constexpr char field = 'k';     /* u8 quoted | u8 key length | key, the value items follow */
+    }
+
+    /* Backtrace slot sequence while a record is copied into it */
+    static constexpr size_t busy_slot = SIZE_MAX;
+
+    /* FNV-1a style hash taking 8 bytes per step, records are hashed on every commit when the
+     * deduplication is enabled so the byte-wise version would cost too much */
+    static uint64_t hash_record(const char* data, size_t size) {
+        uint64_t hash = 0xcbf29ce484222325ull ^ size;
+        uint64_t word;
+
+        for (; size >= sizeof(word); data += sizeof(word), size -= sizeof(word)) {
+            std::memcpy(&word, data, sizeof(word));
+            hash = (hash ^ word) * 0x100000001b3ull;
+            hash ^= hash >> 29;
+        }
+        word = 0;
+        std::memcpy(&word, data, size);
+        hash = (hash ^ word) * 0x100000001b3ull;
+
+        return hash ^ (hash >> 32);
+    }
+
     logger::logger(const char* logger_name) :
     m_level(level::info),
-    m_last_log_level(level::info),
-    m_radix(radix::dec),
+    m_gate_level(level::info),
+    m_format_level(level::info),
     m_print_date(false),
-    m_time_provider(nullptr) {
+    m_print_source(false),
+    m_layout(layout::text),
+    m_sanitize(false),
+    m_time_provider(nullptr),
+    m_tick_source(nullptr),
+    m_ticks_per_second(0),
+    m_async(false),
+    m_overflow(async_overflow::block),
+    m_worker_idle(false),
+    m_worker_stop(false),
+    m_flush_target(0),
+    m_flushed(0),
+    m_async_dropped(0),
+    m_backtrace_level(level::disabled),
+    m_trigger_level(level::disabled),
+    m_backtrace_slots(nullptr),
+    m_backtrace_mask(0),
+    m_backtrace_head(0),
+    m_backtrace_tail(0),
+    m_dedup_window(0),
+    m_dedup_hash(0),
+    m_dedup_level(level::disabled),
+    m_dedup_repeats(0),
+    m_dedup_deadline(0) {
 
         /* Store the given logger name up to the buffer size, the excess will be trimmed */
         std::snprintf(m_logger_name, sizeof(m_logger_name), "%s", logger_name);
 
         for (int i = 0; i < MAX_NBR_LOG_APPENDER; ++i) {
-            m_appenders[i] = nullptr;
+            m_sinks[i].store(nullptr, std::memory_order_relaxed);
+            m_capture_levels[i].store(level::disabled, std::memory_order_relaxed);
         }
-
-        std::memset(m_print_timestamp, 0, sizeof(m_print_timestamp));
-        std::memset(m_print_level_str, 0, sizeof(m_print_level_str));
-        std::memset(m_print_logger_name, 0, sizeof(m_print_logger_name));
     }
 
-    logger::~logger() {}
+    logger::~logger() {
+        /* Write whatever is still queued */
+        report_repeats();
+        shutdown();
+    }
 
     logger::level logger::get_Level() const {
-        return m_level;
+        return m_level.load(std::memory_order_relaxed);
     }
 
     void logger::set_Level(level log_level) {
-        m_level = log_level;
+        std::lock_guard<std::mutex> lock(m_config_mutex);
+
+        m_level.store(log_level, std::memory_order_relaxed);
+        update_gate_level();
     }
 
-    bool logger::add_appender(std::function<void(const char*)> appender) {
+    void logger::update_gate_level() {
+        level format = m_level.load(std::memory_order_relaxed);
+
         for (int i = 0; i < MAX_NBR_LOG_APPENDER; ++i) {
-            if (m_appenders[i] == nullptr) {
-                m_appenders[i] = appender;
+            const level capture = m_capture_levels[i].load(std::memory_order_relaxed);
+            if (capture < format) {
+                format = capture;
+            }
+        }
+
+        /* The records between the backtrace level and the format level are kept raw */
+        const level backtrace = m_backtrace_level.load(std::memory_order_relaxed);
+        m_format_level.store(format, std::memory_order_relaxed);
+        m_gate_level.store(backtrace < format ? backtrace : format, std::memory_order_relaxed);
+    }
+
+    bool logger::add_appender(appender_fn appender) {
+        /* Registration is rare, the lock only serializes it against other registrations */
+        std::lock_guard<std::mutex> lock(m_config_mutex);
+
+        for (int i = 0; i < MAX_NBR_LOG_APPENDER; ++i) {
+            if (m_sinks[i].load(std::memory_order_relaxed) == nullptr) {
+                /* Each slot has its own adapter, so appenders don't need any extra storage.
+                 * The adapter is ready before it is published to the logging threads */
+                m_appender_sinks[i].set_appender(appender);
+                m_sinks[i].store(&m_appender_sinks[i], std::memory_order_release);
                 return true;
             }
         }
         return false;
     }
 
-    void logger::set_time_provider(std::function<timedate()> time_provider) {
+    bool logger::add_sink(sink& output) {
+        return add_sink(output, level::disabled);
+    }
+
+    bool logger::add_sink(sink& output, level capture_level) {
+        std::lock_guard<std::mutex> lock(m_config_mutex);
+
+        for (int i = 0; i < MAX_NBR_LOG_APPENDER; ++i) {
+            if (m_sinks[i].load(std::memory_order_relaxed) == nullptr) {
+                /* The capture level is set before the sink is published, the gate after */
+                m_capture_levels[i].store(capture_level, std::memory_order_relaxed);
+                m_sinks[i].store(&output, std::memory_order_release);
+                update_gate_level();
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void logger::set_time_provider(time_provider_fn time_provider) {
         m_time_provider = time_provider;
+        m_tick_source = nullptr;
+    }
+
+    void logger::set_tick_source(tick_source source, uint64_t ticks_per_second) {
+        if (source == nullptr || ticks_per_second == 0) {
+            return;
+        }
+        m_tick_source = source;
+        m_ticks_per_second = ticks_per_second;
+        m_time_provider = nullptr;
     }
 
     const char *logger::get_name() const {
@@ -56,185 +172,1122 @@ namespace slog {
     }
 
     void logger::set_print_date(bool print_date) {
-        m_print_date = print_date;
+        m_print_date.store(print_date, std::memory_order_relaxed);
     }
 
-    bool logger::get_print_date() {
-        return m_print_date;
+    bool logger::get_print_date() const {
+        return m_print_date.load(std::memory_order_relaxed);
     }
 
-    const char* logger::get_print_timestamp() {
-        /* The timestamp should look like this: [2024/02/10 23:12:35.123] or
-         *                           like this: [23:12:35.123]
-         * depending if the date should be printed or NOT */
+    void logger::write_prefix(line& ln) {
+        /* The record prefix looks like this: \n[2024/02/10 23:12:35.123][INFO ][logger_name] or
+         *                        like this: \n[23:12:35.123][INFO ][logger_name]
+         * depending if the date should be printed or NOT, the timestamp is only present when
+         * there is a time provider or a tick source */
+        open_record(ln, m_tick_source != nullptr || m_time_provider != nullptr);
 
-        if (m_time_provider != nullptr) {
-            /* Get the current time from the time provider */
-            timedate td = m_time_provider();
+        /* The deduplication drops records after they are built, their time is only rendered
+         * once they are known to be written */
+        const bool dedup = m_dedup_window.load(std::memory_order_relaxed) != 0;
 
-            if(m_print_date) {
-                /* Build the timestamp using the information from the time provider */
-                std::snprintf(m_print_timestamp, sizeof(m_print_timestamp), "[%04d/%02d/%02d %02d:%02d:%02d.%03d]",
-                              td.getMYear(), td.getMMonth(), td.getMDay(),
-                              td.getMHour(), td.getMMinute(), td.getMSecond(), td.getMMillisecond());
+        if (m_tick_source != nullptr) {
+            const size_t len = timestamp_cache::length(m_print_date.load(std::memory_order_relaxed));
+            ln.m_tick = m_tick_source();
+
+            if (m_async.load(std::memory_order_relaxed) || dedup) {
+                /* Only reserve the room, the worker or commit() renders it */
+                ln.m_timestamp_len = len;
+                ln.m_size += len;
             } else {
-                /* Build the timestamp using the information from the time provider */
-                std::snprintf(m_print_timestamp, sizeof(m_print_timestamp), "[%02d:%02d:%02d.%03d]",
-                              td.getMHour(), td.getMMinute(), td.getMSecond(), td.getMMillisecond());
+                render_timestamp(&ln.m_data[ln.m_size], ln.m_tick, len);
+                ln.m_size += len;
             }
+        } else if (m_time_provider != nullptr && dedup) {
+            ln.m_provider_time_len = timestamp_cache::length(m_print_date.load(std::memory_order_relaxed));
+            ln.m_size += ln.m_provider_time_len;
+        } else if (m_time_provider != nullptr) {
+            char timestamp[timestamp_cache::max_len];
+            write_timestamp(ln, timestamp, render_provider_time(timestamp));
         }
 
-        return m_print_timestamp;
+        write_level_and_name(ln);
     }
 
-    const char *logger::get_print_level_str(level level) {
-        std::memset(m_print_level_str, 0, sizeof(m_print_level_str));
+    void logger::open_record(line& ln, bool timed) {
+        /* json records are a single object per line, the time is its first member */
+        ln.append("\n", 1);
+        if (ln.m_json) {
+            if (timed) {
+                ln.append("{\"time\":", 8);
+            } else {
+                ln.append("{", 1);
+            }
+        }
+    }
 
-        switch (level) {
-            case level::trace: {
-                std::snprintf(m_print_level_str, sizeof(m_print_level_str), "[%s]", "TRACE");
-                break;
+    void logger::write_timestamp(line& ln, const char* timestamp, size_t len) {
+        const size_t pos = ln.m_size;
+        ln.append(timestamp, len);
+
+        /* [23:12:35.123] becomes "23:12:35.123" */
+        if (ln.m_json && ln.m_size == pos + len && len >= 2) {
+            ln.m_data[pos] = '"';
+            ln.m_data[pos + len - 1] = '"';
+        }
+    }
+
+    size_t logger::timestamp_pos() const {
+        /* after "\n" or "\n{\"time\":" */
+        return m_layout == layout::json ? 9 : 1;
+    }
+
+    void logger::set_print_source(bool print_source) {
+        m_print_source.store(print_source, std::memory_order_relaxed);
+    }
+
+    void logger::set_layout(layout record_layout) {
+        m_layout = record_layout;
+    }
+
+    void logger::set_sanitize(bool sanitize) {
+        m_sanitize = sanitize;
+    }
+
+    void logger::set_dedup_window(std::chrono::milliseconds window) {
+        report_repeats();
+        m_dedup_hash.store(0, std::memory_order_relaxed);
+        m_dedup_window.store(window.count() > 0 ? static_cast<uint64_t>(window.count()) * 1000000 : 0,
+                             std::memory_order_relaxed);
+    }
+
+    bool logger::is_duplicate(const line& ln) {
+        /* The timestamp is left out, the level, name and message are compared */
+        const size_t offset = m_tick_source != nullptr || m_time_provider != nullptr ?
+                              timestamp_pos() + timestamp_cache::length(m_print_date.load(std::memory_order_relaxed)) : 1;
+        const uint64_t hash = offset < ln.m_size ? hash_record(&ln.m_data[offset], ln.m_size - offset) : 0;
+
+        if (hash != m_dedup_hash.load(std::memory_order_relaxed)) {
+            /* The run ended, its summary goes before the new record */
+            report_repeats();
+            m_dedup_level.store(ln.m_level, std::memory_order_relaxed);
+            m_dedup_hash.store(hash, std::memory_order_relaxed);
+            return false;
+        }
+
+        /* The clock is only read for duplicates, the window starts with the first one */
+        const uint64_t now = steady_clock_ns();
+        uint64_t deadline = m_dedup_deadline.load(std::memory_order_relaxed);
+        if (deadline == 0) {
+            deadline = now + m_dedup_window.load(std::memory_order_relaxed);
+            m_dedup_deadline.store(deadline, std::memory_order_relaxed);
+        }
+        if (now < deadline) {
+            m_dedup_repeats.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+
+        /* Long runs are reported once per window, the record starts the next one */
+        report_repeats();
+        return false;
+    }
+
+    void logger::report_repeats() {
+        m_dedup_deadline.store(0, std::memory_order_relaxed);
+
+        /* Most runs are a single record, only read the count then */
+        if (m_dedup_repeats.load(std::memory_order_relaxed) == 0) {
+            return;
+        }
+
+        const uint64_t repeats = m_dedup_repeats.exchange(0, std::memory_order_relaxed);
+        if (repeats != 0) {
+            line summary(this, m_dedup_level.load(std::memory_order_relaxed), "last message repeated ");
+            summary.m_summary = true;
+            summary << repeats << (repeats == 1 ? " time" : " times");
+        }
+    }
+
+    void logger::write_level_and_name(line& ln) {
+        const bool print_source = ln.m_site != nullptr && m_print_source.load(std::memory_order_relaxed);
+        char line_number[fmt::max_integer_len];
+        size_t line_len = 0;
+        if (print_source) {
+            line_len = fmt::write_integer(line_number, ln.m_site->line, fmt::int_spec{10, 0, ' ', true});
+        }
+
+        if (ln.m_json) {
+            /* "[INFO ]" is written "INFO" */
+            const char* level_str = get_print_level_str(ln.m_level) + 1;
+            size_t level_len = 5;
+            while (level_len > 0 && level_str[level_len - 1] == ' ') {
+                level_len -= 1;
             }
-            case level::debug: {
-                std::snprintf(m_print_level_str, sizeof(m_print_level_str), "[%s]", "DEBUG" );
-                break;
+
+            if (ln.m_size > 2) {
+                ln.append(",", 1);
             }
-            case level::info: {
-                std::snprintf(m_print_level_str, sizeof(m_print_level_str), "[%s]", "INFO " );
-                break;
+            ln.append("\"level\":\"", 9);
+            ln.append(level_str, level_len);
+            ln.append("\",\"logger\":\"", 12);
+            ln.append(m_logger_name, std::strlen(m_logger_name));
+            if (print_source) {
+                ln.append("\",\"file\":\"", 10);
+                ln.append(ln.m_site->file, std::strlen(ln.m_site->file));
+                ln.append("\",\"line\":", 9);
+                ln.append(line_number, line_len);
+                ln.append(",\"func\":\"", 9);
+                ln.append(ln.m_site->function, std::strlen(ln.m_site->function));
             }
-            case level::warn: {
-                std::snprintf(m_print_level_str, sizeof(m_print_level_str), "[%s]", "WARN " );
-                break;
+            ln.append("\",\"msg\":\"", 9);
+            ln.m_open_quote = true;
+            return;
+        }
+
+        ln.append(get_print_level_str(ln.m_level), 7);
+        ln.append("[", 1);
+        ln.append(m_logger_name, std::strlen(m_logger_name));
+        if (print_source) {
+            ln.append("][", 2);
+            ln.append(ln.m_site->file, std::strlen(ln.m_site->file));
+            ln.append(":", 1);
+            ln.append(line_number, line_len);
+        }
+        ln.append("] ", 2);
+    }
+
+    size_t logger::render_provider_time(char* out) {
+        /* Each thread keeps the last rendered timestamp, only the changed digits are
+         * rewritten (usually just the milliseconds) */
+        static thread_local timestamp_cache cache;
+
+        /* Get the current time from the time provider */
+        timedate td = m_time_provider();
+        return cache.render(td, m_print_date.load(std::memory_order_relaxed), out);
+    }
+
+    void logger::write_provider_time(line& ln) {
+        char timestamp[timestamp_cache::max_len];
+        const size_t len = render_provider_time(timestamp);
+
+        /* The date setting may have changed since the room was reserved */
+        char* out = &ln.m_data[timestamp_pos()];
+        std::memset(out, ' ', ln.m_provider_time_len);
+        std::memcpy(out, timestamp, len < ln.m_provider_time_len ? len : ln.m_provider_time_len);
+        if (ln.m_json && len == ln.m_provider_time_len && len >= 2) {
+            out[0] = '"';
+            out[len - 1] = '"';
+        }
+    }
+
+    void logger::write_raw_time(line& ln) {
+        /* Raw records keep the time first: the tick, or the rendered time of the time provider
+         * since its calendar fields can't be rendered later */
+        if (m_tick_source != nullptr) {
+            const uint64_t tick = m_tick_source();
+            ln.m_data[0] = raw::tick;
+            std::memcpy(&ln.m_data[1], &tick, sizeof(tick));
+            ln.m_size = 1 + sizeof(tick);
+        } else if (m_time_provider != nullptr) {
+            const size_t len = render_provider_time(&ln.m_data[2]);
+            ln.m_data[0] = raw::timestamp;
+            ln.m_data[1] = static_cast<char>(len);
+            ln.m_size = 2 + len;
+        }
+
+        if (ln.m_site != nullptr) {
+            ln.m_data[ln.m_size] = raw::site;
+            std::memcpy(&ln.m_data[ln.m_size + 1], &ln.m_site, sizeof(ln.m_site));
+            ln.m_size += 1 + sizeof(ln.m_site);
+        }
+    }
+
+    void logger::commit(line& ln) {
+
+        if (ln.m_raw) {
+            push_backtrace(ln);
+            return;
+        }
+
+        if (!ln.m_backtrace && !ln.m_summary && m_dedup_window.load(std::memory_order_relaxed) != 0 &&
+            is_duplicate(ln)) {
+            return;
+        }
+
+        if (ln.m_provider_time_len != 0) {
+            write_provider_time(ln);
+        }
+
+        /* The context leading to the trigger record is written before it */
+        if (!ln.m_backtrace && ln.m_level >= m_trigger_level.load(std::memory_order_relaxed)) {
+            replay_backtrace();
+        }
+
+        /* The level was already checked when the line was created and the record buffer
+         * always keeps room for the null terminator */
+        ln.m_data[ln.m_size] = '\0';
+        const record rec = {ln.m_data, ln.m_size, ln.m_level, ln.m_backtrace, ln.m_site};
+
+        if (m_async.load(std::memory_order_acquire)) {
+            push_async(rec, ln.m_tick, ln.m_timestamp_len);
+        } else {
+            /* The asynchronous mode stopped while the record was built */
+            if (ln.m_timestamp_len != 0) {
+                render_timestamp(&ln.m_data[timestamp_pos()], ln.m_tick, ln.m_timestamp_len);
             }
-            case level::error: {
-                std::snprintf(m_print_level_str, sizeof(m_print_level_str), "[%s]", "ERROR" );
-                break;
+            dispatch(span<const record>(&rec, 1));
+        }
+    }
+
+    bool logger::enable_backtrace(backtrace_slot* slots, size_t nbr_slots, level backtrace_level,
+                                  level trigger_level) {
+        std::lock_guard<std::mutex> lock(m_config_mutex);
+
+        /* The number of slots must be a power of two so the position can be masked */
+        if (m_backtrace_slots != nullptr || slots == nullptr || nbr_slots == 0 ||
+            (nbr_slots & (nbr_slots - 1)) != 0) {
+            return false;
+        }
+
+        for (size_t i = 0; i < nbr_slots; ++i) {
+            slots[i].sequence.store(0, std::memory_order_relaxed);
+        }
+        m_backtrace_slots = slots;
+        m_backtrace_mask = nbr_slots - 1;
+        m_trigger_level.store(trigger_level, std::memory_order_relaxed);
+        m_backtrace_level.store(backtrace_level, std::memory_order_relaxed);
+        update_gate_level();
+
+        return true;
+    }
+
+    void logger::push_backtrace(const line& ln) {
+        /* The level may have changed since the line was created */
+        if (m_backtrace_slots == nullptr || ln.m_level < m_backtrace_level.load(std::memory_order_relaxed)) {
+            return;
+        }
+
+        const size_t pos = m_backtrace_head.fetch_add(1, std::memory_order_relaxed);
+        backtrace_slot& slot = m_backtrace_slots[pos & m_backtrace_mask];
+
+        /* A writer one lap ahead still owns the slot, this record is the one dropped */
+        if (slot.sequence.exchange(busy_slot, std::memory_order_acquire) != busy_slot) {
+            std::memcpy(slot.data, ln.m_data, ln.m_size);
+            slot.size = ln.m_size;
+            slot.lvl = ln.m_level;
+            slot.sequence.store(pos + 1, std::memory_order_release);
+        }
+    }
+
+    void logger::replay_backtrace() {
+        if (m_backtrace_slots == nullptr) {
+            return;
+        }
+
+        /* Concurrent triggers replay each record once */
+        std::lock_guard<std::mutex> lock(m_backtrace_mutex);
+        const size_t head = m_backtrace_head.load(std::memory_order_acquire);
+        const size_t nbr_slots = m_backtrace_mask + 1;
+        size_t pos = head > nbr_slots && head - nbr_slots > m_backtrace_tail ? head - nbr_slots : m_backtrace_tail;
+        char data[MAX_LOG_RECORD_LEN];
+
+        for (; pos < head; ++pos) {
+            const backtrace_slot& slot = m_backtrace_slots[pos & m_backtrace_mask];
+
+            /* Copy the record and keep it only if it was not rewritten meanwhile, records
+             * still being stored are skipped */
+            if (slot.sequence.load(std::memory_order_acquire) != pos + 1) {
+                continue;
             }
-            case level::fatal: {
-                std::snprintf(m_print_level_str, sizeof(m_print_level_str), "[%s]", "FATAL" );
-                break;
+            const level lvl = slot.lvl;
+            const size_t size = slot.size;
+            std::memcpy(data, slot.data, size);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (slot.sequence.load(std::memory_order_relaxed) != pos + 1) {
+                continue;
             }
-            case level::disabled: {
-                std::snprintf(m_print_level_str, sizeof(m_print_level_str), "[%s]", "DISAB" );
+
+            replay(lvl, data, size);
+        }
+
+        m_backtrace_tail = head;
+    }
+
+    void logger::replay(level log_level, const char* data, size_t size) {
+        /* The replayed line is committed like any other one when it goes out of scope */
+        line ln(nullptr, log_level, std::string_view());
+        ln.m_logger = this;
+        ln.m_backtrace = true;
+        ln.m_json = m_layout == layout::json;
+        ln.m_sanitize = m_sanitize;
+        open_record(ln, size >= 1 && (data[0] == raw::tick || data[0] == raw::timestamp));
+
+        size_t pos = 0;
+        if (size >= 1 + sizeof(uint64_t) && data[0] == raw::tick) {
+            uint64_t tick;
+            std::memcpy(&tick, &data[1], sizeof(tick));
+            const size_t len = timestamp_cache::length(m_print_date.load(std::memory_order_relaxed));
+            render_timestamp(&ln.m_data[ln.m_size], tick, len);
+            ln.m_size += len;
+            pos = 1 + sizeof(tick);
+        } else if (size >= 2 && data[0] == raw::timestamp) {
+            const size_t len = static_cast<uint8_t>(data[1]);
+            write_timestamp(ln, &data[2], len);
+            pos = 2 + len;
+        }
+        if (pos < size && size - pos >= 1 + sizeof(ln.m_site) && data[pos] == raw::site) {
+            std::memcpy(&ln.m_site, &data[pos + 1], sizeof(ln.m_site));
+            pos += 1 + sizeof(ln.m_site);
+        }
+
+        write_level_and_name(ln);
+
+        /* A field is started with its first value, once the room it needs is known */
+        std::string_view key;
+        bool quoted = false;
+        bool pending_field = false;
+        auto write_value = [&](const char* text, size_t len) {
+            if (pending_field) {
+                pending_field = false;
+                ln.begin_field(key, quoted, quoted ? 0 : len);
+            }
+            ln.append_text(text, len);
+        };
+
+        char field[fmt::max_integer_len > fmt::max_float_len ? fmt::max_integer_len : fmt::max_float_len];
+        while (pos < size) {
+            const char tag = data[pos];
+            pos += 1;
+
+            if (tag == raw::text && size - pos >= sizeof(uint16_t)) {
+                uint16_t len;
+                std::memcpy(&len, &data[pos], sizeof(len));
+                pos += sizeof(len);
+                if (len > size - pos) {
+                    break;
+                }
+                write_value(&data[pos], len);
+                pos += len;
+            } else if (tag == raw::field && size - pos >= 2) {
+                const size_t len = static_cast<uint8_t>(data[pos + 1]);
+                quoted = data[pos] != 0;
+                pos += 2;
+                if (len > size - pos) {
+                    break;
+                }
+                key = std::string_view(&data[pos], len);
+                pending_field = true;
+                pos += len;
+            } else if ((tag == raw::int64 || tag == raw::uint64) &&
+                       size - pos >= sizeof(fmt::int_spec) + sizeof(uint64_t)) {
+                fmt::int_spec spec;
+                std::memcpy(&spec, &data[pos], sizeof(spec));
+                pos += sizeof(spec);
+                if (tag == raw::int64) {
+                    int64_t value;
+                    std::memcpy(&value, &data[pos], sizeof(value));
+                    write_value(field, fmt::write_integer(field, value, spec));
+                } else {
+                    uint64_t value;
+                    std::memcpy(&value, &data[pos], sizeof(value));
+                    write_value(field, fmt::write_integer(field, value, spec));
+                }
+                pos += sizeof(uint64_t);
+            } else if (tag == raw::float64 && size - pos >= sizeof(fmt::float_spec) + sizeof(double)) {
+                fmt::float_spec spec;
+                double value;
+                std::memcpy(&spec, &data[pos], sizeof(spec));
+                std::memcpy(&value, &data[pos + sizeof(spec)], sizeof(value));
+                write_value(field, fmt::write_float(field, value, spec));
+                pos += sizeof(spec) + sizeof(value);
+            } else if (tag == raw::float32 && size - pos >= sizeof(fmt::float_spec) + sizeof(float)) {
+                fmt::float_spec spec;
+                float value;
+                std::memcpy(&spec, &data[pos], sizeof(spec));
+                std::memcpy(&value, &data[pos + sizeof(spec)], sizeof(value));
+                write_value(field, fmt::write_float(field, value, spec));
+                pos += sizeof(spec) + sizeof(value);
+            } else {
                 break;
             }
-            default: {
-                std::snprintf(m_print_level_str, sizeof(m_print_level_str), "[%s]", "UNKNW" );
+        }
+    }
+
+    void logger::render_timestamp(char* out, uint64_t tick, size_t timestamp_len) const {
+        /* Each thread keeps the calendar time of the current second */
+        static thread_local timestamp_cache cache;
+
+        cache.render(tick, m_ticks_per_second, timestamp_len == timestamp_cache::max_len, out);
+        if (m_layout == layout::json) {
+            out[0] = '"';
+            out[timestamp_len - 1] = '"';
+        }
+    }
+
+    void logger::dispatch(span<const record> records) {
+        /* Records below the logger level were only built for the sinks capturing them, unless
+         * they are replayed from the backtrace buffer */
+        const level log_level = m_level.load(std::memory_order_relaxed);
+        bool captured = false;
+        for (const record& rec : records) {
+            captured = captured || (rec.lvl < log_level && !rec.backtrace);
+        }
+
+        /* Each sink call is timed from the end of the previous one */
+        const bool measured = m_metrics.enabled();
+        uint64_t start = 0;
+        if (measured) {
+            m_metrics.count_records(records);
+            start = steady_clock_ns();
+        }
+
+        for (int i = 0; i < MAX_NBR_LOG_APPENDER; ++i) {
+            sink* output = m_sinks[i].load(std::memory_order_acquire);
+            if (output == nullptr) {
+                continue;
+            }
+
+            if (captured) {
+                const level capture_level = m_capture_levels[i].load(std::memory_order_relaxed);
+                for (const record& rec : records) {
+                    if (rec.backtrace || rec.lvl >= log_level || rec.lvl >= capture_level) {
+                        output->write(rec);
+                    }
+                }
+            } else if (records.size() == 1) {
+                output->write(records[0]);
+            } else {
+                output->write(records);
+            }
+
+            if (measured) {
+                const uint64_t now = steady_clock_ns();
+                m_metrics.count_latency(static_cast<size_t>(i), now - start);
+                start = now;
+            }
+        }
+    }
+
+    void logger::flush_sinks() {
+        for (int i = 0; i < MAX_NBR_LOG_APPENDER; ++i) {
+            sink* output = m_sinks[i].load(std::memory_order_acquire);
+            if (output != nullptr) {
+                output->flush();
+            }
+        }
+    }
+
+    void logger::poll_sinks() {
+        for (int i = 0; i < MAX_NBR_LOG_APPENDER; ++i) {
+            sink* output = m_sinks[i].load(std::memory_order_acquire);
+            if (output != nullptr) {
+                output->poll();
+            }
+        }
+    }
+
+    bool logger::start_async(async_slot *slots, size_t nbr_slots, async_overflow overflow) {
+        if (m_async.load(std::memory_order_acquire) || !m_ring.init(slots, nbr_slots)) {
+            return false;
+        }
+
+        m_overflow = overflow;
+        m_worker_stop = false;
+        m_flush_target = 0;
+        m_flushed = 0;
+        m_async.store(true, std::memory_order_release);
+        m_worker = std::thread(&logger::async_run, this);
+
+        return true;
+    }
+
+    void logger::push_async(const record &rec, uint64_t tick, size_t timestamp_len) {
+        while (!m_ring.try_push(rec, tick, timestamp_len)) {
+            if (m_overflow == async_overflow::drop) {
+                m_async_dropped.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+            /* Ring full, make sure the worker is running and let it catch up */
+            m_worker_cv.notify_one();
+            std::this_thread::yield();
+        }
+
+        /* Only wake the worker when it is sleeping. Taking the lock guarantees the worker is
+         * either before its emptiness check or already waiting, so the wake up is never lost */
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (m_worker_idle.load(std::memory_order_seq_cst)) {
+            { std::lock_guard<std::mutex> lock(m_worker_mutex); }
+            m_worker_cv.notify_one();
+        }
+    }
+
+    void logger::async_run() {
+        record batch[ASYNC_BATCH_SIZE];
+
+        for (;;) {
+            /* Collect the ready records, they stay in the ring until the sinks are done */
+            size_t count = 0;
+            async_slot* slot;
+            while (count < ASYNC_BATCH_SIZE && (slot = m_ring.peek(count)) != nullptr) {
+                /* Deferred timestamps are rendered here, in the room left after the new line */
+                if (slot->timestamp_len != 0) {
+                    render_timestamp(&slot->data[timestamp_pos()], slot->tick, slot->timestamp_len);
+                }
+                batch[count] = {slot->data, slot->size, slot->lvl, slot->backtrace, slot->site};
+                count += 1;
+            }
+
+            if (count > 0) {
+                dispatch(span<const record>(batch, count));
+                m_ring.release(count);
+            }
+
+            std::unique_lock<std::mutex> lock(m_worker_mutex);
+
+            /* Serve the pending flush requests once everything they wait for is written */
+            if (m_flush_target > m_flushed && m_ring.consumed() >= m_flush_target) {
+                lock.unlock();
+                flush_sinks();
+                lock.lock();
+                m_flushed = m_ring.consumed();
+                m_flush_cv.notify_all();
+            }
+
+            if (count > 0) {
+                continue;
+            }
+
+            /* Only stop when every claimed slot was written */
+            if (m_worker_stop && m_ring.consumed() == m_ring.pushed()) {
                 break;
             }
+
+            /* Idle, at least every 10 ms: the time based work of the sinks */
+            lock.unlock();
+            poll_sinks();
+            lock.lock();
+
+            m_worker_idle.store(true, std::memory_order_seq_cst);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            m_worker_cv.wait_for(lock, std::chrono::milliseconds(10), [this]() {
+                return m_worker_stop ||
+                       m_ring.peek(0) != nullptr ||
+                       (m_flush_target > m_flushed && m_ring.consumed() >= m_flush_target);
+            });
+            m_worker_idle.store(false, std::memory_order_relaxed);
         }
 
-        return m_print_level_str;
+        flush_sinks();
+    }
+
+    void logger::poll() {
+        poll_sinks();
     }
 
-    const char *logger::get_print_logger_name() {
+    void logger::flush() {
+        report_repeats();
 
-        std::memset(m_print_logger_name, 0, sizeof(m_print_logger_name));
+        if (!m_async.load(std::memory_order_acquire)) {
+            flush_sinks();
+            return;
+        }
 
-        std::snprintf(m_print_logger_name, sizeof(m_print_logger_name), "[%s]", m_logger_name);
+        std::unique_lock<std::mutex> lock(m_worker_mutex);
+        const size_t target = m_ring.pushed();
 
-        return m_print_logger_name;
+        if (target > m_flush_target) {
+            m_flush_target = target;
+        }
+        m_worker_cv.notify_one();
+
+        /* Also stop waiting when the worker is stopping, it writes everything before leaving */
+        while (m_flushed < target && !m_worker_stop) {
+            m_flush_cv.wait_for(lock, std::chrono::milliseconds(10));
+        }
+    }
+
+    void logger::shutdown() {
+        if (!m_async.load(std::memory_order_acquire)) {
+            return;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_worker_mutex);
+            m_worker_stop = true;
+        }
+        m_worker_cv.notify_one();
+        m_flush_cv.notify_all();
+        m_worker.join();
+
+        m_async.store(false, std::memory_order_release);
+    }
+
+    size_t logger::get_async_dropped() const {
+        return m_async_dropped.load(std::memory_order_relaxed);
+    }
+
+    void logger::set_metrics(bool enabled) {
+        m_metrics.set_enabled(enabled);
     }
 
-    void logger::log_write(level level, const char *msg) {
+    metrics_snapshot logger::get_metrics() const {
+        metrics_snapshot snapshot = {};
+        m_metrics.snapshot(snapshot);
+        snapshot.async_dropped = m_async_dropped.load(std::memory_order_relaxed);
+        return snapshot;
+    }
+
+    logger::line logger::log(logger::level log_level, const char *msg) {
 
-        /* check the log level */
-        if(m_level == level::disabled || 
-           level == level::disabled ||
-           level < m_level) {
+        /* check the log level before doing any work */
+        if (!is_enabled(log_level)) {
+            return line(nullptr, log_level, std::string_view());
+        }
+
+        return line(this, log_level, std::string_view(msg != nullptr ? msg : ""));
+    }
+
+    logger::line logger::log(logger::level log_level, const std::string &msg) {
+
+        /* check the log level before doing any work */
+        if (!is_enabled(log_level)) {
+            return line(nullptr, log_level, std::string_view());
+        }
+
+        return line(this, log_level, std::string_view(msg));
+    }
+
+    logger::line logger::log(logger::level log_level, const std::string_view &msg) {
+
+        /* check the log level before doing any work */
+        if (!is_enabled(log_level)) {
+            return line(nullptr, log_level, std::string_view());
+        }
+
+        return line(this, log_level, msg);
+    }
+
+    logger::line logger::log(const call_site& site, const char *msg) {
+
+        /* check the log level before doing any work */
+        if (!is_enabled(site.lvl)) {
+            return line(nullptr, site.lvl, std::string_view());
+        }
+
+        return line(this, site.lvl, std::string_view(msg != nullptr ? msg : ""), &site);
+    }
+
+    logger::line logger::log(const call_site& site, const std::string &msg) {
+
+        /* check the log level before doing any work */
+        if (!is_enabled(site.lvl)) {
+            return line(nullptr, site.lvl, std::string_view());
+        }
+
+        return line(this, site.lvl, std::string_view(msg), &site);
+    }
+
+    logger::line logger::log(const call_site& site, const std::string_view &msg) {
+
+        /* check the log level before doing any work */
+        if (!is_enabled(site.lvl)) {
+            return line(nullptr, site.lvl, std::string_view());
+        }
+
+        return line(this, site.lvl, msg, &site);
+    }
+
+    logger::line::line(logger* owner, level log_level, const std::string_view& msg, const call_site* site) :
+    m_logger(owner),
+    m_site(site),
+    m_level(log_level),
+    m_raw(owner != nullptr && log_level < owner->m_format_level.load(std::memory_order_relaxed)),
+    m_backtrace(false),
+    m_summary(false),
+    m_json(owner != nullptr && owner->m_layout == layout::json),
+    m_sanitize(owner != nullptr && owner->m_sanitize),
+    m_open_quote(false),
+    m_part(part::message),
+    m_radix(radix::dec),
+    m_width(0),
+    m_fill(' '),
+    m_uppercase(true),
+    m_float_format(float_format::shortest),
+    m_precision(6),
+    m_tick(0),
+    m_timestamp_len(0),
+    m_provider_time_len(0),
+    m_suppressed(0),
+    m_size(0) {
+
+        /* Filtered records have no owner, nothing is formatted for them */
+        if (m_raw) {
+            m_logger->write_raw_time(*this);
+            append_text(msg.data(), msg.size());
+        } else if (m_logger != nullptr) {
+            m_logger->write_prefix(*this);
+            append_text(msg.data(), msg.size());
+        }
+    }
+
+    logger::line::~line() {
+        if (m_logger != nullptr) {
+            if (m_suppressed != 0 && m_json) {
+                kv("suppressed", m_suppressed);
+            } else if (m_suppressed != 0) {
+                /* The count is always decimal, whatever the state left by the << operands */
+                const fmt::int_spec spec = {10, 0, ' ', true};
+                char field[fmt::max_integer_len];
+                append(" [", 2);
+                append(field, fmt::write_integer(field, m_suppressed, spec));
+                append(" suppressed]", 12);
+            }
+            if (m_json && !m_raw) {
+                /* The room of the closing characters was kept */
+                if (m_open_quote) {
+                    m_open_quote = false;
+                    append("\"", 1);
+                }
+                m_data[m_size] = '}';
+                m_size += 1;
+            }
+            m_logger->commit(*this);
+        }
+    }
+
+    void logger::line::append(const char *data, size_t size) {
+        if (m_raw) {
+            append_raw_text(data, size);
             return;
         }
 
-        for (int i = 0; i < MAX_NBR_LOG_APPENDER; ++i) {
-            if (m_appenders[i] != nullptr) {
-                m_appenders[i](msg);
+        /* Keep one byte for the null terminator, the excess is trimmed */
+        if (size > room()) {
+            size = room();
+        }
+
+        std::memcpy(&m_data[m_size], data, size);
+        m_size += size;
+    }
+
+    void logger::line::append_text(const char *data, size_t size) {
+        if (m_part == part::done) {
+            return;
+        }
+
+        if (m_raw) {
+            append_raw_text(data, size);
+        } else if (m_json) {
+            m_size += fmt::write_json_escaped(&m_data[m_size], room(), data, size);
+        } else if (m_sanitize) {
+            m_size += fmt::write_sanitized(&m_data[m_size], room(), data, size);
+        } else {
+            append(data, size);
+        }
+    }
+
+    bool logger::line::begin_field(std::string_view key, bool quoted, size_t value_len) {
+        /* Replayed records start the next field without ending the previous one */
+        end_field();
+        m_part = part::done;
+
+        if (key.size() > UINT8_MAX) {
+            key = key.substr(0, UINT8_MAX);
+        }
+
+        if (m_raw) {
+            if (room() < 3 + key.size()) {
+                return false;
+            }
+            m_data[m_size] = raw::field;
+            m_data[m_size + 1] = quoted ? 1 : 0;
+            m_data[m_size + 2] = static_cast<char>(key.size());
+            std::memcpy(&m_data[m_size + 3], key.data(), key.size());
+            m_size += 3 + key.size();
+        } else if (m_json) {
+            /* "msg":"text","key":"value" the closing quote of the value is kept with the brace */
+            const size_t len = (m_open_quote ? 1 : 0) + 4 + key.size() + (quoted ? 2 : 0) + value_len;
+            if (room() + (m_open_quote ? 1 : 0) < len) {
+                return false;
+            }
+            if (m_open_quote) {
+                m_open_quote = false;
+                append("\"", 1);
+            }
+            append(",\"", 2);
+            append(key.data(), key.size());
+            append("\":", 2);
+            if (quoted) {
+                append("\"", 1);
+                m_open_quote = true;
             }
+        } else {
+            if (room() < 2 + key.size() + value_len) {
+                return false;
+            }
+            append(" ", 1);
+            append(key.data(), key.size());
+            append("=", 1);
         }
+
+        m_part = part::field;
+        return true;
     }
 
-    logger &logger::log(logger::level log_level, const char *msg) {
+    void logger::line::end_field() {
+        if (m_part != part::field) {
+            return;
+        }
 
-        log_write(log_level, "\n");
-        log_write(log_level, get_print_timestamp());
-        log_write(log_level, get_print_level_str(log_level));
-        log_write(log_level, get_print_logger_name());
-        log_write(log_level, " ");
-        log_write(log_level, msg);
+        m_part = part::done;
+        if (m_open_quote) {
+            m_open_quote = false;
+            append("\"", 1);
+        }
+    }
 
-        m_last_log_level = log_level;
+    void logger::line::append_raw_text(const char *data, size_t size) {
+        /* Keep one byte for the null terminator, the excess is trimmed */
+        const size_t room = this->room();
+
+        if (room <= 1 + sizeof(uint16_t)) {
+            return;
+        }
+        if (size > room - 1 - sizeof(uint16_t)) {
+            size = room - 1 - sizeof(uint16_t);
+        }
+
+        const uint16_t len = static_cast<uint16_t>(size);
+        m_data[m_size] = raw::text;
+        std::memcpy(&m_data[m_size + 1], &len, sizeof(len));
+        std::memcpy(&m_data[m_size + 1 + sizeof(len)], data, size);
+        m_size += 1 + sizeof(len) + size;
+    }
+
+    template <typename Spec, typename T>
+    void logger::line::append_raw(char tag, const Spec& spec, T value) {
+        /* Values that don't fit are dropped, like the formatted ones would be trimmed */
+        if (room() < 1 + sizeof(spec) + sizeof(value)) {
+            return;
+        }
+
+        m_data[m_size] = tag;
+        std::memcpy(&m_data[m_size + 1], &spec, sizeof(spec));
+        std::memcpy(&m_data[m_size + 1 + sizeof(spec)], &value, sizeof(value));
+        m_size += 1 + sizeof(spec) + sizeof(value);
+    }
+
+    template <typename T>
+    void logger::line::append_integer(T value) {
+        const fmt::int_spec spec = {static_cast<uint8_t>(m_radix), m_width, m_fill, m_uppercase};
+        m_width = 0;
+
+        if (m_part == part::done) {
+            return;
+        }
+        if (m_raw) {
+            append_raw(std::is_signed<T>::value ? raw::int64 : raw::uint64, spec, value);
+            return;
+        }
+
+        /* Render straight into the record, unless it is almost full */
+        if (room() >= fmt::max_integer_len) {
+            m_size += fmt::write_integer(&m_data[m_size], value, spec);
+        } else {
+            char field[fmt::max_integer_len];
+            append(field, fmt::write_integer(field, value, spec));
+        }
+    }
+
+    template void logger::line::append_integer<int64_t>(int64_t value);
+    template void logger::line::append_integer<uint64_t>(uint64_t value);
+
+    template <typename T>
+    void logger::line::append_float(T value) {
+        const fmt::float_spec spec = {m_float_format, m_precision, m_width, m_fill};
+        m_width = 0;
+
+        if (m_part == part::done) {
+            return;
+        }
+        if (m_raw) {
+            append_raw(std::is_same<T, float>::value ? raw::float32 : raw::float64, spec, value);
+            return;
+        }
+
+        /* Render straight into the record, unless it is almost full */
+        if (room() >= fmt::max_float_len) {
+            m_size += fmt::write_float(&m_data[m_size], value, spec);
+        } else {
+            char field[fmt::max_float_len];
+            append(field, fmt::write_float(field, value, spec));
+        }
+    }
+
+    template void logger::line::append_float<float>(float value);
+    template void logger::line::append_float<double>(double value);
+
+    template <typename T>
+    void logger::line::append_field(std::string_view key, T value) {
+        char field[fmt::max_integer_len > fmt::max_float_len ? fmt::max_integer_len : fmt::max_float_len];
+        size_t len;
+
+        /* Fields are always decimal and never padded, the format of the line is kept */
+        if constexpr (std::is_integral<T>::value) {
+            const fmt::int_spec spec = {10, 0, ' ', true};
+            if (m_raw) {
+                if (begin_field(key, false, 0)) {
+                    append_raw(std::is_signed<T>::value ? raw::int64 : raw::uint64, spec, value);
+                }
+                return;
+            }
+            len = fmt::write_integer(field, value, spec);
+            if (begin_field(key, false, len)) {
+                append(field, len);
+            }
+        } else {
+            /* nan and inf are not JSON numbers, they are quoted */
+            const bool quoted = !std::isfinite(value);
+            const fmt::float_spec spec = {m_float_format, m_precision, 0, ' '};
+            if (m_raw) {
+                if (begin_field(key, quoted, 0)) {
+                    append_raw(std::is_same<T, float>::value ? raw::float32 : raw::float64, spec, value);
+                }
+                return;
+            }
+            len = fmt::write_float(field, value, spec);
+            if (begin_field(key, quoted, len)) {
+                append(field, len);
+            }
+        }
+    }
+
+    template void logger::line::append_field<int64_t>(std::string_view key, int64_t value);
+    template void logger::line::append_field<uint64_t>(std::string_view key, uint64_t value);
+    template void logger::line::append_field<float>(std::string_view key, float value);
+    template void logger::line::append_field<double>(std::string_view key, double value);
+
+    logger::line &logger::line::operator<<(const char *msg) {
+
+        if (m_logger == nullptr || msg == nullptr) {
+            return *this;
+        }
+
+        append_text(msg, std::strlen(msg));
 
         return *this;
     }
 
-    logger &logger::log(logger::level log_level, const std::string &msg) {
+    logger::line &logger::line::operator<<(const std::string &msg) {
+
+        if (m_logger == nullptr) {
+            return *this;
+        }
 
-        log(log_level, msg.c_str());
+        append_text(msg.data(), msg.size());
 
         return *this;
     }
 
-    logger &logger::log(logger::level log_level, const std::string_view &msg) {
+    logger::line &logger::line::operator<<(const std::string_view &msg) {
 
-        log(log_level, msg.data());
+        if (m_logger == nullptr) {
+            return *this;
+        }
+
+        append_text(msg.data(), msg.size());
 
         return *this;
     }
 
-    logger &logger::operator<<(const char *msg) {
+    logger::line &logger::line::operator<<(std::chrono::seconds time) {
 
-        log_write(m_last_log_level, msg);
+        if (m_logger == nullptr) {
+            return *this;
+        }
+
+        /* Durations are always decimal, the radix of the line is kept */
+        const radix rdx = m_radix;
+        m_radix = radix::dec;
+        append_integer(static_cast<int64_t>(time.count()));
+        m_radix = rdx;
+        append_text("s", 1);
 
         return *this;
     }
 
-    logger &logger::operator<<(const std::string &msg) {
+    logger::line &logger::line::operator<<(std::chrono::milliseconds time) {
 
-            log_write(m_last_log_level, msg.c_str());
+        if (m_logger == nullptr) {
+            return *this;
+        }
+
+        /* Durations are always decimal, the radix of the line is kept */
+        const radix rdx = m_radix;
+        m_radix = radix::dec;
+        append_integer(static_cast<int64_t>(time.count()));
+        m_radix = rdx;
+        append_text("ms", 2);
 
+        return *this;
+    }
+
+    logger::line &logger::line::operator<<(std::chrono::microseconds time) {
+
+        if (m_logger == nullptr) {
             return *this;
+        }
+
+        /* Durations are always decimal, the radix of the line is kept */
+        const radix rdx = m_radix;
+        m_radix = radix::dec;
+        append_integer(static_cast<int64_t>(time.count()));
+        m_radix = rdx;
+        append_text("us", 2);
+
+        return *this;
     }
 
-    logger &logger::operator<<(const std::string_view &msg) {
+    logger::line &logger::line::operator<<(logger::radix rdx) {
 
-            log_write(m_last_log_level, msg.data());
+        m_radix = rdx;
 
-            return *this;
+        return *this;
     }
 
-    logger &logger::operator<<(std::chrono::seconds time) {
+    logger::line &logger::line::operator<<(logger::setw width) {
 
-        operator<<(radix::dec);
-        operator<<(time.count());
-        operator<<("s");
+        m_width = width.width;
 
         return *this;
     }
 
-    logger &logger::operator<<(std::chrono::milliseconds time) {
+    logger::line &logger::line::operator<<(logger::setfill fill) {
 
-        operator<<(radix::dec);
-        operator<<(time.count());
-        operator<<("ms");
+        m_fill = fill.fill;
 
         return *this;
     }
 
-    logger &logger::operator<<(std::chrono::microseconds time) {
+    logger::line &logger::line::operator<<(logger::letter_case lettercase) {
 
-        operator<<(radix::dec);
-        operator<<(time.count());
-        operator<<("us");
+        m_uppercase = lettercase == letter_case::upper;
 
         return *this;
     }
 
-    logger &logger::operator<<(logger::radix rdx) {
+    logger::line &logger::line::operator<<(logger::float_format format) {
 
-        m_radix = rdx;
+        m_float_format = format;
+
+        return *this;
+    }
+
+    logger::line &logger::line::operator<<(logger::setprecision precision) {
+
+        m_precision = precision.precision;
 
         return *this;
     }
 
 
-} // slog
\ No newline at end of file
+} // slog
@@ -8,10 +8,22 @@
 #include <string>
 #include <cstring>
 #include <string_view>
-#include <functional>
 #include <chrono>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <tuple>
+#include <utility>
 
 #include "timedate.h"
+#include "record.h"
+#include "sink.h"
+#include "async_ring.h"
+#include "tick.h"
+#include "format.h"
+#include "rate_limit.h"
+#include "metrics.h"
 
 namespace slog {
 
@@ -19,19 +31,62 @@ namespace slog {
 #define  MAX_LOG_NAME_LEN 21 /* Max name lengh including null terminator */
 #endif
 
-#ifndef MAX_NBR_LOG_APPENDER
-#define MAX_NBR_LOG_APPENDER 3
+#ifndef ASYNC_BATCH_SIZE
+#define ASYNC_BATCH_SIZE 16 /* Max number of records handed to the sinks in one batch */
 #endif
 
+    /**
+     * @brief Storage for one record of the backtrace buffer, provided by the user (usually a
+     *        static array) so the buffer never allocates. The record is kept unformatted.
+     */
+    struct backtrace_slot {
+        std::atomic<size_t> sequence; /* position + 1 of the record held, busy while written */
+        level lvl;
+        size_t size;
+        char data[MAX_LOG_RECORD_LEN];
+    };
 
     class logger {
     public:
         /* log level enumeration */
-        enum class level {trace=0, debug, info, warn, error, fatal, disabled};
+        using level = slog::level;
 
         /* radix enumeration */
         enum class radix {bin=2, oct=8, dec=10, hex=16};
 
+        /* minimum width of the next integer, padded with the fill character */
+        struct setw {
+            explicit constexpr setw(uint8_t field_width) : width(field_width) {}
+            uint8_t width;
+        };
+
+        /* padding character of the integers, '0' pads after the sign and the radix prefix */
+        struct setfill {
+            explicit constexpr setfill(char fill_char) : fill(fill_char) {}
+            char fill;
+        };
+
+        /* letter case of the hexadecimal digits */
+        enum class letter_case {upper, lower};
+
+        /* floating point format: shortest, fixed or scientific */
+        using float_format = fmt::float_format;
+
+        /* digits after the decimal point of the fixed and scientific formats */
+        struct setprecision {
+            explicit constexpr setprecision(uint8_t float_precision) : precision(float_precision) {}
+            uint8_t precision;
+        };
+
+        /* record under construction, returned by log() */
+        class line;
+
+        /* what producers do when the asynchronous ring is full */
+        enum class async_overflow {block, drop};
+
+        /* record layout: [time][LEVEL][name] message key=value, or one JSON object per record */
+        enum class layout {text, json};
+
         /* default constructor */
         explicit logger(const char* logger_name);
         /* default destructor */
@@ -60,23 +115,79 @@ namespace slog {
          */
         void set_Level(level log_level);
 
+        /**
+         * @brief Check if a record with the given level would be logged. This is the only
+         *        work done for filtered records, the SLOG_* macros use it to skip the whole
+         *        call, including the evaluation of the message arguments.
+         *        Sinks added with a capture level and the backtrace level lower the gate.
+         *        The filtered calls are counted when the metrics are enabled (see set_metrics()).
+         * @param log_level, level of the record
+         * @return true if the record would be logged, false otherwise
+         */
+        bool is_enabled(level log_level) const {
+            if (log_level >= m_gate_level.load(std::memory_order_relaxed) && log_level != level::disabled) {
+                return true;
+            }
+            if (m_metrics.enabled()) {
+                m_metrics.count_filtered(log_level);
+            }
+            return false;
+        }
+
         /**
          * @brief Add appender to logger, appenders are functions written by user to handle log
          *        messages produced by the logger. Usually appenders are used to write log messages
          *        to the console or to a file.
-         * @param appender, function pointer to appender which will be called when log is written
+         *        The appender is called once per record with the complete formatted line.
+         *        It is stored inline, without allocation (see slog::delegate).
+         * @param appender, function pointer or lambda which will be called when log is written
          * @return true if appender is added successfully, false otherwise
          */
-        bool add_appender(std::function<void(const char*)> appender);
+        bool add_appender(appender_fn appender);
+
+        /**
+         * @brief Add a sink to the logger. Sinks receive each record once, as a buffer carrying
+         *        its own length. Sinks and appenders share the same MAX_NBR_LOG_APPENDER slots.
+         *        The sink is NOT owned by the logger and must outlive it. In synchronous mode the
+         *        sinks are called from every logging thread so they must be thread safe.
+         * @param output, sink which will be called when log is written
+         * @return true if sink is added successfully, false otherwise
+         */
+        bool add_sink(sink& output);
+
+        /**
+         * @brief Add a sink that also receives the records below the logger level, down to its
+         *        capture level (like a flight recorder keeping the debug records). The other
+         *        sinks and appenders still only receive the records allowed by the logger level.
+         *        Records at or above the capture level are built even when only this sink
+         *        wants them.
+         * @param output, sink which will be called when log is written
+         * @param capture_level, lowest level delivered to this sink
+         * @return true if sink is added successfully, false otherwise
+         */
+        bool add_sink(sink& output, level capture_level);
 
         /**
          * @brief Set time provider, time provider is a function written by user to provide the
          *        current time when log is written. This is useful when you want to use a custom
          *        time provider, for example when you want to use a real time clock or a time
-         *        server to provide the time.
+         *        server to provide the time. It must be set before the logger is shared
+         *        between threads.
          * @param time_provider, function pointer to time provider
          */
-        void set_time_provider(std::function<timedate()> time_provider);
+        void set_time_provider(time_provider_fn time_provider);
+
+        /**
+         * @brief Set a raw time source instead of the time provider. The source only returns a
+         *        tick count (e.g. slog::system_clock_ns or a hardware counter), the conversion
+         *        to calendar fields is done by the logger once per second and, in asynchronous
+         *        mode, by the worker thread. Replaces the time provider, it must be set before
+         *        the logger is shared between threads.
+         * @param source, tick source, ticks counted since the Unix epoch (UTC). A counter
+         *        starting at 0 is printed as the time elapsed since 1970/01/01 00:00:00
+         * @param ticks_per_second, tick frequency, must not be 0
+         */
+        void set_tick_source(tick_source source, uint64_t ticks_per_second);
 
         /**
          * @brief Set the print date flag, when this flag is set to true the logger will print the
@@ -89,125 +200,658 @@ namespace slog {
          * @brief Get the print date flag
          * @return bool, true if the date is printed, false otherwise
          */
-        bool get_print_date();
+        bool get_print_date() const;
 
-        logger& log(level log_level, const char* msg);
+        /**
+         * @brief Print the call site of the records logged through the SLOG_<LEVEL> makros:
+         *        [WARN ][logger_name][net.cpp:42] in the text layout, "file", "line" and "func"
+         *        members in the json layout. The call site is described at compile time, nothing
+         *        is passed per call but its address.
+         * @param print_source, true to print the call site, false otherwise (default)
+         */
+        void set_print_source(bool print_source);
 
-        logger& log(level log_level, const std::string& msg);
+        /**
+         * @brief Set the record layout. The text layout (default) writes the fields as
+         *        " key=value" after the message. The json layout writes each record as a single
+         *        line JSON object: {"time":"23:12:35.123","level":"INFO","logger":"name",
+         *        "msg":"message","key":value}, the time only when there is a time source.
+         *        The message and the string values are escaped, the logger name and the field
+         *        keys are written as they are. It must be set before the logger is shared
+         *        between threads.
+         * @param record_layout, layout of the records
+         */
+        void set_layout(layout record_layout);
 
-        logger& log(level log_level, const std::string_view& msg);
+        /**
+         * @brief Escape the control characters of the message and of the string values in the
+         *        text layout (the json layout always escapes them), so a user supplied string
+         *        can't start a new record or inject terminal sequences. They are written \n, \r,
+         *        \t or \xHH, the other bytes are kept. Clean strings are scanned 16 or 32 bytes at
+         *        a time (SSE2/AVX2) and copied in one piece. Off by default, it must be set before
+         *        the logger is shared between threads.
+         * @param sanitize, true to escape the control characters, false otherwise
+         */
+        void set_sanitize(bool sanitize);
 
-        logger& operator<<(const char* msg);
+        /**
+         * @brief Suppress the consecutive identical records. Records are compared without their
+         *        timestamp, when a different record arrives, the window expires or the logger is
+         *        flushed a single "last message repeated N times" record is written instead of
+         *        the suppressed ones. The count is exact for a single thread, concurrent
+         *        duplicates may be reported in the next summary.
+         * @param window, longest run of duplicates suppressed before a summary is written,
+         *        0 disables the deduplication (default)
+         */
+        void set_dedup_window(std::chrono::milliseconds window);
 
-        logger& operator<<(const std::string& msg);
+        /**
+         * @brief Start a new log record. The record is built in the returned line and handed
+         *        to the sinks, in one piece, when the line goes out of scope (usually at the end
+         *        of the statement), so it can be completed with the << operator.
+         * @param log_level, level of the record
+         * @param msg, message
+         * @return line, the record under construction
+         */
+        line log(level log_level, const char* msg);
 
-        logger& operator<<(const std::string_view& msg);
+        line log(level log_level, const std::string& msg);
 
-        logger& operator<<(std::chrono::seconds time);
+        line log(level log_level, const std::string_view& msg);
 
-        logger& operator<<(std::chrono::milliseconds time);
+        /**
+         * @brief Start a new log record from a call site, usually called through the SLOG_<LEVEL>
+         *        makros. The level is the one of the call site, which is handed to the sinks with
+         *        the record (record::site).
+         * @param site, static call site description, see SLOG_CALL_SITE
+         * @param msg, message
+         * @return line, the record under construction
+         */
+        line log(const call_site& site, const char* msg);
 
-        logger& operator<<(std::chrono::microseconds time);
+        line log(const call_site& site, const std::string& msg);
 
-        logger& operator<<(radix rdx);
+        line log(const call_site& site, const std::string_view& msg);
 
-        template <typename T, std::enable_if_t<std::is_integral<T>::value, bool> = true>
-        logger& operator<<(T value) {
-            const char* const digits = "0123456789ABCDEF";
-            const unsigned int radix = static_cast<unsigned int>(m_radix);
-            static constexpr size_t MaxFieldWidth = 34;
-            char fielddata[MaxFieldWidth];
-            size_t fieldindex = 0;
-
-            int first = 0;
-            switch (m_radix)
-            {
-                default:
-                    /* intentional fall through */
-                case radix::dec:
-                    break;
-                case radix::bin:
-                    fielddata[0] = '0';
-                    fielddata[1] = 'b';
-                    fieldindex += 2;
-                    first += 2;
-                    break;
-                case radix::oct:
-                    fielddata[0] = '0';
-                    fielddata[1] = 'o';
-                    fieldindex += 2;
-                    first += 2;
-                    break;
-                case radix::hex:
-                    fielddata[0] = '0';
-                    fielddata[1] = 'x';
-                    fieldindex += 2;
-                    first += 2;
-                    break;
+        /**
+         * @brief Write a record from a format string, usually called through the SLOG_LOGF makro.
+         *        The format string is parsed and checked against the arguments at compile time,
+         *        a wrong number of arguments or a placeholder type that does not match its
+         *        argument fails the build. The record is rendered in a single pass.
+         * @param log_level, level of the record
+         * @param format_string, format string wrapped by SLOG_FMT("..."), see fmt::format_piece
+         * @param args, arguments, any type accepted by the << operator
+         */
+        template <typename S, typename... Args>
+        void logf(level log_level, S format_string, const Args&... args);
+
+        /**
+         * @brief Switch the logger to asynchronous mode. Finished records are copied into a
+         *        lock-free ring and a dedicated worker thread hands them to the appenders and
+         *        sinks, so slow outputs don't stall the logging threads.
+         *        The ring uses the given storage and never allocates, the only allocation is the
+         *        worker thread creation done here. Appenders, sinks and time provider must be
+         *        set before calling this function.
+         * @param slots, ring storage, must live until shutdown() (usually a static array)
+         * @param nbr_slots, number of slots, must be a power of two
+         * @param overflow, block the producer until there is room (default) or drop the record
+         *        when the ring is full
+         * @return true if the asynchronous mode was started, false if it was already running or
+         *         the storage is not valid
+         */
+        bool start_async(async_slot* slots, size_t nbr_slots, async_overflow overflow = async_overflow::block);
+
+        /**
+         * @brief Wait until every record logged before this call has been written by the sinks
+         *        and flush them. In synchronous mode it only flushes the sinks.
+         */
+        void flush();
+
+        /**
+         * @brief Let the sinks do their time based work (see sink::poll()), like flushing the
+         *        records buffered longer than their flush interval. The asynchronous worker polls
+         *        the sinks about every 10 ms; in synchronous mode the application calls this
+         *        function from time to time, e.g. from its main loop.
+         */
+        void poll();
+
+        /**
+         * @brief Stop the asynchronous mode, all the queued records are written before the worker
+         *        thread ends and the logger goes back to synchronous mode. It must not run
+         *        concurrently with logging calls. Called by the destructor, so no record is lost.
+         */
+        void shutdown();
+
+        /**
+         * @brief Get the number of records dropped because the ring was full (drop overflow only)
+         * @return size_t, number of dropped records
+         */
+        size_t get_async_dropped() const;
+
+        /**
+         * @brief Collect the logger metrics: records and bytes handed to the sinks and filtered
+         *        calls per level, and a latency histogram of each appender and sink slot (one
+         *        entry per call, a whole batch in asynchronous mode). The counters are relaxed
+         *        atomics in per thread shards; timing the sinks reads the steady clock once per
+         *        slot and record (or batch). Disabled by default, a disabled logger only pays one
+         *        relaxed load per filtered call. Removed from the build with SLOG_NO_METRICS
+         *        (cmake -DSLOG_METRICS=OFF).
+         * @param enabled, true to collect the metrics, false otherwise (default)
+         */
+        void set_metrics(bool enabled);
+
+        /**
+         * @brief Get the logger metrics, see set_metrics(). A snapshot taken while logging may
+         *        miss the records in flight.
+         * @return metrics_snapshot, copy of the counters
+         */
+        metrics_snapshot get_metrics() const;
+
+        /**
+         * @brief Keep the records below the logger level, down to the backtrace level, in a
+         *        bounded buffer instead of dropping them. They are stored unformatted (raw
+         *        arguments and time) and only formatted, and handed to every appender and sink,
+         *        when a record at or above the trigger level is logged, right before it. The
+         *        oldest records are overwritten when the buffer is full.
+         *        Must be called before the logger is shared between threads.
+         * @param slots, buffer storage, must outlive the logger (usually a static array)
+         * @param nbr_slots, number of records kept, must be a power of two
+         * @param backtrace_level, lowest level kept
+         * @param trigger_level, lowest level that replays the buffer
+         * @return true if the backtrace was enabled, false if it already was or the storage is
+         *         not valid
+         */
+        bool enable_backtrace(backtrace_slot* slots, size_t nbr_slots, level backtrace_level = level::debug,
+                              level trigger_level = level::error);
+
+    private:
+        friend class line;
+
+        /* private member functions */
+        void write_prefix(line& ln);
+        void open_record(line& ln, bool timed);
+        void write_timestamp(line& ln, const char* timestamp, size_t len);
+        size_t timestamp_pos() const;
+        void write_level_and_name(line& ln);
+        size_t render_provider_time(char* out);
+        void write_provider_time(line& ln);
+        void write_raw_time(line& ln);
+        void commit(line& ln);
+        void push_backtrace(const line& ln);
+        void replay_backtrace();
+        void replay(level log_level, const char* raw, size_t size);
+        bool is_duplicate(const line& ln);
+        void report_repeats();
+        void dispatch(span<const record> records);
+        void render_timestamp(char* out, uint64_t tick, size_t timestamp_len) const;
+        void flush_sinks();
+        void poll_sinks();
+        void update_gate_level();
+        void push_async(const record& rec, uint64_t tick, size_t timestamp_len);
+        void async_run();
+
+        /* member variables */
+        std::atomic<level> m_level;
+        std::atomic<level> m_gate_level;   /* lowest level accepted, formatted or kept raw */
+        std::atomic<level> m_format_level; /* lowest of the logger level and the capture levels */
+        std::atomic<bool> m_print_date;
+        std::atomic<bool> m_print_source;
+        layout m_layout;
+        bool m_sanitize;
+        time_provider_fn m_time_provider;
+        tick_source m_tick_source;
+        uint64_t m_ticks_per_second;
+        std::atomic<sink*> m_sinks[MAX_NBR_LOG_APPENDER];
+        std::atomic<level> m_capture_levels[MAX_NBR_LOG_APPENDER];
+        appender_sink m_appender_sinks[MAX_NBR_LOG_APPENDER];
+        std::mutex m_config_mutex;
+        char m_logger_name[MAX_LOG_NAME_LEN];
+
+        /* asynchronous mode */
+        std::atomic<bool> m_async;
+        async_overflow m_overflow;
+        async_ring m_ring;
+        std::thread m_worker;
+        std::mutex m_worker_mutex;
+        std::condition_variable m_worker_cv;
+        std::condition_variable m_flush_cv;
+        std::atomic<bool> m_worker_idle;
+        bool m_worker_stop;
+        size_t m_flush_target;
+        size_t m_flushed;
+        std::atomic<size_t> m_async_dropped;
+
+        /* backtrace buffer */
+        std::atomic<level> m_backtrace_level;
+        std::atomic<level> m_trigger_level;
+        backtrace_slot* m_backtrace_slots;
+        size_t m_backtrace_mask;
+        std::atomic<size_t> m_backtrace_head;
+        size_t m_backtrace_tail; /* first record not replayed yet */
+        std::mutex m_backtrace_mutex;
+
+        /* deduplication */
+        std::atomic<uint64_t> m_dedup_window; /* nanoseconds, 0 when disabled */
+        std::atomic<uint64_t> m_dedup_hash;   /* last record written */
+        std::atomic<level> m_dedup_level;
+        std::atomic<uint64_t> m_dedup_repeats;
+        std::atomic<uint64_t> m_dedup_deadline; /* end of the window, 0 before the first duplicate */
+
+        /* metrics, counted by the const is_enabled() too */
+        mutable logger_metrics m_metrics;
+
+    };
+
+    /**
+     * @brief A log record under construction. It owns the record buffer (on the caller stack)
+     *        and all the formatting state, the finished record is delivered to the logger sinks
+     *        when the line is destroyed. Messages longer than MAX_LOG_RECORD_LEN are truncated.
+     */
+    class logger::line {
+    public:
+        /* delivers the record */
+        ~line();
+        /* disable copy constructor */
+        line(const line&) = delete;
+        /* disable copy assignment */
+        line& operator=(const line&) = delete;
+
+        /**
+         * @brief Check if the record is being built, records filtered by level are not
+         * @return true if the record will be delivered to the sinks, false otherwise
+         */
+        bool active() const { return m_logger != nullptr; }
+
+        /**
+         * @brief Report the calls suppressed by a rate limited call site, " [N suppressed]" is
+         *        appended to the record when it is complete. Used by the SLOG_*_EVERY_* and
+         *        SLOG_*_RATE makros.
+         * @param count, number of suppressed calls, 0 appends nothing
+         * @return line&, this line
+         */
+        line& report_suppressed(uint64_t count) {
+            m_suppressed = count;
+            return *this;
+        }
+
+        /**
+         * @brief Add a structured field after the message, for example
+         *        logger.log(level::info, "request done").kv("status", 200).kv("latency", 3ms).
+         *        Written as " key=value" by the text layout and as ,"key":value by the json
+         *        layout, in the same record buffer. Integers are always decimal and bool values
+         *        print as true or false, strings and durations are quoted by the json layout.
+         *        The message ends with the first field, the << operands following a field are
+         *        ignored.
+         * @param key, field name, written as it is
+         * @param value, integral, floating point, string or duration
+         * @return line&, this line
+         */
+        template <typename T>
+        line& kv(std::string_view key, const T& value) {
+            if (m_logger == nullptr) {
+                return *this;
             }
 
-            // calculate digits (they will be reversed)
-            if ( value < 0 )
-            {
-                fielddata[fieldindex] = '-';
-                fieldindex += 1;
+            if constexpr (std::is_same<T, bool>::value) {
+                if (begin_field(key, false, 5)) {
+                    append_text(value ? "true" : "false", value ? 4 : 5);
+                }
+            } else if constexpr (std::is_integral<T>::value) {
+                using wide = std::conditional_t<std::is_signed<T>::value, int64_t, uint64_t>;
+                append_field(key, static_cast<wide>(value));
+            } else if constexpr (std::is_floating_point<T>::value) {
+                using narrow = std::conditional_t<std::is_same<T, float>::value, float, double>;
+                append_field(key, static_cast<narrow>(value));
+            } else if (begin_field(key, true, 0)) {
+                *this << value;
             }
+            end_field();
+
+            return *this;
+        }
+
+        line& operator<<(const char* msg);
+
+        line& operator<<(const std::string& msg);
+
+        line& operator<<(const std::string_view& msg);
+
+        line& operator<<(std::chrono::seconds time);
+
+        line& operator<<(std::chrono::milliseconds time);
+
+        line& operator<<(std::chrono::microseconds time);
+
+        line& operator<<(radix rdx);
 
-            T remainder;
-            do {
-                remainder = value % radix;
-                fielddata[fieldindex] = digits[remainder];
-                value /= radix;
-                fieldindex += 1;
-            } while ( value != 0 );
-
-            // reverse order
-            int last = fieldindex-1;
-            while ( (last-first) > 0 )
-            {
-                char tmp = fielddata[last];
-                fielddata[last] = fielddata[first];
-                fielddata[first] = tmp;
-                first += 1;
-                last -= 1;
+        /* the width applies to the next integer or duration only */
+        line& operator<<(setw width);
+
+        line& operator<<(setfill fill);
+
+        line& operator<<(letter_case lettercase);
+
+        line& operator<<(float_format format);
+
+        line& operator<<(setprecision precision);
+
+        template <typename T, std::enable_if_t<std::is_integral<T>::value, bool> = true>
+        line& operator<<(T value) {
+            if (m_logger == nullptr) {
+                return *this;
             }
 
-            fielddata[fieldindex] = '\0';
+            /* Every integral type is formatted through the 64 bit variant of its signedness */
+            using wide = std::conditional_t<std::is_signed<T>::value, int64_t, uint64_t>;
+            append_integer(static_cast<wide>(value));
 
-            log_write(m_last_log_level, fielddata);
+            return *this;
+        }
+
+        template <typename T, std::enable_if_t<std::is_floating_point<T>::value, bool> = true>
+        line& operator<<(T value) {
+            if (m_logger == nullptr) {
+                return *this;
+            }
+
+            /* float keeps its own shortest digits, long double is printed as double */
+            using narrow = std::conditional_t<std::is_same<T, float>::value, float, double>;
+            append_float(static_cast<narrow>(value));
 
             return *this;
         }
 
     private:
-        /* private member functions */
-        const char* get_print_timestamp();
-        const char* get_print_level_str(level level);
-        const char* get_print_logger_name();
-        void log_write(level level, const char *msg);
+        friend class logger;
+
+        line(logger* owner, level log_level, const std::string_view& msg, const call_site* site = nullptr);
+
+        template <typename P, size_t... I, typename Tuple>
+        void render(std::index_sequence<I...>, const Tuple& args) {
+            (render_piece<P, I>(args), ...);
+        }
+
+        template <typename P, size_t I, typename Tuple>
+        void render_piece(const Tuple& args) {
+            constexpr fmt::format_piece piece = P::pieces.items[I];
+
+            if constexpr (!piece.is_arg) {
+                append_text(&P::text[piece.begin], piece.len);
+            } else {
+                using arg_type = std::decay_t<std::tuple_element_t<piece.arg, Tuple>>;
+                static_assert(fmt::accepts<arg_type>(piece), "format placeholder does not match the argument type");
+
+                /* Each placeholder starts from the default formatting */
+                switch (piece.type) {
+                    case 'b':
+                        m_radix = radix::bin;
+                        break;
+                    case 'o':
+                        m_radix = radix::oct;
+                        break;
+                    case 'x':
+                    case 'X':
+                        m_radix = radix::hex;
+                        break;
+                    default:
+                        m_radix = radix::dec;
+                        break;
+                }
+                m_uppercase = piece.type != 'x';
+                m_width = piece.width;
+                m_fill = piece.fill;
+                if (piece.type == 'e') {
+                    m_float_format = float_format::scientific;
+                } else if (piece.type == 'f' || piece.precision >= 0) {
+                    m_float_format = float_format::fixed;
+                } else {
+                    m_float_format = float_format::shortest;
+                }
+                m_precision = piece.precision >= 0 ? static_cast<uint8_t>(piece.precision) : 6;
+
+                *this << std::get<piece.arg>(args);
+            }
+        }
+
+        /* which part of the record the << operands go to */
+        enum class part : uint8_t {message, field, done};
+
+        /* room left, the json layout keeps the room of its closing characters */
+        size_t room() const {
+            const size_t used = m_size + (m_json && !m_raw ? 1 + m_open_quote : 0);
+            return used < sizeof(m_data) - 1 ? sizeof(m_data) - 1 - used : 0;
+        }
+
+        void append(const char* data, size_t size);
+        /* message and string values, escaped by the json layout and the sanitizer */
+        void append_text(const char* data, size_t size);
+        /* false when the key and value_len characters don't fit, the field is dropped */
+        bool begin_field(std::string_view key, bool quoted, size_t value_len);
+        void end_field();
+        /* numeric field, defined for int64_t, uint64_t, float and double */
+        template <typename T>
+        void append_field(std::string_view key, T value);
+        /* raw items of the records kept by the backtrace buffer */
+        void append_raw_text(const char* data, size_t size);
+        template <typename Spec, typename T>
+        void append_raw(char tag, const Spec& spec, T value);
+        /* defined for int64_t and uint64_t */
+        template <typename T>
+        void append_integer(T value);
+        /* defined for float and double */
+        template <typename T>
+        void append_float(T value);
 
         /* member variables */
+        logger* m_logger;
+        const call_site* m_site;
         level m_level;
-        level m_last_log_level;
+        bool m_raw;       /* below the logger level, kept unformatted for the backtrace */
+        bool m_backtrace; /* replayed from the backtrace buffer */
+        bool m_summary;   /* repeated records summary, never deduplicated */
+        bool m_json;      /* json layout */
+        bool m_sanitize;  /* control characters escaped in the text layout */
+        bool m_open_quote; /* the json message or field value is not closed yet */
+        part m_part;
         radix m_radix;
-        bool m_print_date;
-        std::function<timedate()> m_time_provider;
-        std::function<void(const char*)> m_appenders[MAX_NBR_LOG_APPENDER];
-        char m_logger_name[MAX_LOG_NAME_LEN];
-        char m_print_timestamp[40];
-        char m_print_level_str[10];
-        char m_print_logger_name[MAX_LOG_NAME_LEN+2];
-
+        uint8_t m_width;
+        char m_fill;
+        bool m_uppercase;
+        float_format m_float_format;
+        uint8_t m_precision;
+        uint64_t m_tick;
+        size_t m_timestamp_len;
+        size_t m_provider_time_len; /* room kept for the time provider timestamp, written at commit */
+        uint64_t m_suppressed;
+        size_t m_size;
+        char m_data[MAX_LOG_RECORD_LEN];
     };
 
+    template <typename T, typename = void>
+    struct is_loggable : std::false_type {};
+
+    /* types accepted by the << operator of the log lines */
+    template <typename T>
+    struct is_loggable<T, std::void_t<decltype(std::declval<logger::line&>() << std::declval<const T&>())>> :
+        std::true_type {};
+
+    template <typename S, typename... Args>
+    void logger::logf(level log_level, S, const Args&... args) {
+        using parsed = fmt::parsed_format<S>;
+        static_assert(parsed::info.valid, "malformed format string");
+        static_assert(parsed::info.nbr_args == sizeof...(Args), "number of {} placeholders and arguments differ");
+        static_assert((is_loggable<Args>::value && ...), "argument type not supported by the logger");
+
+        if constexpr (parsed::info.valid && parsed::info.nbr_args == sizeof...(Args)) {
+            if (!is_enabled(log_level)) {
+                return;
+            }
+
+            line record(this, log_level, std::string_view());
+            record.render<parsed>(std::make_index_sequence<parsed::info.nbr_pieces>(), std::forward_as_tuple(args...));
+        }
+    }
+
 } // slog
 
-/* Logging Makros */
-#define SLOG_TRACE(logger, msg) logger.log(slog::logger::level::trace, msg)
-#define SLOG_DEBUG(logger, msg) logger.log(slog::logger::level::debug, msg)
-#define SLOG_INFO(logger, msg) logger.log(slog::logger::level::info, msg)
-#define SLOG_WARN(logger, msg) logger.log(slog::logger::level::warn, msg)
-#define SLOG_ERROR(logger, msg) logger.log(slog::logger::level::error, msg)
-#define SLOG_FATAL(logger, msg) logger.log(slog::logger::level::fatal, msg)
+/* Compile time log levels, they match the slog::logger::level values */
+#define SLOG_LEVEL_TRACE 0
+#define SLOG_LEVEL_DEBUG 1
+#define SLOG_LEVEL_INFO 2
+#define SLOG_LEVEL_WARN 3
+#define SLOG_LEVEL_ERROR 4
+#define SLOG_LEVEL_FATAL 5
+#define SLOG_LEVEL_OFF 6
+
+/* Minimum level compiled in the current translation unit, the SLOG_<LEVEL> makros below this
+ * level compile to nothing. Define it before including this header (or with -DSLOG_ACTIVE_LEVEL=...) */
+#ifndef SLOG_ACTIVE_LEVEL
+#define SLOG_ACTIVE_LEVEL SLOG_LEVEL_TRACE
+#endif
+
+static_assert(SLOG_LEVEL_FATAL == static_cast<int>(slog::logger::level::fatal) &&
+              SLOG_LEVEL_OFF == static_cast<int>(slog::logger::level::disabled),
+              "SLOG_LEVEL_* must match slog::logger::level");
+
+/* Logging Makros
+ * The level is checked before anything else, when the record is filtered neither the message
+ * nor the << operands that follow the makro are evaluated.
+ * The if/else form keeps the makro safe inside unbraced if statements. */
+#define SLOG_LOG(target, log_level, msg) \
+    if (!(target).is_enabled(log_level)) {} else (target).log(log_level, msg)
+
+/* Formatted logging makro, the format string must be a string literal, for example
+ * SLOG_LOGF(logger, slog::logger::level::info, "x={} y={:.2f}", x, y) */
+#define SLOG_LOGF(target, log_level, format_string, ...) \
+    if (!(target).is_enabled(log_level)) {} else (target).logf(log_level, SLOG_FMT(format_string), ##__VA_ARGS__)
+
+/* Rate limited makros, each call site keeps its own static state updated with relaxed atomics.
+ * The level is checked first, then the rate: suppressed calls are counted but not formatted and
+ * the next record of the call site ends with " [N suppressed]".
+ *  EVERY_N  : the first call and then one call out of n
+ *  EVERY_MS : at most one call per interval of ms milliseconds
+ *  RATE     : token bucket of burst records refilled at per_second records per second */
+#define SLOG_LOG_EVERY_N(target, log_level, n, msg) \
+    if (static slog::every_n_site slog_rate_site_; !(target).is_enabled(log_level)) {} \
+    else if (uint64_t slog_suppressed_ = 0; !slog_rate_site_.allow(n, slog_suppressed_)) {} \
+    else (target).log(log_level, msg).report_suppressed(slog_suppressed_)
+
+#define SLOG_LOG_EVERY_MS(target, log_level, ms, msg) \
+    if (static slog::every_ms_site slog_rate_site_; !(target).is_enabled(log_level)) {} \
+    else if (uint64_t slog_suppressed_ = 0; !slog_rate_site_.allow(ms, slog::steady_clock_ns(), slog_suppressed_)) {} \
+    else (target).log(log_level, msg).report_suppressed(slog_suppressed_)
+
+#define SLOG_LOG_RATE(target, log_level, per_second, burst, msg) \
+    if (static slog::token_bucket_site slog_rate_site_; !(target).is_enabled(log_level)) {} \
+    else if (uint64_t slog_suppressed_ = 0; \
+             !slog_rate_site_.allow(per_second, burst, slog::steady_clock_ns(), slog_suppressed_)) {} \
+    else (target).log(log_level, msg).report_suppressed(slog_suppressed_)
+
+/* Static constexpr description of the calling statement (file name, function, line and level),
+ * made at compile time. The level must be a constant, so the generic makros above that accept
+ * a runtime level carry no call site */
+#define SLOG_CALL_SITE(log_level) \
+    static constexpr slog::call_site slog_call_site_{slog::file_basename(__FILE__), __func__, __LINE__, log_level}
+
+/* Same as the makros above for a constant level, the logger only receives the address of the
+ * call site. Used by the SLOG_<LEVEL> makros */
+#define SLOG_SITE_LOG(target, log_level, msg) \
+    if (SLOG_CALL_SITE(log_level); !(target).is_enabled(log_level)) {} else (target).log(slog_call_site_, msg)
+
+#define SLOG_SITE_LOG_EVERY_N(target, log_level, n, msg) \
+    if (SLOG_CALL_SITE(log_level); !(target).is_enabled(log_level)) {} \
+    else if (static slog::every_n_site slog_rate_site_; false) {} \
+    else if (uint64_t slog_suppressed_ = 0; !slog_rate_site_.allow(n, slog_suppressed_)) {} \
+    else (target).log(slog_call_site_, msg).report_suppressed(slog_suppressed_)
+
+#define SLOG_SITE_LOG_EVERY_MS(target, log_level, ms, msg) \
+    if (SLOG_CALL_SITE(log_level); !(target).is_enabled(log_level)) {} \
+    else if (static slog::every_ms_site slog_rate_site_; false) {} \
+    else if (uint64_t slog_suppressed_ = 0; !slog_rate_site_.allow(ms, slog::steady_clock_ns(), slog_suppressed_)) {} \
+    else (target).log(slog_call_site_, msg).report_suppressed(slog_suppressed_)
+
+#define SLOG_SITE_LOG_RATE(target, log_level, per_second, burst, msg) \
+    if (SLOG_CALL_SITE(log_level); !(target).is_enabled(log_level)) {} \
+    else if (static slog::token_bucket_site slog_rate_site_; false) {} \
+    else if (uint64_t slog_suppressed_ = 0; \
+             !slog_rate_site_.allow(per_second, burst, slog::steady_clock_ns(), slog_suppressed_)) {} \
+    else (target).log(slog_call_site_, msg).report_suppressed(slog_suppressed_)
+
+/* Stripped makro, the call is still type checked but it is a discarded statement so it generates
+ * no code and nothing it references is odr-used */
+#define SLOG_STRIPPED(target, log_level, msg) \
+    if constexpr (true) {} else (target).log(log_level, msg)
+
+#if SLOG_ACTIVE_LEVEL <= SLOG_LEVEL_TRACE
+#define SLOG_TRACE(target, msg) SLOG_SITE_LOG(target, slog::logger::level::trace, msg)
+#define SLOG_TRACE_EVERY_N(target, n, msg) SLOG_SITE_LOG_EVERY_N(target, slog::logger::level::trace, n, msg)
+#define SLOG_TRACE_EVERY_MS(target, ms, msg) SLOG_SITE_LOG_EVERY_MS(target, slog::logger::level::trace, ms, msg)
+#define SLOG_TRACE_RATE(target, per_second, burst, msg) SLOG_SITE_LOG_RATE(target, slog::logger::level::trace, per_second, burst, msg)
+#else
+#define SLOG_TRACE(target, msg) SLOG_STRIPPED(target, slog::logger::level::trace, msg)
+#define SLOG_TRACE_EVERY_N(target, n, msg) SLOG_STRIPPED(target, slog::logger::level::trace, msg)
+#define SLOG_TRACE_EVERY_MS(target, ms, msg) SLOG_STRIPPED(target, slog::logger::level::trace, msg)
+#define SLOG_TRACE_RATE(target, per_second, burst, msg) SLOG_STRIPPED(target, slog::logger::level::trace, msg)
+#endif
+
+#if SLOG_ACTIVE_LEVEL <= SLOG_LEVEL_DEBUG
+#define SLOG_DEBUG(target, msg) SLOG_SITE_LOG(target, slog::logger::level::debug, msg)
+#define SLOG_DEBUG_EVERY_N(target, n, msg) SLOG_SITE_LOG_EVERY_N(target, slog::logger::level::debug, n, msg)
+#define SLOG_DEBUG_EVERY_MS(target, ms, msg) SLOG_SITE_LOG_EVERY_MS(target, slog::logger::level::debug, ms, msg)
+#define SLOG_DEBUG_RATE(target, per_second, burst, msg) SLOG_SITE_LOG_RATE(target, slog::logger::level::debug, per_second, burst, msg)
+#else
+#define SLOG_DEBUG(target, msg) SLOG_STRIPPED(target, slog::logger::level::debug, msg)
+#define SLOG_DEBUG_EVERY_N(target, n, msg) SLOG_STRIPPED(target, slog::logger::level::debug, msg)
+#define SLOG_DEBUG_EVERY_MS(target, ms, msg) SLOG_STRIPPED(target, slog::logger::level::debug, msg)
+#define SLOG_DEBUG_RATE(target, per_second, burst, msg) SLOG_STRIPPED(target, slog::logger::level::debug, msg)
+#endif
+
+#if SLOG_ACTIVE_LEVEL <= SLOG_LEVEL_INFO
+#define SLOG_INFO(target, msg) SLOG_SITE_LOG(target, slog::logger::level::info, msg)
+#define SLOG_INFO_EVERY_N(target, n, msg) SLOG_SITE_LOG_EVERY_N(target, slog::logger::level::info, n, msg)
+#define SLOG_INFO_EVERY_MS(target, ms, msg) SLOG_SITE_LOG_EVERY_MS(target, slog::logger::level::info, ms, msg)
+#define SLOG_INFO_RATE(target, per_second, burst, msg) SLOG_SITE_LOG_RATE(target, slog::logger::level::info, per_second, burst, msg)
+#else
+#define SLOG_INFO(target, msg) SLOG_STRIPPED(target, slog::logger::level::info, msg)
+#define SLOG_INFO_EVERY_N(target, n, msg) SLOG_STRIPPED(target, slog::logger::level::info, msg)
+#define SLOG_INFO_EVERY_MS(target, ms, msg) SLOG_STRIPPED(target, slog::logger::level::info, msg)
+#define SLOG_INFO_RATE(target, per_second, burst, msg) SLOG_STRIPPED(target, slog::logger::level::info, msg)
+#endif
+
+#if SLOG_ACTIVE_LEVEL <= SLOG_LEVEL_WARN
+#define SLOG_WARN(target, msg) SLOG_SITE_LOG(target, slog::logger::level::warn, msg)
+#define SLOG_WARN_EVERY_N(target, n, msg) SLOG_SITE_LOG_EVERY_N(target, slog::logger::level::warn, n, msg)
+#define SLOG_WARN_EVERY_MS(target, ms, msg) SLOG_SITE_LOG_EVERY_MS(target, slog::logger::level::warn, ms, msg)
+#define SLOG_WARN_RATE(target, per_second, burst, msg) SLOG_SITE_LOG_RATE(target, slog::logger::level::warn, per_second, burst, msg)
+#else
+#define SLOG_WARN(target, msg) SLOG_STRIPPED(target, slog::logger::level::warn, msg)
+#define SLOG_WARN_EVERY_N(target, n, msg) SLOG_STRIPPED(target, slog::logger::level::warn, msg)
+#define SLOG_WARN_EVERY_MS(target, ms, msg) SLOG_STRIPPED(target, slog::logger::level::warn, msg)
+#define SLOG_WARN_RATE(target, per_second, burst, msg) SLOG_STRIPPED(target, slog::logger::level::warn, msg)
+#endif
+
+#if SLOG_ACTIVE_LEVEL <= SLOG_LEVEL_ERROR
+#define SLOG_ERROR(target, msg) SLOG_SITE_LOG(target, slog::logger::level::error, msg)
+#define SLOG_ERROR_EVERY_N(target, n, msg) SLOG_SITE_LOG_EVERY_N(target, slog::logger::level::error, n, msg)
+#define SLOG_ERROR_EVERY_MS(target, ms, msg) SLOG_SITE_LOG_EVERY_MS(target, slog::logger::level::error, ms, msg)
+#define SLOG_ERROR_RATE(target, per_second, burst, msg) SLOG_SITE_LOG_RATE(target, slog::logger::level::error, per_second, burst, msg)
+#else
+#define SLOG_ERROR(target, msg) SLOG_STRIPPED(target, slog::logger::level::error, msg)
+#define SLOG_ERROR_EVERY_N(target, n, msg) SLOG_STRIPPED(target, slog::logger::level::error, msg)
+#define SLOG_ERROR_EVERY_MS(target, ms, msg) SLOG_STRIPPED(target, slog::logger::level::error, msg)
+#define SLOG_ERROR_RATE(target, per_second, burst, msg) SLOG_STRIPPED(target, slog::logger::level::error, msg)
+#endif
+
+#if SLOG_ACTIVE_LEVEL <= SLOG_LEVEL_FATAL
+#define SLOG_FATAL(target, msg) SLOG_SITE_LOG(target, slog::logger::level::fatal, msg)
+#define SLOG_FATAL_EVERY_N(target, n, msg) SLOG_SITE_LOG_EVERY_N(target, slog::logger::level::fatal, n, msg)
+#define SLOG_FATAL_EVERY_MS(target, ms, msg) SLOG_SITE_LOG_EVERY_MS(target, slog::logger::level::fatal, ms, msg)
+#define SLOG_FATAL_RATE(target, per_second, burst, msg) SLOG_SITE_LOG_RATE(target, slog::logger::level::fatal, per_second, burst, msg)
+#else
+#define SLOG_FATAL(target, msg) SLOG_STRIPPED(target, slog::logger::level::fatal, msg)
+#define SLOG_FATAL_EVERY_N(target, n, msg) SLOG_STRIPPED(target, slog::logger::level::fatal, msg)
+#define SLOG_FATAL_EVERY_MS(target, ms, msg) SLOG_STRIPPED(target, slog::logger::level::fatal, msg)
+#define SLOG_FATAL_RATE(target, per_second, burst, msg) SLOG_STRIPPED(target, slog::logger::level::fatal, msg)
+#endif
 
 #endif //SMALL_LOG_SLOG_H
@@ -0,0 +1,56 @@
+//
+// Created by lcrgo on 17/10/2026.
+//
+
+#include "tick.h"
+
+#include <chrono>
+
+namespace slog {
+
+    uint64_t system_clock_ns() {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::system_clock::now().time_since_epoch()).count());
+    }
+
+    uint64_t steady_clock_ns() {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+
+    timedate ticks_to_timedate(uint64_t ticks, uint64_t ticks_per_second) {
+        timedate td;
+
+        if (ticks_per_second == 0) {
+            return td;
+        }
+
+        const uint64_t seconds = ticks / ticks_per_second;
+        const uint64_t sub_ticks = ticks % ticks_per_second;
+        const int64_t days = static_cast<int64_t>(seconds / 86400);
+        const uint32_t day_seconds = static_cast<uint32_t>(seconds % 86400);
+
+        /* Civil date from the number of days since the epoch (proleptic Gregorian calendar),
+         * counted in 400 years eras starting on March 1st */
+        const int64_t z = days + 719468;
+        const int64_t era = z / 146097;
+        const int64_t doe = z - era * 146097;
+        const int64_t yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+        const int64_t doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+        const int64_t mp = (5 * doy + 2) / 153;
+        const int64_t day = doy - (153 * mp + 2) / 5 + 1;
+        const int64_t month = mp < 10 ? mp + 3 : mp - 9;
+        const int64_t year = yoe + era * 400 + (month <= 2 ? 1 : 0);
+
+        td.setMYear(static_cast<uint16_t>(year));
+        td.setMMonth(static_cast<uint8_t>(month));
+        td.setMDay(static_cast<uint8_t>(day));
+        td.setMHour(static_cast<uint8_t>(day_seconds / 3600));
+        td.setMMinute(static_cast<uint8_t>((day_seconds / 60) % 60));
+        td.setMSecond(static_cast<uint8_t>(day_seconds % 60));
+        td.setMMillisecond(static_cast<uint16_t>(sub_ticks * 1000 / ticks_per_second));
+
+        return td;
+    }
+
+} // slog
@@ -0,0 +1,44 @@
+//
+// Created by lcrgo on 17/10/2026.
+//
+
+#ifndef SMALL_LOG_TICK_H
+#define SMALL_LOG_TICK_H
+
+#include <cstdint>
+
+#include "delegate.h"
+#include "timedate.h"
+
+namespace slog {
+
+    /* Raw time source, returns a monotonic or wall clock counter */
+    using tick_source = uint64_t (*)();
+
+    /* Calendar time source, returns the current local or UTC time */
+    using time_provider_fn = delegate<timedate()>;
+
+    /**
+     * @brief Wall clock time source, nanoseconds since the Unix epoch (UTC)
+     * @return uint64_t, current time in nanoseconds
+     */
+    uint64_t system_clock_ns();
+
+    /**
+     * @brief Monotonic time source, nanoseconds since an unspecified point (usually the boot),
+     *        used for intervals, it is not a wall clock
+     * @return uint64_t, current time in nanoseconds
+     */
+    uint64_t steady_clock_ns();
+
+    /**
+     * @brief Convert a tick count since the Unix epoch into calendar fields (UTC)
+     * @param ticks, number of ticks since 1970/01/01 00:00:00
+     * @param ticks_per_second, tick frequency
+     * @return timedate, calendar time with millisecond resolution
+     */
+    timedate ticks_to_timedate(uint64_t ticks, uint64_t ticks_per_second);
+
+} // slog
+
+#endif //SMALL_LOG_TICK_H
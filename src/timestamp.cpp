@@ -0,0 +1,89 @@
+//
+// Created by lcrgo on 17/10/2026.
+//
+
+#include "timestamp.h"
+#include "digits.h"
+#include "tick.h"
+
+#include <cstring>
+
+namespace slog {
+
+    /* Field positions in the text [2024/02/10 23:12:35.123] */
+    static constexpr size_t year_pos = 1;
+    static constexpr size_t month_pos = 6;
+    static constexpr size_t day_pos = 9;
+    static constexpr size_t hour_pos = 12;
+    static constexpr size_t minute_pos = 15;
+    static constexpr size_t second_pos = 18;
+    static constexpr size_t millisecond_pos = 21;
+
+    timestamp_cache::timestamp_cache() :
+    m_year(0), m_month(0), m_day(0), m_hour(0), m_minute(0), m_second(0), m_millisecond(0),
+    m_second_start(0), m_second_end(0), m_ticks_per_second(0) {
+
+        /* Start from the rendering of a date no time provider gives (all zeros), so the first
+         * call rewrites every field */
+        std::memcpy(m_text, "[0000/00/00 00:00:00.000]", max_len);
+    }
+
+    size_t timestamp_cache::render(const timedate& td, bool print_date, char* out) {
+
+        /* Rewrite only what changed, from the fastest changing field */
+        if (td.getMMillisecond() != m_millisecond) {
+            m_millisecond = td.getMMillisecond();
+            digits::write3(&m_text[millisecond_pos], m_millisecond);
+        }
+        if (td.getMSecond() != m_second) {
+            m_second = td.getMSecond();
+            digits::write2(&m_text[second_pos], m_second);
+        }
+        if (td.getMMinute() != m_minute) {
+            m_minute = td.getMMinute();
+            digits::write2(&m_text[minute_pos], m_minute);
+        }
+        if (td.getMHour() != m_hour) {
+            m_hour = td.getMHour();
+            digits::write2(&m_text[hour_pos], m_hour);
+        }
+        if (td.getMDay() != m_day) {
+            m_day = td.getMDay();
+            digits::write2(&m_text[day_pos], m_day);
+        }
+        if (td.getMMonth() != m_month) {
+            m_month = td.getMMonth();
+            digits::write2(&m_text[month_pos], m_month);
+        }
+        if (td.getMYear() != m_year) {
+            m_year = td.getMYear();
+            digits::write4(&m_text[year_pos], m_year);
+        }
+
+        if (print_date) {
+            std::memcpy(out, m_text, max_len);
+            return max_len;
+        }
+
+        /* [23:12:35.123] */
+        out[0] = '[';
+        std::memcpy(&out[1], &m_text[hour_pos], max_len - hour_pos);
+        return 1 + max_len - hour_pos;
+    }
+
+    size_t timestamp_cache::render(uint64_t ticks, uint64_t ticks_per_second, bool print_date, char* out) {
+
+        /* Calendar conversion only once per second */
+        if (ticks < m_second_start || ticks >= m_second_end || ticks_per_second != m_ticks_per_second) {
+            m_ticks_per_second = ticks_per_second;
+            m_second_start = ticks - ticks % ticks_per_second;
+            m_second_end = m_second_start + ticks_per_second;
+            m_second_time = ticks_to_timedate(m_second_start, ticks_per_second);
+        }
+
+        m_second_time.setMMillisecond(static_cast<uint16_t>((ticks - m_second_start) * 1000 / ticks_per_second));
+
+        return render(m_second_time, print_date, out);
+    }
+
+} // slog
@@ -0,0 +1,76 @@
+//
+// Created by lcrgo on 17/10/2026.
+//
+
+#ifndef SMALL_LOG_TIMESTAMP_H
+#define SMALL_LOG_TIMESTAMP_H
+
+#include <cstddef>
+#include <cstdint>
+
+#include "timedate.h"
+
+namespace slog {
+
+    /**
+     * @brief Keeps the last rendered timestamp and only rewrites the fields that changed since
+     *        the previous record, usually just the milliseconds. Not thread safe, the logger
+     *        keeps one per thread.
+     */
+    class timestamp_cache {
+    public:
+        /* longest rendering: [2024/02/10 23:12:35.123] */
+        static constexpr size_t max_len = 25;
+
+        timestamp_cache();
+
+        /**
+         * @brief Render the timestamp as [2024/02/10 23:12:35.123] or [23:12:35.123]
+         * @param td, time to render
+         * @param print_date, true to include the date
+         * @param out, destination, at least max_len characters, not null terminated
+         * @return size_t, number of characters written
+         */
+        size_t render(const timedate& td, bool print_date, char* out);
+
+        /**
+         * @brief Render a raw tick count since the Unix epoch (UTC). The calendar conversion is
+         *        only done when the tick leaves the second of the previous call.
+         * @param ticks, number of ticks since 1970/01/01 00:00:00
+         * @param ticks_per_second, tick frequency
+         * @param print_date, true to include the date
+         * @param out, destination, at least max_len characters, not null terminated
+         * @return size_t, number of characters written
+         */
+        size_t render(uint64_t ticks, uint64_t ticks_per_second, bool print_date, char* out);
+
+        /**
+         * @brief Length of the rendering
+         * @param print_date, true to include the date
+         * @return size_t, number of characters render() writes
+         */
+        static constexpr size_t length(bool print_date) {
+            return print_date ? max_len : max_len - 11;
+        }
+
+    private:
+        /* member variables */
+        char m_text[max_len];
+        uint16_t m_year;
+        uint8_t m_month;
+        uint8_t m_day;
+        uint8_t m_hour;
+        uint8_t m_minute;
+        uint8_t m_second;
+        uint16_t m_millisecond;
+
+        /* calendar time of the current second for the raw tick rendering */
+        timedate m_second_time;
+        uint64_t m_second_start;
+        uint64_t m_second_end;
+        uint64_t m_ticks_per_second;
+    };
+
+} // slog
+
+#endif //SMALL_LOG_TIMESTAMP_H
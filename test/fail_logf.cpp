@@ -0,0 +1,31 @@
+/* Format strings are checked at compile time: built with SLOG_FAIL_CASE set, this file must not
+ * compile. Without it, it must compile, so the failures come from the checks and nothing else. */
+
+#include "slog.h"
+
+void fail_logf(slog::logger& logger) {
+    const int value = 42;
+    const double ratio = 0.5;
+
+#if !defined(SLOG_FAIL_CASE)
+    SLOG_LOGF(logger, slog::logger::level::info, "value={:x} ratio={:.2f}", value, ratio);
+#elif SLOG_FAIL_CASE == 1
+    /* more placeholders than arguments */
+    SLOG_LOGF(logger, slog::logger::level::info, "value={} ratio={}", value);
+#elif SLOG_FAIL_CASE == 2
+    /* more arguments than placeholders */
+    SLOG_LOGF(logger, slog::logger::level::info, "value={}", value, ratio);
+#elif SLOG_FAIL_CASE == 3
+    /* integer placeholder given a floating point value */
+    SLOG_LOGF(logger, slog::logger::level::info, "ratio={:x}", ratio);
+#elif SLOG_FAIL_CASE == 4
+    /* precision given to an integer */
+    SLOG_LOGF(logger, slog::logger::level::info, "value={:.2}", value);
+#elif SLOG_FAIL_CASE == 5
+    /* unclosed placeholder */
+    SLOG_LOGF(logger, slog::logger::level::info, "value={", value);
+#elif SLOG_FAIL_CASE == 6
+    /* type the logger cannot print */
+    SLOG_LOGF(logger, slog::logger::level::info, "value={}", &value);
+#endif
+}
@@ -0,0 +1,219 @@
+#include "slog.h"
+
+#include "gtest/gtest.h"
+
+#include <string>
+#include <vector>
+#include <thread>
+#include <atomic>
+
+
+/* Sink that stores every record it receives, only used from the worker thread
+ * until the logger is flushed or shut down */
+class collect_sink : public slog::sink {
+public:
+    void write(const slog::record& rec) override {
+        records.emplace_back(rec.data, rec.size);
+        threads.push_back(std::this_thread::get_id());
+    }
+
+    void write(slog::span<const slog::record> batch) override {
+        nbr_batches += 1;
+        for (const slog::record& rec : batch) {
+            write(rec);
+        }
+    }
+
+    void flush() override {
+        nbr_flushes += 1;
+    }
+
+    std::vector<std::string> records;
+    std::vector<std::thread::id> threads;
+    int nbr_batches = 0;
+    int nbr_flushes = 0;
+};
+
+/* Sink that blocks until it is released, used to fill the ring */
+class blocking_sink : public slog::sink {
+public:
+    using slog::sink::write;
+
+    void write(const slog::record& rec) override {
+        (void)rec;
+        while (!released.load()) {
+            std::this_thread::yield();
+        }
+        nbr_writes += 1;
+    }
+
+    std::atomic<bool> released{false};
+    std::atomic<int> nbr_writes{0};
+};
+
+
+TEST(SmallLogAsyncTest, ring_storage) {
+    /* The ring only accepts power of two storage */
+
+    static slog::async_slot slots[8];
+    slog::async_ring ring;
+
+    EXPECT_FALSE(ring.init(nullptr, 8));
+    EXPECT_FALSE(ring.init(slots, 6));
+    EXPECT_FALSE(ring.init(slots, 1));
+    EXPECT_TRUE(ring.init(slots, 8));
+
+    /* Fill the ring */
+    const slog::record rec = {"\nrecord", 7, slog::logger::level::info};
+    for (int i = 0; i < 8; i++) {
+        EXPECT_TRUE(ring.try_push(rec));
+    }
+    EXPECT_FALSE(ring.try_push(rec));
+    EXPECT_EQ(ring.pushed(), 8u);
+
+    /* Records can be peeked and released in order */
+    ASSERT_NE(ring.peek(0), nullptr);
+    EXPECT_EQ(std::string(ring.peek(0)->data, ring.peek(0)->size), "\nrecord");
+    ASSERT_NE(ring.peek(7), nullptr);
+    EXPECT_EQ(ring.peek(8), nullptr);
+
+    ring.release(3);
+    EXPECT_EQ(ring.consumed(), 3u);
+    EXPECT_TRUE(ring.try_push(rec));
+    EXPECT_EQ(ring.peek(5)->lvl, slog::logger::level::info);
+}
+
+TEST(SmallLogAsyncTest, async_records_in_order) {
+    /* Check the records are written by the worker, in order, and flush waits for them */
+
+    static slog::async_slot slots[16];
+    collect_sink sink;
+
+    /* Create a logger */
+    auto logger = slog::logger("test_logger");
+    logger.add_sink(sink);
+
+    /* Invalid storage doesn't start the worker */
+    EXPECT_FALSE(logger.start_async(slots, 10));
+    EXPECT_TRUE(logger.start_async(slots, 16));
+    EXPECT_FALSE(logger.start_async(slots, 16));
+
+    for (int i = 0; i < 100; i++) {
+        logger.log(slog::logger::level::info, "record ") << i;
+    }
+    logger.flush();
+
+    ASSERT_EQ(sink.records.size(), 100u);
+    for (int i = 0; i < 100; i++) {
+        EXPECT_EQ(sink.records[i], "\n[INFO ][test_logger] record " + std::to_string(i));
+        EXPECT_NE(sink.threads[i], std::this_thread::get_id());
+    }
+    EXPECT_GE(sink.nbr_flushes, 1);
+
+    /* Back to synchronous mode after shutdown */
+    logger.shutdown();
+    logger.log(slog::logger::level::warn, "sync record");
+    ASSERT_EQ(sink.records.size(), 101u);
+    EXPECT_EQ(sink.threads[100], std::this_thread::get_id());
+}
+
+TEST(SmallLogAsyncTest, async_no_loss_on_destruction) {
+    /* Check the destructor writes every queued record, even with a slow sink */
+
+    static slog::async_slot slots[4];
+    blocking_sink sink;
+
+    {
+        /* Create a logger */
+        auto logger = slog::logger("test_logger");
+        logger.add_sink(sink);
+        ASSERT_TRUE(logger.start_async(slots, 4));
+
+        /* Release the sink from another thread, the producer blocks on the full ring meanwhile */
+        std::thread releaser([&sink]() {
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            sink.released.store(true);
+        });
+
+        for (int i = 0; i < 50; i++) {
+            logger.log(slog::logger::level::info, "record ") << i;
+        }
+        releaser.join();
+    }
+
+    EXPECT_EQ(sink.nbr_writes.load(), 50);
+}
+
+TEST(SmallLogAsyncTest, async_drop_when_full) {
+    /* Check the drop overflow policy never blocks the producer */
+
+    static slog::async_slot slots[4];
+    blocking_sink sink;
+
+    /* Create a logger */
+    auto logger = slog::logger("test_logger");
+    logger.add_sink(sink);
+    ASSERT_TRUE(logger.start_async(slots, 4, slog::logger::async_overflow::drop));
+
+    for (int i = 0; i < 50; i++) {
+        logger.log(slog::logger::level::info, "record ") << i;
+    }
+
+    /* At most the ring plus the batch being written can be in flight */
+    EXPECT_GE(logger.get_async_dropped(), 50u - 4u - 1u);
+
+    sink.released.store(true);
+    logger.shutdown();
+    EXPECT_EQ(static_cast<size_t>(sink.nbr_writes.load()) + logger.get_async_dropped(), 50u);
+}
+
+TEST(SmallLogAsyncTest, async_batches) {
+    /* Check the worker hands the queued records to the sinks in batches */
+
+    static slog::async_slot slots[64];
+    collect_sink sink;
+
+    /* Create a logger */
+    auto logger = slog::logger("test_logger");
+    logger.add_sink(sink);
+    logger.add_appender([](const char*) {
+        /* slow appender so records pile up in the ring */
+        std::this_thread::sleep_for(std::chrono::microseconds(200));
+    });
+    ASSERT_TRUE(logger.start_async(slots, 64));
+
+    for (int i = 0; i < 64; i++) {
+        logger.log(slog::logger::level::info, "record ") << i;
+    }
+    logger.shutdown();
+
+    EXPECT_EQ(sink.records.size(), 64u);
+    EXPECT_GT(sink.nbr_batches, 0);
+}
+
+/* Fixed time, 2024/01/30 23:25:16.753 in microseconds */
+static uint64_t fixed_us() {
+    return 1706657116753000ull;
+}
+
+TEST(SmallLogAsyncTest, async_deferred_timestamp) {
+    /* Check the worker renders the timestamps of the tick source */
+
+    static slog::async_slot slots[8];
+    collect_sink sink;
+
+    /* Create a logger */
+    auto logger = slog::logger("test_logger");
+    logger.add_sink(sink);
+    logger.set_tick_source(fixed_us, 1000000);
+    ASSERT_TRUE(logger.start_async(slots, 8));
+
+    logger.log(slog::logger::level::info, "time only");
+    logger.set_print_date(true);
+    logger.log(slog::logger::level::info, "with date ") << 42;
+    logger.shutdown();
+
+    ASSERT_EQ(sink.records.size(), 2u);
+    EXPECT_EQ(sink.records[0], "\n[23:25:16.753][INFO ][test_logger] time only");
+    EXPECT_EQ(sink.records[1], "\n[2024/01/30 23:25:16.753][INFO ][test_logger] with date 42");
+}
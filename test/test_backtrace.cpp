@@ -0,0 +1,190 @@
+#include "slog.h"
+
+#include "gtest/gtest.h"
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+
+/* Sink that keeps the records with their backtrace flag */
+class backtrace_sink : public slog::sink {
+public:
+    using slog::sink::write;
+
+    void write(const slog::record& rec) override {
+        records.emplace_back(rec.data, rec.size);
+        flags.push_back(rec.backtrace);
+    }
+
+    std::vector<std::string> records;
+    std::vector<bool> flags;
+};
+
+/* Log the same statements, used to compare the replayed records with the formatted ones */
+static void log_statements(slog::logger& logger) {
+    using namespace std::chrono_literals;
+
+    SLOG_DEBUG(logger, "plain message");
+    SLOG_DEBUG(logger, "value ") << -42 << ' ' << 42u << slog::logger::radix::hex << " hex " << 255;
+    SLOG_DEBUG(logger, "width ") << slog::logger::setw(6) << slog::logger::setfill('0') << 7 << " " << 8;
+    SLOG_DEBUG(logger, "float ") << 0.1 << ' ' << 2.5f << ' ' << slog::logger::setprecision(3)
+                                 << slog::logger::float_format::fixed << 3.14159;
+    SLOG_DEBUG(logger, "duration ") << 3s << ' ' << 15ms << ' ' << 250us;
+    SLOG_LOGF(logger, slog::logger::level::debug, "logf {} {:x} {:08.3f} {}", 12, 255u, 1.5, "text");
+}
+
+static uint64_t fake_ticks = 0;
+static uint64_t fake_tick_source() {
+    /* one millisecond per call */
+    fake_ticks += 1000;
+    return fake_ticks;
+}
+
+
+TEST(SmallLogBacktraceTest, storage) {
+    /* The buffer only accepts power of two storage, once */
+
+    static slog::backtrace_slot slots[8];
+    auto logger = slog::logger("test_logger");
+
+    EXPECT_FALSE(logger.enable_backtrace(nullptr, 8));
+    EXPECT_FALSE(logger.enable_backtrace(slots, 6));
+    EXPECT_FALSE(logger.enable_backtrace(slots, 0));
+    EXPECT_FALSE(logger.is_enabled(slog::logger::level::debug));
+
+    EXPECT_TRUE(logger.enable_backtrace(slots, 8));
+    EXPECT_FALSE(logger.enable_backtrace(slots, 8));
+    EXPECT_TRUE(logger.is_enabled(slog::logger::level::debug));
+    EXPECT_FALSE(logger.is_enabled(slog::logger::level::trace));
+}
+
+TEST(SmallLogBacktraceTest, replay_on_trigger) {
+    /* Check the kept records are written before the trigger record, formatted as usual */
+
+    /* The records as they would be formatted with the debug level */
+    backtrace_sink reference;
+    auto formatted = slog::logger("test_logger");
+    formatted.set_Level(slog::logger::level::debug);
+    formatted.add_sink(reference);
+    log_statements(formatted);
+    ASSERT_EQ(reference.records.size(), 6u);
+
+    static slog::backtrace_slot slots[16];
+    backtrace_sink output;
+    auto logger = slog::logger("test_logger");
+    logger.add_sink(output);
+    EXPECT_TRUE(logger.enable_backtrace(slots, 16, slog::logger::level::debug, slog::logger::level::error));
+
+    log_statements(logger);
+    SLOG_TRACE(logger, "not kept");
+    SLOG_INFO(logger, "info");
+    SLOG_WARN(logger, "warn");
+
+    /* Nothing below the logger level is written yet */
+    ASSERT_EQ(output.records.size(), 2u);
+    EXPECT_EQ(output.records[0], "\n[INFO ][test_logger] info");
+    EXPECT_EQ(output.records[1], "\n[WARN ][test_logger] warn");
+
+    SLOG_ERROR(logger, "error");
+    std::vector<std::string> expected = {"\n[INFO ][test_logger] info", "\n[WARN ][test_logger] warn"};
+    expected.insert(expected.end(), reference.records.begin(), reference.records.end());
+    expected.emplace_back("\n[ERROR][test_logger] error");
+    EXPECT_EQ(output.records, expected);
+    EXPECT_EQ(output.flags, std::vector<bool>({false, false, true, true, true, true, true, true, false}));
+
+    /* The replayed records are not written twice */
+    SLOG_ERROR(logger, "again");
+    ASSERT_EQ(output.records.size(), expected.size() + 1);
+    EXPECT_EQ(output.records.back(), "\n[ERROR][test_logger] again");
+}
+
+TEST(SmallLogBacktraceTest, bounded) {
+    /* Check only the newest records are kept and they carry the time they were logged */
+
+    static slog::backtrace_slot slots[4];
+    backtrace_sink output;
+    auto logger = slog::logger("test_logger");
+    logger.set_tick_source(fake_tick_source, 1000000);
+    logger.add_sink(output);
+    EXPECT_TRUE(logger.enable_backtrace(slots, 4, slog::logger::level::trace, slog::logger::level::warn));
+
+    fake_ticks = 0;
+    for (int i = 0; i < 10; ++i) {
+        SLOG_TRACE(logger, "record ") << i;
+    }
+    SLOG_WARN(logger, "warn");
+
+    ASSERT_EQ(output.records.size(), 5u);
+    EXPECT_EQ(output.records[0], "\n[00:00:00.007][TRACE][test_logger] record 6");
+    EXPECT_EQ(output.records[1], "\n[00:00:00.008][TRACE][test_logger] record 7");
+    EXPECT_EQ(output.records[2], "\n[00:00:00.009][TRACE][test_logger] record 8");
+    EXPECT_EQ(output.records[3], "\n[00:00:00.010][TRACE][test_logger] record 9");
+    EXPECT_EQ(output.records[4], "\n[00:00:00.011][WARN ][test_logger] warn");
+}
+
+TEST(SmallLogBacktraceTest, truncated) {
+    /* Check records longer than the buffer are trimmed */
+
+    static slog::backtrace_slot slots[2];
+    backtrace_sink output;
+    auto logger = slog::logger("test_logger");
+    logger.add_sink(output);
+    EXPECT_TRUE(logger.enable_backtrace(slots, 2));
+
+    const std::string text(2 * MAX_LOG_RECORD_LEN, 'x');
+    SLOG_DEBUG(logger, text) << 1234;
+    SLOG_ERROR(logger, "error");
+
+    ASSERT_EQ(output.records.size(), 2u);
+    const std::string& replayed = output.records[0];
+    EXPECT_EQ(replayed.rfind("\n[DEBUG][test_logger] xxx", 0), 0u);
+    EXPECT_EQ(replayed.find_first_not_of('x', 22), std::string::npos);
+    EXPECT_LT(replayed.size(), static_cast<size_t>(MAX_LOG_RECORD_LEN));
+}
+
+TEST(SmallLogBacktraceTest, async_order) {
+    /* Check the replayed records keep their place in asynchronous mode */
+
+    static slog::backtrace_slot slots[8];
+    static slog::async_slot async_slots[16];
+    backtrace_sink output;
+    auto logger = slog::logger("test_logger");
+    logger.add_sink(output);
+    EXPECT_TRUE(logger.enable_backtrace(slots, 8));
+    EXPECT_TRUE(logger.start_async(async_slots, 16));
+
+    SLOG_INFO(logger, "first");
+    SLOG_DEBUG(logger, "context");
+    SLOG_ERROR(logger, "error");
+    logger.shutdown();
+
+    ASSERT_EQ(output.records.size(), 3u);
+    EXPECT_EQ(output.records[0], "\n[INFO ][test_logger] first");
+    EXPECT_EQ(output.records[1], "\n[DEBUG][test_logger] context");
+    EXPECT_EQ(output.records[2], "\n[ERROR][test_logger] error");
+    EXPECT_EQ(output.flags, std::vector<bool>({false, true, false}));
+}
+
+TEST(SmallLogBacktraceTest, capture_sinks) {
+    /* Check the records captured by a sink are formatted and not kept raw */
+
+    static slog::backtrace_slot slots[8];
+    backtrace_sink capture;
+    backtrace_sink output;
+    auto logger = slog::logger("test_logger");
+    logger.add_sink(output);
+    logger.add_sink(capture, slog::logger::level::debug);
+    EXPECT_TRUE(logger.enable_backtrace(slots, 8, slog::logger::level::trace));
+
+    SLOG_TRACE(logger, "kept raw");
+    SLOG_DEBUG(logger, "captured");
+    EXPECT_EQ(capture.records.size(), 1u);
+    EXPECT_TRUE(output.records.empty());
+
+    SLOG_ERROR(logger, "error");
+    ASSERT_EQ(output.records.size(), 2u);
+    EXPECT_EQ(output.records[0], "\n[TRACE][test_logger] kept raw");
+    EXPECT_EQ(output.records[1], "\n[ERROR][test_logger] error");
+    EXPECT_EQ(capture.records.size(), 3u);
+}
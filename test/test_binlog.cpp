@@ -0,0 +1,246 @@
+#include "binlog.h"
+
+#include "gtest/gtest.h"
+
+#include <string>
+#include <vector>
+#include <chrono>
+
+
+/* Sink that keeps the binary stream */
+class stream_sink : public slog::sink {
+public:
+    using slog::sink::write;
+
+    void write(const slog::record& rec) override {
+        stream.append(rec.data, rec.size);
+        nbr_writes += 1;
+    }
+
+    std::string stream;
+    int nbr_writes = 0;
+};
+
+/* 2024/01/30 23:25:16.753 in milliseconds since the epoch */
+static uint64_t fixed_ms() {
+    return 1706657116753ull;
+}
+
+/* Call site shared by several loggers */
+static void log_shared_site(slog::binary_logger& logger, int value) {
+    SLOG_BIN(logger, slog::logger::level::info, "shared {}", value);
+}
+
+/* Decode a whole stream into text records */
+static std::vector<std::string> decode(const std::string& stream, bool print_date = false) {
+    std::vector<std::string> records;
+    slog::binary_decoder decoder;
+    decoder.set_print_date(print_date);
+
+    size_t used = decoder.decode(stream.data(), stream.size(), [&records](const slog::record& rec) {
+        records.emplace_back(rec.data, rec.size);
+    });
+    EXPECT_EQ(used, stream.size());
+
+    return records;
+}
+
+
+TEST(SmallLogBinaryTest, ticks_to_timedate) {
+    /* Check the calendar conversion of the raw ticks */
+
+    slog::timedate td = slog::ticks_to_timedate(fixed_ms(), 1000);
+    EXPECT_EQ(td.getMYear(), 2024);
+    EXPECT_EQ(td.getMMonth(), 1);
+    EXPECT_EQ(td.getMDay(), 30);
+    EXPECT_EQ(td.getMHour(), 23);
+    EXPECT_EQ(td.getMMinute(), 25);
+    EXPECT_EQ(td.getMSecond(), 16);
+    EXPECT_EQ(td.getMMillisecond(), 753);
+
+    /* Leap day */
+    td = slog::ticks_to_timedate(951782400ull * 1000000000ull + 999999999ull, 1000000000ull);
+    EXPECT_EQ(td.getMYear(), 2000);
+    EXPECT_EQ(td.getMMonth(), 2);
+    EXPECT_EQ(td.getMDay(), 29);
+    EXPECT_EQ(td.getMMillisecond(), 999);
+
+    /* Epoch */
+    td = slog::ticks_to_timedate(0, 1);
+    EXPECT_EQ(td.getMYear(), 1970);
+    EXPECT_EQ(td.getMMonth(), 1);
+    EXPECT_EQ(td.getMDay(), 1);
+}
+
+TEST(SmallLogBinaryTest, round_trip) {
+    /* Check the decoded stream gives the same text as the text logger */
+
+    stream_sink sink;
+
+    /* Create a logger */
+    auto logger = slog::binary_logger("test_logger");
+    logger.set_tick_source(fixed_ms, 1000);
+    EXPECT_TRUE(logger.add_sink(sink));
+
+    for (int i = 0; i < 3; i++) {
+        SLOG_BIN(logger, slog::logger::level::info, "record {} of {}", i, 3u);
+    }
+    std::string str = "string test";
+    SLOG_BIN(logger, slog::logger::level::warn, "types {} {} {} {} {} {}", str, std::string_view("view"),
+             -42, true, 'c', std::chrono::milliseconds(456));
+    SLOG_BIN(logger, slog::logger::level::error, "no arguments {{}}");
+    SLOG_BIN(logger, slog::logger::level::fatal, "{} {} {}", std::chrono::seconds(1), std::chrono::microseconds(2), 0.5);
+    int64_t min = INT64_MIN;
+    uint64_t max = UINT64_MAX;
+    SLOG_BIN(logger, slog::logger::level::info, "limits {} {}", min, max);
+    /* Filtered */
+    SLOG_BIN(logger, slog::logger::level::debug, "filtered {}", 1);
+
+    /* One write per record plus the header and one definition per call site */
+    EXPECT_EQ(sink.nbr_writes, 1 + 5 + 7);
+
+    std::vector<std::string> records = decode(sink.stream);
+    ASSERT_EQ(records.size(), 7u);
+    EXPECT_EQ(records[0], "\n[23:25:16.753][INFO ][test_logger] record 0 of 3");
+    EXPECT_EQ(records[2], "\n[23:25:16.753][INFO ][test_logger] record 2 of 3");
+    EXPECT_EQ(records[3], "\n[23:25:16.753][WARN ][test_logger] types string test view -42 true c 456ms");
+    EXPECT_EQ(records[4], "\n[23:25:16.753][ERROR][test_logger] no arguments {}");
+    EXPECT_EQ(records[5], "\n[23:25:16.753][FATAL][test_logger] 1s 2us 0.5");
+    EXPECT_EQ(records[6], "\n[23:25:16.753][INFO ][test_logger] limits -9223372036854775808 18446744073709551615");
+
+    records = decode(sink.stream, true);
+    EXPECT_EQ(records[0], "\n[2024/01/30 23:25:16.753][INFO ][test_logger] record 0 of 3");
+}
+
+TEST(SmallLogBinaryTest, compact_records) {
+    /* Check a record only holds the site id, the tick and the raw arguments */
+
+    stream_sink sink;
+
+    /* Create a logger */
+    auto logger = slog::binary_logger("test_logger");
+    logger.add_sink(sink);
+
+    SLOG_BIN(logger, slog::logger::level::info, "a long format string that is only written once {}", 1);
+    const size_t after_first = sink.stream.size();
+    SLOG_BIN(logger, slog::logger::level::info, "a long format string that is only written once {}", 2);
+
+    /* Two different sites, but each call of this one only costs the record */
+    for (int i = 0; i < 2; i++) {
+        const size_t before = sink.stream.size();
+        SLOG_BIN(logger, slog::logger::level::info, "value {}", i);
+        if (i == 1) {
+            EXPECT_EQ(sink.stream.size() - before, slog::bin::record_header_size + sizeof(int64_t));
+        }
+    }
+    EXPECT_GT(after_first, slog::bin::record_header_size);
+}
+
+TEST(SmallLogBinaryTest, truncated_stream) {
+    /* Check a truncated stream is decoded up to the last complete record */
+
+    stream_sink sink;
+
+    /* Create a logger */
+    auto logger = slog::binary_logger("test_logger");
+    logger.set_tick_source(fixed_ms, 1000);
+    logger.add_sink(sink);
+
+    SLOG_BIN(logger, slog::logger::level::info, "first {}", std::string(300, 'x'));
+    SLOG_BIN(logger, slog::logger::level::info, "second {}", 2);
+
+    std::vector<std::string> records;
+    slog::binary_decoder decoder;
+    const std::string partial = sink.stream.substr(0, sink.stream.size() - 1);
+    const size_t used = decoder.decode(partial.data(), partial.size(), [&records](const slog::record& rec) {
+        records.emplace_back(rec.data, rec.size);
+    });
+
+    ASSERT_EQ(records.size(), 1u);
+    EXPECT_LT(used, partial.size());
+    /* Long strings are truncated to the record size */
+    EXPECT_LT(records[0].size(), static_cast<size_t>(MAX_LOG_RECORD_LEN) + 40);
+    EXPECT_EQ(records[0].rfind("\n[23:25:16.753][INFO ][test_logger] first xxx", 0), 0u);
+}
+
+TEST(SmallLogBinaryTest, late_sink) {
+    /* Check a sink added after the first records gets the definitions it needs */
+
+    stream_sink first;
+    stream_sink late;
+
+    auto logger = slog::binary_logger("test_logger");
+    logger.set_tick_source(fixed_ms, 1000);
+    logger.add_sink(first);
+
+    SLOG_BIN(logger, slog::logger::level::info, "before {}", 1);
+    log_shared_site(logger, 1);
+    EXPECT_TRUE(logger.add_sink(late));
+    for (int i = 2; i < 4; i++) {
+        SLOG_BIN(logger, slog::logger::level::info, "before {}", i);
+        log_shared_site(logger, i);
+    }
+    SLOG_BIN(logger, slog::logger::level::warn, "after {}", 5);
+
+    std::vector<std::string> records = decode(late.stream);
+    ASSERT_EQ(records.size(), 5u);
+    EXPECT_EQ(records[0], "\n[23:25:16.753][INFO ][test_logger] before 2");
+    EXPECT_EQ(records[1], "\n[23:25:16.753][INFO ][test_logger] shared 2");
+    EXPECT_EQ(records[4], "\n[23:25:16.753][WARN ][test_logger] after 5");
+    EXPECT_EQ(decode(first.stream).size(), 7u);
+}
+
+TEST(SmallLogBinaryTest, shared_site) {
+    /* Check a call site used by two loggers is described to both */
+
+    stream_sink first_sink;
+    stream_sink second_sink;
+
+    auto first = slog::binary_logger("first");
+    first.set_tick_source(fixed_ms, 1000);
+    first.add_sink(first_sink);
+    auto second = slog::binary_logger("second");
+    second.set_tick_source(fixed_ms, 1000);
+    second.add_sink(second_sink);
+
+    log_shared_site(first, 1);
+    log_shared_site(second, 2);
+    log_shared_site(first, 3);
+
+    std::vector<std::string> records = decode(second_sink.stream);
+    ASSERT_EQ(records.size(), 1u);
+    EXPECT_EQ(records[0], "\n[23:25:16.753][INFO ][second] shared 2");
+    EXPECT_EQ(decode(first_sink.stream).size(), 2u);
+}
+
+TEST(SmallLogBinaryTest, unknown_site) {
+    /* Check the records of a site never described are skipped, not the rest of the stream */
+
+    stream_sink sink;
+    stream_sink other_sink;
+
+    auto logger = slog::binary_logger("test_logger");
+    logger.set_tick_source(fixed_ms, 1000);
+    logger.add_sink(sink);
+    auto other = slog::binary_logger("other");
+    other.add_sink(other_sink);
+
+    SLOG_BIN(logger, slog::logger::level::info, "first {}", 1);
+    SLOG_BIN(other, slog::logger::level::info, "unknown {} {}", 2, std::string("text"));
+    const size_t unknown_size = slog::bin::record_header_size + sizeof(int64_t) + sizeof(uint16_t) + 4;
+    const std::string unknown = other_sink.stream.substr(other_sink.stream.size() - unknown_size);
+    ASSERT_EQ(unknown[0], slog::bin::record_tag);
+    sink.stream += unknown;
+    SLOG_BIN(logger, slog::logger::level::info, "last {}", 3);
+
+    std::vector<std::string> records;
+    slog::binary_decoder decoder;
+    const size_t used = decoder.decode(sink.stream.data(), sink.stream.size(), [&records](const slog::record& rec) {
+        records.emplace_back(rec.data, rec.size);
+    });
+
+    EXPECT_EQ(used, sink.stream.size());
+    EXPECT_EQ(decoder.get_skipped(), 1u);
+    ASSERT_EQ(records.size(), 2u);
+    EXPECT_EQ(records[1], "\n[23:25:16.753][INFO ][test_logger] last 3");
+}
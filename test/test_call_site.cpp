@@ -0,0 +1,151 @@
+#include "slog.h"
+
+#include "gtest/gtest.h"
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+
+/* Sink that keeps the records and their call sites */
+class site_sink : public slog::sink {
+public:
+    using slog::sink::write;
+
+    void write(const slog::record& rec) override {
+        records.emplace_back(rec.data, rec.size);
+        sites.push_back(rec.site);
+    }
+
+    std::vector<std::string> records;
+    std::vector<const slog::call_site*> sites;
+};
+
+static_assert(std::string_view(slog::file_basename("/src/net/tcp.cpp")) == "tcp.cpp");
+static_assert(std::string_view(slog::file_basename("src\\net\\tcp.cpp")) == "tcp.cpp");
+static_assert(std::string_view(slog::file_basename("tcp.cpp")) == "tcp.cpp");
+
+
+TEST(SmallLogCallSiteTest, text_layout) {
+    /* Check the file name and line follow the logger name */
+
+    site_sink output;
+    auto logger = slog::logger("test_logger");
+    logger.set_print_source(true);
+    logger.add_sink(output);
+
+    const int line = __LINE__ + 1;
+    SLOG_WARN(logger, "disk ") << 93 << "% full";
+    logger.set_print_source(false);
+    SLOG_WARN(logger, "disk ") << 94 << "% full";
+
+    ASSERT_EQ(output.records.size(), 2u);
+    EXPECT_EQ(output.records[0],
+              "\n[WARN ][test_logger][test_call_site.cpp:" + std::to_string(line) + "] disk 93% full");
+    EXPECT_EQ(output.records[1], "\n[WARN ][test_logger] disk 94% full");
+}
+
+TEST(SmallLogCallSiteTest, json_layout) {
+    /* Check the call site members come before the message */
+
+    site_sink output;
+    auto logger = slog::logger("test_logger");
+    logger.set_layout(slog::logger::layout::json);
+    logger.set_print_source(true);
+    logger.add_sink(output);
+
+    const int line = __LINE__ + 1;
+    SLOG_ERROR(logger, "failed").kv("code", 7);
+
+    ASSERT_EQ(output.records.size(), 1u);
+    EXPECT_EQ(output.records[0],
+              "\n{\"level\":\"ERROR\",\"logger\":\"test_logger\",\"file\":\"test_call_site.cpp\",\"line\":" +
+              std::to_string(line) + ",\"func\":\"TestBody\",\"msg\":\"failed\",\"code\":7}");
+}
+
+TEST(SmallLogCallSiteTest, record_site) {
+    /* Check each call site has a single static description handed to the sinks */
+
+    site_sink output;
+    auto logger = slog::logger("test_logger");
+    logger.add_sink(output);
+
+    for (int i = 0; i < 2; ++i) {
+        SLOG_INFO(logger, "first");
+        SLOG_INFO_EVERY_N(logger, 1, "second");
+    }
+    SLOG_LOG(logger, slog::logger::level::info, "runtime level");
+    logger.log(slog::logger::level::info, "direct");
+
+    ASSERT_EQ(output.sites.size(), 6u);
+    ASSERT_NE(output.sites[0], nullptr);
+    ASSERT_NE(output.sites[1], nullptr);
+    EXPECT_EQ(output.sites[0], output.sites[2]);
+    EXPECT_EQ(output.sites[1], output.sites[3]);
+    EXPECT_NE(output.sites[0], output.sites[1]);
+    EXPECT_EQ(output.sites[1]->line, output.sites[0]->line + 1);
+    EXPECT_STREQ(output.sites[0]->file, "test_call_site.cpp");
+    EXPECT_STREQ(output.sites[0]->function, "TestBody");
+    EXPECT_EQ(output.sites[0]->lvl, slog::logger::level::info);
+    /* The generic makros accept runtime levels and carry no call site */
+    EXPECT_EQ(output.sites[4], nullptr);
+    EXPECT_EQ(output.sites[5], nullptr);
+}
+
+TEST(SmallLogCallSiteTest, any_logger_name) {
+    /* Check the makros accept a logger whose variable is not named logger */
+
+    site_sink output;
+    auto net_logger = slog::logger("net");
+    net_logger.set_Level(slog::logger::level::trace);
+    net_logger.add_sink(output);
+
+    SLOG_TRACE(net_logger, "trace");
+    SLOG_DEBUG_RATE(net_logger, 10, 1, "rate");
+    SLOG_FATAL_EVERY_MS(net_logger, 1000, "every ms");
+
+    ASSERT_EQ(output.records.size(), 3u);
+    EXPECT_EQ(output.sites[0]->lvl, slog::logger::level::trace);
+    EXPECT_EQ(output.sites[1]->lvl, slog::logger::level::debug);
+    EXPECT_EQ(output.sites[2]->lvl, slog::logger::level::fatal);
+}
+
+TEST(SmallLogCallSiteTest, async) {
+    /* Check the call site goes through the asynchronous ring */
+
+    static slog::async_slot slots[8];
+    site_sink output;
+    auto logger = slog::logger("test_logger");
+    logger.set_print_source(true);
+    logger.add_sink(output);
+    ASSERT_TRUE(logger.start_async(slots, 8));
+
+    const int line = __LINE__ + 1;
+    SLOG_INFO(logger, "async");
+    logger.flush();
+
+    ASSERT_EQ(output.records.size(), 1u);
+    ASSERT_NE(output.sites[0], nullptr);
+    EXPECT_EQ(output.sites[0]->line, static_cast<uint32_t>(line));
+    EXPECT_EQ(output.records[0], "\n[INFO ][test_logger][test_call_site.cpp:" + std::to_string(line) + "] async");
+}
+
+TEST(SmallLogCallSiteTest, backtrace_replay) {
+    /* Check the records kept raw are replayed with their call site */
+
+    static slog::backtrace_slot slots[8];
+    site_sink output;
+    auto logger = slog::logger("test_logger");
+    logger.set_print_source(true);
+    logger.enable_backtrace(slots, 8);
+    logger.add_sink(output);
+
+    const int line = __LINE__ + 1;
+    SLOG_DEBUG(logger, "value ") << 42;
+    SLOG_ERROR(logger, "trigger");
+
+    ASSERT_EQ(output.records.size(), 2u);
+    EXPECT_EQ(output.records[0], "\n[DEBUG][test_logger][test_call_site.cpp:" + std::to_string(line) + "] value 42");
+    ASSERT_NE(output.sites[0], nullptr);
+    EXPECT_EQ(output.sites[0]->lvl, slog::logger::level::debug);
+}
@@ -0,0 +1,142 @@
+#include "slog.h"
+
+#include "gtest/gtest.h"
+
+#include <string>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <cstdio>
+
+
+/* Sink that stores the records, it is called concurrently in synchronous mode */
+class locked_sink : public slog::sink {
+public:
+    using slog::sink::write;
+
+    void write(const slog::record& rec) override {
+        std::lock_guard<std::mutex> lock(mutex);
+        records.emplace_back(rec.data, rec.size);
+    }
+
+    std::mutex mutex;
+    std::vector<std::string> records;
+};
+
+static constexpr int nbr_threads = 8;
+static constexpr int nbr_records = 2000;
+
+/* Log from several threads at once, each record carries its thread and sequence number in
+ * different radixes so any mixing of the formatting state shows up in the text */
+static void stress(slog::logger& logger) {
+    std::vector<std::thread> threads;
+
+    for (int t = 0; t < nbr_threads; t++) {
+        threads.emplace_back([&logger, t]() {
+            for (int i = 0; i < nbr_records; i++) {
+                if (t % 2 == 0) {
+                    logger.log(slog::logger::level::info, "thread ") << t << " record " << i
+                        << " hex " << slog::logger::radix::hex << i << " end";
+                } else {
+                    logger.log(slog::logger::level::info, "thread ") << t << " record " << i
+                        << " bin " << slog::logger::radix::bin << i << " end";
+                }
+                /* Other threads keep changing the shared logger configuration */
+                logger.set_Level(slog::logger::level::info);
+            }
+        });
+    }
+
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+}
+
+/* Check every record is complete and each thread records arrive in order */
+static void check(const std::vector<std::string>& records) {
+    ASSERT_EQ(records.size(), static_cast<size_t>(nbr_threads * nbr_records));
+
+    int next[nbr_threads] = {0};
+    for (const std::string& rec : records) {
+        int t = -1;
+        int i = -1;
+        int consumed = 0;
+        ASSERT_EQ(std::sscanf(rec.c_str(), "\n[INFO ][stress] thread %d record %d%n", &t, &i, &consumed), 2) << rec;
+        ASSERT_GE(t, 0);
+        ASSERT_LT(t, nbr_threads);
+        EXPECT_EQ(i, next[t]) << rec;
+        next[t] = i + 1;
+
+        /* The radix belongs to the record, so the same value must follow */
+        char expected[80];
+        unsigned int value = static_cast<unsigned int>(i);
+        if (t % 2 == 0) {
+            std::snprintf(expected, sizeof(expected), " hex 0x%X end", value);
+        } else {
+            std::string bits;
+            do {
+                bits.insert(bits.begin(), static_cast<char>('0' + (value & 1u)));
+                value >>= 1u;
+            } while (value != 0);
+            std::snprintf(expected, sizeof(expected), " bin 0b%s end", bits.c_str());
+        }
+        EXPECT_EQ(rec.substr(static_cast<size_t>(consumed)), expected) << rec;
+    }
+}
+
+
+TEST(SmallLogConcurrencyTest, concurrent_producers_sync) {
+    /* Records from concurrent threads are never interleaved in synchronous mode */
+
+    locked_sink sink;
+
+    /* Create a logger */
+    auto logger = slog::logger("stress");
+    logger.add_sink(sink);
+
+    stress(logger);
+    check(sink.records);
+}
+
+TEST(SmallLogConcurrencyTest, concurrent_producers_async) {
+    /* Records from concurrent threads are never interleaved in asynchronous mode */
+
+    static slog::async_slot slots[256];
+    locked_sink sink;
+
+    /* Create a logger */
+    auto logger = slog::logger("stress");
+    logger.add_sink(sink);
+    ASSERT_TRUE(logger.start_async(slots, 256));
+
+    stress(logger);
+    logger.shutdown();
+    check(sink.records);
+}
+
+TEST(SmallLogConcurrencyTest, concurrent_registration) {
+    /* Sinks can be added while other threads are logging */
+
+    locked_sink sinks[MAX_NBR_LOG_APPENDER];
+
+    /* Create a logger */
+    auto logger = slog::logger("stress");
+
+    std::thread producer([&logger]() {
+        for (int i = 0; i < nbr_records; i++) {
+            logger.log(slog::logger::level::info, "record ") << i;
+        }
+    });
+
+    for (locked_sink& sink : sinks) {
+        EXPECT_TRUE(logger.add_sink(sink));
+    }
+    producer.join();
+
+    /* Every record a sink received is complete */
+    for (locked_sink& sink : sinks) {
+        for (const std::string& rec : sink.records) {
+            EXPECT_EQ(rec.rfind("\n[INFO ][stress] record ", 0), 0u) << rec;
+        }
+    }
+}
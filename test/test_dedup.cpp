@@ -0,0 +1,167 @@
+#include "slog.h"
+
+#include "gtest/gtest.h"
+
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+
+/* Sink that keeps the records */
+class dedup_sink : public slog::sink {
+public:
+    using slog::sink::write;
+
+    void write(const slog::record& rec) override {
+        records.emplace_back(rec.data, rec.size);
+    }
+
+    std::vector<std::string> records;
+};
+
+static uint64_t fake_ticks = 0;
+static uint64_t fake_tick_source() {
+    /* one millisecond per call */
+    fake_ticks += 1000;
+    return fake_ticks;
+}
+
+static int provider_calls = 0;
+static slog::timedate counting_time_provider() {
+    /* one millisecond per call */
+    provider_calls += 1;
+    slog::timedate td;
+    td.setMMillisecond(static_cast<uint16_t>(provider_calls));
+    return td;
+}
+
+
+TEST(SmallLogDedupTest, disabled_by_default) {
+    /* Check identical records are all written without a window */
+
+    dedup_sink output;
+    auto logger = slog::logger("test_logger");
+    logger.add_sink(output);
+
+    for (int i = 0; i < 3; ++i) {
+        SLOG_INFO(logger, "same");
+    }
+    EXPECT_EQ(output.records.size(), 3u);
+}
+
+TEST(SmallLogDedupTest, summary_when_the_run_ends) {
+    /* Check the duplicates are suppressed, whatever their timestamp, and reported once */
+
+    dedup_sink output;
+    auto logger = slog::logger("test_logger");
+    logger.set_tick_source(fake_tick_source, 1000000);
+    logger.add_sink(output);
+    logger.set_dedup_window(std::chrono::seconds(60));
+
+    fake_ticks = 0;
+    for (int i = 0; i < 5; ++i) {
+        SLOG_WARN(logger, "link down ") << 3;
+    }
+    SLOG_WARN(logger, "link up ") << 3;
+    SLOG_WARN(logger, "link down ") << 3;
+    SLOG_WARN(logger, "link down ") << 3;
+    SLOG_ERROR(logger, "link down ") << 3;
+
+    ASSERT_EQ(output.records.size(), 6u);
+    EXPECT_EQ(output.records[0], "\n[00:00:00.001][WARN ][test_logger] link down 3");
+    /* The summary is stamped when the run ends, right before the record ending it */
+    EXPECT_EQ(output.records[1], "\n[00:00:00.007][WARN ][test_logger] last message repeated 4 times");
+    EXPECT_EQ(output.records[2], "\n[00:00:00.006][WARN ][test_logger] link up 3");
+    EXPECT_EQ(output.records[3], "\n[00:00:00.008][WARN ][test_logger] link down 3");
+    EXPECT_EQ(output.records[4], "\n[00:00:00.011][WARN ][test_logger] last message repeated 1 time");
+    EXPECT_EQ(output.records[5], "\n[00:00:00.010][ERROR][test_logger] link down 3");
+}
+
+TEST(SmallLogDedupTest, time_provider) {
+    /* Check the time provider is only called for the records written, json layout */
+
+    dedup_sink output;
+    auto logger = slog::logger("test_logger");
+    logger.set_layout(slog::logger::layout::json);
+    logger.set_time_provider(counting_time_provider);
+    logger.add_sink(output);
+    logger.set_dedup_window(std::chrono::seconds(60));
+
+    provider_calls = 0;
+    for (int i = 0; i < 5; ++i) {
+        SLOG_WARN(logger, "link down");
+    }
+    SLOG_WARN(logger, "link up");
+
+    EXPECT_EQ(provider_calls, 3);
+    ASSERT_EQ(output.records.size(), 3u);
+    EXPECT_EQ(output.records[0], "\n{\"time\":\"00:00:00.001\",\"level\":\"WARN\",\"logger\":\"test_logger\",\"msg\":\"link down\"}");
+    EXPECT_EQ(output.records[1], "\n{\"time\":\"00:00:00.002\",\"level\":\"WARN\",\"logger\":\"test_logger\",\"msg\":\"last message repeated 4 times\"}");
+    EXPECT_EQ(output.records[2], "\n{\"time\":\"00:00:00.003\",\"level\":\"WARN\",\"logger\":\"test_logger\",\"msg\":\"link up\"}");
+}
+
+TEST(SmallLogDedupTest, flush_and_destruction) {
+    /* Check a pending run is reported by flush and by the destructor */
+
+    dedup_sink output;
+    {
+        auto logger = slog::logger("test_logger");
+        logger.add_sink(output);
+        logger.set_dedup_window(std::chrono::seconds(60));
+
+        SLOG_INFO(logger, "same");
+        SLOG_INFO(logger, "same");
+        logger.flush();
+        ASSERT_EQ(output.records.size(), 2u);
+        EXPECT_EQ(output.records[1], "\n[INFO ][test_logger] last message repeated 1 time");
+
+        SLOG_INFO(logger, "same");
+        SLOG_INFO(logger, "same");
+        EXPECT_EQ(output.records.size(), 2u);
+    }
+    ASSERT_EQ(output.records.size(), 3u);
+    EXPECT_EQ(output.records[2], "\n[INFO ][test_logger] last message repeated 2 times");
+}
+
+TEST(SmallLogDedupTest, window) {
+    /* Check long runs are reported once per window */
+
+    dedup_sink output;
+    auto logger = slog::logger("test_logger");
+    logger.add_sink(output);
+    logger.set_dedup_window(std::chrono::milliseconds(20));
+
+    SLOG_INFO(logger, "same");
+    SLOG_INFO(logger, "same");
+    SLOG_INFO(logger, "same");
+    std::this_thread::sleep_for(std::chrono::milliseconds(30));
+    SLOG_INFO(logger, "same");
+
+    ASSERT_EQ(output.records.size(), 3u);
+    EXPECT_EQ(output.records[0], "\n[INFO ][test_logger] same");
+    EXPECT_EQ(output.records[1], "\n[INFO ][test_logger] last message repeated 2 times");
+    EXPECT_EQ(output.records[2], "\n[INFO ][test_logger] same");
+}
+
+TEST(SmallLogDedupTest, async) {
+    /* Check the summary keeps its place in asynchronous mode */
+
+    static slog::async_slot slots[16];
+    dedup_sink output;
+    auto logger = slog::logger("test_logger");
+    logger.add_sink(output);
+    logger.set_dedup_window(std::chrono::seconds(60));
+    EXPECT_TRUE(logger.start_async(slots, 16));
+
+    for (int i = 0; i < 100; ++i) {
+        SLOG_INFO(logger, "same");
+    }
+    SLOG_INFO(logger, "other");
+    logger.shutdown();
+
+    ASSERT_EQ(output.records.size(), 3u);
+    EXPECT_EQ(output.records[0], "\n[INFO ][test_logger] same");
+    EXPECT_EQ(output.records[1], "\n[INFO ][test_logger] last message repeated 99 times");
+    EXPECT_EQ(output.records[2], "\n[INFO ][test_logger] other");
+}
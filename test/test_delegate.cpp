@@ -0,0 +1,100 @@
+#include "delegate.h"
+#include "slog.h"
+
+#include "gtest/gtest.h"
+
+#include <cstdint>
+#include <string>
+
+
+static int twice(int value) {
+    return 2 * value;
+}
+
+
+TEST(SmallLogDelegateTest, empty) {
+    /* Check the empty delegates compare to nullptr */
+
+    slog::delegate<int(int)> empty;
+    slog::delegate<int(int)> null_delegate = nullptr;
+    int (*null_function)(int) = nullptr;
+    slog::delegate<int(int)> null_pointer = null_function;
+
+    EXPECT_TRUE(empty == nullptr);
+    EXPECT_TRUE(null_delegate == nullptr);
+    EXPECT_TRUE(null_pointer == nullptr);
+    EXPECT_FALSE(static_cast<bool>(empty));
+}
+
+TEST(SmallLogDelegateTest, callables) {
+    /* Check every kind of callable is called with its arguments */
+
+    slog::delegate<int(int)> function = twice;
+    EXPECT_TRUE(function != nullptr);
+    EXPECT_EQ(function(21), 42);
+
+    slog::delegate<int(int)> captureless = [](int value) { return value + 1; };
+    EXPECT_EQ(captureless(41), 42);
+
+    int offset = 40;
+    slog::delegate<int(int)> by_reference = [&offset](int value) { return value + offset; };
+    offset = 30;
+    EXPECT_EQ(by_reference(12), 42);
+
+    const int64_t a = 10, b = 20, c = 12;
+    slog::delegate<int(int)> by_value = [a, b, c](int value) { return static_cast<int>(a + b + c) * value; };
+    EXPECT_EQ(by_value(1), 42);
+
+    slog::delegate<int(int)> counter = [count = 0](int value) mutable { return count += value; };
+    counter(40);
+    EXPECT_EQ(counter(2), 42);
+
+    /* The return value is converted */
+    slog::delegate<double(int)> converted = twice;
+    EXPECT_EQ(converted(21), 42.0);
+
+    slog::delegate<void(const char*)> appender = [&offset](const char* msg) { offset = static_cast<int>(std::strlen(msg)); };
+    appender("hello");
+    EXPECT_EQ(offset, 5);
+}
+
+TEST(SmallLogDelegateTest, copy) {
+    /* Check copies keep calling the same callable, with their own state */
+
+    int calls = 0;
+    slog::delegate<void()> original = [&calls]() { calls += 1; };
+    slog::delegate<void()> copy = original;
+    original();
+    copy();
+    EXPECT_EQ(calls, 2);
+
+    slog::delegate<int()> counter = [count = 0]() mutable { return ++count; };
+    counter();
+    slog::delegate<int()> counter_copy = counter;
+    EXPECT_EQ(counter(), 2);
+    EXPECT_EQ(counter_copy(), 2);
+
+    copy = nullptr;
+    EXPECT_TRUE(copy == nullptr);
+
+    /* The delegate itself is trivially copyable, it never owns anything */
+    EXPECT_TRUE(std::is_trivially_copyable<slog::delegate<void()>>::value);
+}
+
+TEST(SmallLogDelegateTest, logger) {
+    /* Check the logger takes lambdas capturing state as appenders and time provider */
+
+    auto logger = slog::logger("test_logger");
+    std::string output;
+    int hour = 23;
+
+    EXPECT_TRUE(logger.add_appender([&output](const char* msg) { output += msg; }));
+    logger.set_time_provider([&hour]() {
+        slog::timedate td;
+        td.setMHour(static_cast<uint8_t>(hour));
+        return td;
+    });
+
+    logger.log(slog::logger::level::info, "message");
+    EXPECT_EQ(output, "\n[23:00:00.000][INFO ][test_logger] message");
+}
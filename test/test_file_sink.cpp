@@ -0,0 +1,231 @@
+#include "file_sink.h"
+#include "slog.h"
+
+#include "gtest/gtest.h"
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <unistd.h>
+
+
+/* Temporary file removed at the end of the test */
+class temp_file {
+public:
+    temp_file() {
+        char path[] = "/tmp/slog_file_sink_XXXXXX";
+        int fd = mkstemp(path);
+        if (fd >= 0) {
+            ::close(fd);
+        }
+        m_path = path;
+    }
+    ~temp_file() { std::remove(m_path.c_str()); }
+
+    const char* path() const { return m_path.c_str(); }
+
+    std::string content() const {
+        std::ifstream file(m_path);
+        std::stringstream ss;
+        ss << file.rdbuf();
+        return ss.str();
+    }
+
+private:
+    std::string m_path;
+};
+
+static slog::record make_record(const char* text, slog::level lvl = slog::level::info) {
+    return slog::record{text, std::strlen(text), lvl};
+}
+
+
+TEST(SmallLogFileSinkTest, coalescing) {
+    /* Check small records are gathered in the buffer and written together */
+
+    temp_file file;
+    char buffer[64];
+    slog::file_sink sink(buffer, sizeof(buffer));
+    ASSERT_TRUE(sink.open(file.path(), true));
+
+    /* Nothing written until the buffer is full */
+    for (int i = 0; i < 7; ++i) {
+        sink.write(make_record("\nrecord 0"));
+    }
+    EXPECT_EQ(sink.get_write_calls(), 0u);
+    EXPECT_EQ(file.content(), "");
+
+    /* The 8th record does not fit, the 7 buffered records go in one write */
+    sink.write(make_record("\nrecord 1"));
+    EXPECT_EQ(sink.get_write_calls(), 1u);
+    EXPECT_EQ(file.content().size(), 7 * 9u);
+
+    /* Batches are coalesced too */
+    slog::record batch[] = {make_record("\nrecord 2"), make_record("\nrecord 3")};
+    sink.write(slog::span<const slog::record>(batch, 2));
+    EXPECT_EQ(sink.get_write_calls(), 1u);
+
+    sink.flush();
+    EXPECT_EQ(sink.get_write_calls(), 2u);
+    EXPECT_EQ(file.content(), "\nrecord 0\nrecord 0\nrecord 0\nrecord 0\nrecord 0\nrecord 0\nrecord 0\nrecord 1\nrecord 2\nrecord 3");
+
+    /* Flushing an empty buffer does not write */
+    sink.flush();
+    EXPECT_EQ(sink.get_write_calls(), 2u);
+    EXPECT_EQ(sink.get_dropped_bytes(), 0u);
+}
+
+TEST(SmallLogFileSinkTest, large_record) {
+    /* Check records larger than the buffer are written directly, after the buffered ones */
+
+    temp_file file;
+    char buffer[16];
+    slog::file_sink sink(buffer, sizeof(buffer));
+    ASSERT_TRUE(sink.open(file.path(), true));
+
+    sink.write(make_record("\nsmall"));
+    sink.write(make_record("\nthis record is larger than the buffer"));
+    EXPECT_EQ(sink.get_write_calls(), 2u);
+    EXPECT_EQ(file.content(), "\nsmall\nthis record is larger than the buffer");
+}
+
+TEST(SmallLogFileSinkTest, flush_policy) {
+    /* Check the records flushed right away */
+
+    temp_file file;
+    char buffer[1024];
+    slog::file_sink sink(buffer, sizeof(buffer));
+    ASSERT_TRUE(sink.open(file.path(), true));
+
+    /* Error and fatal records are written with everything buffered before them */
+    sink.write(make_record("\ninfo"));
+    sink.write(make_record("\nwarn", slog::level::warn));
+    EXPECT_EQ(file.content(), "");
+    sink.write(make_record("\nerror", slog::level::error));
+    EXPECT_EQ(sink.get_write_calls(), 1u);
+    EXPECT_EQ(file.content(), "\ninfo\nwarn\nerror");
+    sink.write(make_record("\nfatal", slog::level::fatal));
+    EXPECT_EQ(sink.get_write_calls(), 2u);
+
+    /* The flush level can be changed */
+    sink.set_flush_level(slog::level::warn);
+    sink.write(make_record("\nwarn", slog::level::warn));
+    EXPECT_EQ(sink.get_write_calls(), 3u);
+    sink.set_flush_level(slog::level::disabled);
+    sink.write(make_record("\nfatal", slog::level::fatal));
+    EXPECT_EQ(sink.get_write_calls(), 3u);
+
+    /* A record waiting longer than the interval is written with the next record */
+    sink.set_flush_interval(std::chrono::milliseconds(20));
+    sink.write(make_record("\nfirst"));
+    EXPECT_EQ(sink.get_write_calls(), 3u);
+    std::this_thread::sleep_for(std::chrono::milliseconds(30));
+    sink.write(make_record("\nsecond"));
+    EXPECT_EQ(sink.get_write_calls(), 4u);
+
+    /* The sync policy only adds fdatasync calls */
+    sink.set_sync(true);
+    sink.write(make_record("\nsynced", slog::level::fatal));
+    sink.flush();
+    EXPECT_EQ(file.content(), "\ninfo\nwarn\nerror\nfatal\nwarn\nfatal\nfirst\nsecond\nsynced");
+}
+
+TEST(SmallLogFileSinkTest, flush_timer) {
+    /* Check a quiet logger still writes the records older than the flush interval */
+
+    temp_file file;
+    char buffer[1024];
+    slog::file_sink sink(buffer, sizeof(buffer));
+    ASSERT_TRUE(sink.open(file.path(), true));
+    sink.set_flush_interval(std::chrono::milliseconds(20));
+
+    auto logger = slog::logger("test_logger");
+    logger.add_sink(sink);
+
+    /* Synchronous mode, the application polls */
+    SLOG_INFO(logger, "sync");
+    logger.poll();
+    EXPECT_EQ(file.content(), "");
+    std::this_thread::sleep_for(std::chrono::milliseconds(30));
+    logger.poll();
+    EXPECT_EQ(file.content(), "\n[INFO ][test_logger] sync");
+
+    /* Asynchronous mode, the worker polls without any further record or flush */
+    static slog::async_slot slots[8];
+    ASSERT_TRUE(logger.start_async(slots, 8));
+    SLOG_INFO(logger, "async");
+    for (int i = 0; i < 100 && sink.get_write_calls() < 2; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    EXPECT_EQ(sink.get_write_calls(), 2u);
+    EXPECT_EQ(file.content(), "\n[INFO ][test_logger] sync\n[INFO ][test_logger] async");
+}
+
+TEST(SmallLogFileSinkTest, open_close) {
+    /* Check the file handling */
+
+    temp_file file;
+    char buffer[256];
+
+    {
+        slog::file_sink sink(buffer, sizeof(buffer));
+
+        /* Without a file the records are dropped */
+        sink.write(make_record("\nlost"));
+        sink.flush();
+        EXPECT_EQ(sink.get_dropped_bytes(), 5u);
+
+        EXPECT_FALSE(sink.open("/nonexistent_dir/file.log"));
+        ASSERT_TRUE(sink.open(file.path(), true));
+        sink.write(make_record("\nfirst"));
+
+        /* The destructor writes what is buffered */
+    }
+    EXPECT_EQ(file.content(), "\nfirst");
+
+    /* Append to the existing content by default */
+    slog::file_sink sink(buffer, sizeof(buffer));
+    ASSERT_TRUE(sink.open(file.path()));
+    sink.write(make_record("\nsecond"));
+    sink.close();
+    EXPECT_EQ(file.content(), "\nfirst\nsecond");
+
+    /* Closed sinks drop the records */
+    sink.write(make_record("\nthird"));
+    sink.flush();
+    EXPECT_EQ(sink.get_dropped_bytes(), 6u);
+    EXPECT_EQ(file.content(), "\nfirst\nsecond");
+}
+
+TEST(SmallLogFileSinkTest, logger_output) {
+    /* Check the sink behind a logger, in synchronous and asynchronous mode */
+
+    temp_file file;
+    char buffer[4096];
+    slog::file_sink sink(buffer, sizeof(buffer));
+    ASSERT_TRUE(sink.open(file.path(), true));
+
+    static slog::async_slot slots[64];
+    auto logger = slog::logger("test_logger");
+    EXPECT_TRUE(logger.add_sink(sink));
+
+    logger.log(slog::logger::level::info, "sync ") << 1;
+    logger.flush();
+    EXPECT_EQ(file.content(), "\n[INFO ][test_logger] sync 1");
+
+    EXPECT_TRUE(logger.start_async(slots, 64));
+    for (int i = 0; i < 10; ++i) {
+        logger.log(slog::logger::level::info, "async ") << i;
+    }
+    logger.flush();
+    logger.shutdown();
+
+    std::string expected = "\n[INFO ][test_logger] sync 1";
+    for (int i = 0; i < 10; ++i) {
+        expected += "\n[INFO ][test_logger] async " + std::to_string(i);
+    }
+    EXPECT_EQ(file.content(), expected);
+}
@@ -0,0 +1,230 @@
+#include "flight_recorder.h"
+#include "slog.h"
+
+#include "gtest/gtest.h"
+
+#include <csignal>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <sys/wait.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+
+/* Temporary dump file removed at the end of the test */
+class dump_file {
+public:
+    dump_file() {
+        char path[] = "/tmp/slog_flight_recorder_XXXXXX";
+        m_fd = mkstemp(path);
+        m_path = path;
+    }
+    ~dump_file() {
+        if (m_fd >= 0) {
+            ::close(m_fd);
+        }
+        std::remove(m_path.c_str());
+    }
+
+    int fd() const { return m_fd; }
+
+    std::string content() const {
+        std::ifstream file(m_path, std::ios::binary);
+        std::stringstream ss;
+        ss << file.rdbuf();
+        return ss.str();
+    }
+
+private:
+    int m_fd;
+    std::string m_path;
+};
+
+static slog::record make_record(const std::string& text, slog::level lvl = slog::level::info) {
+    return slog::record{text.data(), text.size(), lvl};
+}
+
+static const std::string dump_begin = "\n--- flight recorder dump begin ---";
+static const std::string dump_end = "\n--- flight recorder dump end ---\n";
+
+
+TEST(SmallLogFlightRecorderTest, keeps_last_records) {
+    /* Check the ring keeps the newest records, oldest first */
+
+    dump_file file;
+    static slog::flight_slot slots[4];
+    slog::flight_recorder recorder(slots, 4);
+
+    for (int i = 0; i < 10; ++i) {
+        recorder.write(make_record("\nrecord " + std::to_string(i)));
+    }
+    EXPECT_EQ(recorder.get_recorded(), 10u);
+
+    recorder.dump(file.fd());
+    EXPECT_EQ(file.content(), dump_begin + "\nrecord 6\nrecord 7\nrecord 8\nrecord 9" + dump_end);
+}
+
+TEST(SmallLogFlightRecorderTest, invalid_storage) {
+    /* Check a recorder without valid storage records nothing but still dumps */
+
+    dump_file file;
+    static slog::flight_slot slots[3];
+    slog::flight_recorder recorder(slots, 3);
+
+    recorder.write(make_record("\nlost"));
+    recorder.dump(file.fd());
+    EXPECT_EQ(file.content(), dump_begin + dump_end);
+}
+
+TEST(SmallLogFlightRecorderTest, capture_below_logger_level) {
+    /* Check the recorder gets the debug records while the other sinks only get warn and above */
+
+    dump_file file;
+    static slog::flight_slot slots[16];
+    slog::flight_recorder recorder(slots, 16);
+    recorder.set_dump_fd(file.fd());
+
+    std::vector<std::string> output;
+    auto logger = slog::logger("test_logger");
+    logger.set_Level(slog::logger::level::warn);
+    logger.add_appender([&output](const char* data) { output.emplace_back(data); });
+    EXPECT_TRUE(logger.add_sink(recorder, slog::logger::level::debug));
+
+    EXPECT_FALSE(logger.is_enabled(slog::logger::level::trace));
+    EXPECT_TRUE(logger.is_enabled(slog::logger::level::debug));
+
+    SLOG_TRACE(logger, "trace");
+    SLOG_DEBUG(logger, "debug");
+    SLOG_INFO(logger, "info");
+    SLOG_WARN(logger, "warn");
+
+    ASSERT_EQ(output.size(), 1u);
+    EXPECT_EQ(output[0], "\n[WARN ][test_logger] warn");
+    EXPECT_EQ(recorder.get_recorded(), 3u);
+    EXPECT_EQ(file.content(), "");
+
+    /* A fatal record reaches every sink and dumps the recorder */
+    SLOG_FATAL(logger, "fatal");
+    ASSERT_EQ(output.size(), 2u);
+    EXPECT_EQ(file.content(), dump_begin +
+                              "\n[DEBUG][test_logger] debug"
+                              "\n[INFO ][test_logger] info"
+                              "\n[WARN ][test_logger] warn"
+                              "\n[FATAL][test_logger] fatal" + dump_end);
+}
+
+TEST(SmallLogFlightRecorderTest, concurrent_writers) {
+    /* Check concurrent writers never leave a torn record in the dump */
+
+    dump_file file;
+    static slog::flight_slot slots[8];
+    slog::flight_recorder recorder(slots, 8);
+    recorder.set_dump_level(slog::level::disabled);
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&recorder, t]() {
+            for (int i = 0; i < 1000; ++i) {
+                recorder.write(make_record("\nthread " + std::to_string(t) + " record " + std::to_string(i)));
+            }
+        });
+    }
+    for (int i = 0; i < 100; ++i) {
+        recorder.dump(file.fd());
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    /* Every line of every dump is either a frame line or a whole record */
+    std::istringstream content(file.content());
+    std::string line;
+    while (std::getline(content, line)) {
+        if (line.empty() || line.rfind("---", 0) == 0) {
+            continue;
+        }
+        int thread_id = -1;
+        int record_id = -1;
+        char rest = 0;
+        EXPECT_EQ(std::sscanf(line.c_str(), "thread %d record %d%c", &thread_id, &record_id, &rest), 2) << line;
+    }
+    EXPECT_EQ(recorder.get_recorded(), 4000u);
+}
+
+TEST(SmallLogFlightRecorderTest, crash_dump) {
+    /* Check the records are dumped when the process crashes */
+
+    dump_file file;
+
+    const pid_t pid = fork();
+    ASSERT_NE(pid, -1);
+    if (pid == 0) {
+        static slog::flight_slot slots[8];
+        slog::flight_recorder recorder(slots, 8);
+        recorder.set_dump_fd(file.fd());
+        if (!recorder.install_crash_handler()) {
+            _exit(1);
+        }
+
+        auto logger = slog::logger("child");
+        logger.set_Level(slog::logger::level::disabled);
+        logger.add_sink(recorder, slog::logger::level::trace);
+        SLOG_DEBUG(logger, "before crash");
+        raise(SIGSEGV);
+        _exit(2);
+    }
+
+    int status = 0;
+    ASSERT_EQ(waitpid(pid, &status, 0), pid);
+    ASSERT_TRUE(WIFSIGNALED(status));
+    EXPECT_EQ(WTERMSIG(status), SIGSEGV);
+
+    EXPECT_EQ(file.content(), dump_begin + "\n[DEBUG][child] before crash" + dump_end);
+}
+
+TEST(SmallLogFlightRecorderTest, crash_handler_chained) {
+    /* Check the handler installed before is called after the dump */
+
+    dump_file file;
+
+    const pid_t pid = fork();
+    ASSERT_NE(pid, -1);
+    if (pid == 0) {
+        static int previous_fd = file.fd();
+        struct sigaction action;
+        std::memset(&action, 0, sizeof(action));
+        sigemptyset(&action.sa_mask);
+        action.sa_handler = [](int signal) {
+            static constexpr char text[] = "previous handler";
+            if (signal == SIGFPE && ::write(previous_fd, text, sizeof(text) - 1) > 0) {
+                _exit(3);
+            }
+            _exit(4);
+        };
+        sigaction(SIGFPE, &action, nullptr);
+
+        static slog::flight_slot slots[8];
+        slog::flight_recorder recorder(slots, 8);
+        recorder.set_dump_fd(file.fd());
+        if (!recorder.install_crash_handler() || !recorder.install_crash_handler()) {
+            _exit(1);
+        }
+
+        auto logger = slog::logger("child");
+        logger.add_sink(recorder);
+        SLOG_INFO(logger, "before crash");
+        raise(SIGFPE);
+        _exit(2);
+    }
+
+    int status = 0;
+    ASSERT_EQ(waitpid(pid, &status, 0), pid);
+    ASSERT_TRUE(WIFEXITED(status));
+    EXPECT_EQ(WEXITSTATUS(status), 3);
+
+    EXPECT_EQ(file.content(), dump_begin + "\n[INFO ][child] before crash" + dump_end + "previous handler");
+}
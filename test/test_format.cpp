@@ -0,0 +1,318 @@
+#include "format.h"
+#include "slog.h"
+
+#include "gtest/gtest.h"
+
+#include <climits>
+#include <cstdint>
+#include <cstdlib>
+#include <limits>
+#include <string>
+
+
+template <typename T>
+static std::string format(T value, uint8_t base, uint8_t width = 0, char fill = ' ', bool uppercase = true) {
+    char out[slog::fmt::max_integer_len];
+    const slog::fmt::int_spec spec = {base, width, fill, uppercase};
+    size_t len = slog::fmt::write_integer(out, value, spec);
+    return std::string(out, len);
+}
+
+template <typename T>
+static std::string format_float(T value, slog::fmt::float_format fmt, uint8_t precision = 6,
+                                uint8_t width = 0, char fill = ' ') {
+    char out[slog::fmt::max_float_len];
+    const slog::fmt::float_spec spec = {fmt, precision, width, fill};
+    size_t len = slog::fmt::write_float(out, value, spec);
+    return std::string(out, len);
+}
+
+
+TEST(SmallLogFormatTest, decimal) {
+    /* Check the decimal rendering against std::to_string over every length */
+
+    EXPECT_EQ(format(0, 10), "0");
+    EXPECT_EQ(format(-1, 10), "-1");
+
+    uint64_t value = 1;
+    for (int i = 0; i < 20; ++i) {
+        EXPECT_EQ(format(value - 1, 10), std::to_string(value - 1));
+        EXPECT_EQ(format(value, 10), std::to_string(value));
+        EXPECT_EQ(format(-static_cast<int64_t>(value / 2), 10), std::to_string(-static_cast<int64_t>(value / 2)));
+        value *= 10;
+    }
+}
+
+TEST(SmallLogFormatTest, extremes) {
+    /* Check the limits of every integral type, including the most negative values */
+
+    EXPECT_EQ(format(INT64_MIN, 10), "-9223372036854775808");
+    EXPECT_EQ(format(INT64_MAX, 10), "9223372036854775807");
+    EXPECT_EQ(format(UINT64_MAX, 10), "18446744073709551615");
+    EXPECT_EQ(format(INT32_MIN, 10), "-2147483648");
+    EXPECT_EQ(format(static_cast<int8_t>(INT8_MIN), 10), "-128");
+    EXPECT_EQ(format(static_cast<int16_t>(INT16_MIN), 10), "-32768");
+
+    EXPECT_EQ(format(UINT64_MAX, 16), "0xFFFFFFFFFFFFFFFF");
+    EXPECT_EQ(format(INT64_MIN, 16), "-0x8000000000000000");
+    EXPECT_EQ(format(UINT64_MAX, 2), "0b" + std::string(64, '1'));
+    EXPECT_EQ(format(INT64_MIN, 2), "-0b1" + std::string(63, '0'));
+    EXPECT_EQ(format(UINT64_MAX, 8), "0o1777777777777777777777");
+}
+
+TEST(SmallLogFormatTest, radix) {
+    /* Check the power of two bases */
+
+    EXPECT_EQ(format(0, 2), "0b0");
+    EXPECT_EQ(format(170, 2), "0b10101010");
+    EXPECT_EQ(format(0, 8), "0o0");
+    EXPECT_EQ(format(170, 8), "0o252");
+    EXPECT_EQ(format(0, 16), "0x0");
+    EXPECT_EQ(format(0xBEEF, 16), "0xBEEF");
+    EXPECT_EQ(format(0xBEEF, 16, 0, ' ', false), "0xbeef");
+    EXPECT_EQ(format(-170, 16), "-0xAA");
+}
+
+TEST(SmallLogFormatTest, width) {
+    /* Check the padding, zeros go after the sign and the prefix, other characters before */
+
+    EXPECT_EQ(format(42, 10, 5), "   42");
+    EXPECT_EQ(format(-42, 10, 5), "  -42");
+    EXPECT_EQ(format(42, 10, 5, '0'), "00042");
+    EXPECT_EQ(format(-42, 10, 5, '0'), "-0042");
+    EXPECT_EQ(format(42, 10, 5, '*'), "***42");
+    EXPECT_EQ(format(0xAA, 16, 6, '0'), "0x00AA");
+
+    /* Values wider than the field are not cut */
+    EXPECT_EQ(format(123456, 10, 3), "123456");
+
+    /* The width is limited by the field buffer */
+    EXPECT_EQ(format(1, 10, 255).size(), slog::fmt::max_integer_len);
+}
+
+TEST(SmallLogFormatTest, float_shortest) {
+    /* Check the shortest format reads back to the same value */
+
+    using slog::fmt::float_format;
+
+    EXPECT_EQ(format_float(0.1, float_format::shortest), "0.1");
+    EXPECT_EQ(format_float(0.1f, float_format::shortest), "0.1");
+    EXPECT_EQ(format_float(-2.5, float_format::shortest), "-2.5");
+    EXPECT_EQ(format_float(0.0, float_format::shortest), "0");
+    EXPECT_EQ(format_float(1e300, float_format::shortest), "1e+300");
+    EXPECT_EQ(format_float(std::numeric_limits<double>::infinity(), float_format::shortest), "inf");
+    EXPECT_EQ(format_float(-std::numeric_limits<double>::infinity(), float_format::shortest), "-inf");
+    EXPECT_EQ(format_float(std::numeric_limits<double>::quiet_NaN(), float_format::shortest), "nan");
+
+    const double values[] = {3.141592653589793, 1.0 / 3.0, 6.02214076e23, -1.602176634e-19,
+                             std::numeric_limits<double>::max(), std::numeric_limits<double>::denorm_min()};
+    for (double value : values) {
+        std::string text = format_float(value, float_format::shortest);
+        EXPECT_EQ(std::strtod(text.c_str(), nullptr), value) << text;
+    }
+}
+
+TEST(SmallLogFormatTest, float_precision) {
+    /* Check the fixed and scientific formats */
+
+    using slog::fmt::float_format;
+
+    EXPECT_EQ(format_float(3.14159, float_format::fixed, 2), "3.14");
+    EXPECT_EQ(format_float(2.5, float_format::fixed, 0), "2");
+    EXPECT_EQ(format_float(-0.125, float_format::fixed, 3), "-0.125");
+    EXPECT_EQ(format_float(1234.5, float_format::scientific, 2), "1.23e+03");
+
+    /* Too long for the fixed format */
+    EXPECT_EQ(format_float(1e300, float_format::fixed, 2), "1.00e+300");
+
+    /* The precision is limited */
+    EXPECT_EQ(format_float(1.0, float_format::fixed, 255), "1." + std::string(slog::fmt::max_float_precision, '0'));
+
+    /* Padding, zeros go after the sign and never in front of nan */
+    EXPECT_EQ(format_float(-1.5, float_format::fixed, 1, 7), "   -1.5");
+    EXPECT_EQ(format_float(-1.5, float_format::fixed, 1, 7, '0'), "-0001.5");
+    EXPECT_EQ(format_float(std::numeric_limits<double>::quiet_NaN(), float_format::shortest, 6, 5, '0'), "  nan");
+}
+
+TEST(SmallLogFormatTest, logger_manipulators) {
+    /* Check the manipulators of the log lines */
+
+    /* Create a logger */
+    auto logger = slog::logger("test_logger");
+
+    /* String to store the log output */
+    std::string out;
+
+    /* Add the appender to the logger */
+    logger.add_appender([&out](const char *msg) { out = msg; });
+
+    logger.log(slog::logger::level::info, "value ") << -42 << " " << INT64_MIN << " " << UINT64_MAX;
+    EXPECT_EQ(out, "\n[INFO ][test_logger] value -42 -9223372036854775808 18446744073709551615");
+
+    /* The width only applies to the next integer, the fill and the letter case to the rest of the line */
+    logger.log(slog::logger::level::info, "value ") << slog::logger::setfill('0') << slog::logger::setw(4)
+        << 7 << " " << 7 << " " << slog::logger::radix::hex << slog::logger::letter_case::lower
+        << slog::logger::setw(6) << 0xAB << " " << 0xCD;
+    EXPECT_EQ(out, "\n[INFO ][test_logger] value 0007 7 0x00ab 0xcd");
+
+    /* Durations are decimal whatever the radix, and keep it */
+    logger.log(slog::logger::level::info, "value ") << slog::logger::radix::hex << std::chrono::milliseconds(-12)
+        << " " << 255;
+    EXPECT_EQ(out, "\n[INFO ][test_logger] value -12ms 0xFF");
+
+    /* Floating point values, the format and precision apply to the rest of the line */
+    logger.log(slog::logger::level::info, "value ") << 0.1 << " " << 2.5f << " "
+        << slog::logger::float_format::fixed << slog::logger::setprecision(3) << 1.0 / 3.0 << " "
+        << slog::logger::setw(8) << -2.0 << " " << slog::logger::float_format::scientific << 1500.0;
+    EXPECT_EQ(out, "\n[INFO ][test_logger] value 0.1 2.5 0.333   -2.000 1.500e+03");
+
+    /* Integers at the end of a full record are truncated like the text */
+    logger.log(slog::logger::level::info, std::string(MAX_LOG_RECORD_LEN, 'x')) << 123;
+    EXPECT_EQ(out.size(), MAX_LOG_RECORD_LEN - 1);
+}
+
+TEST(SmallLogFormatTest, format_string_parsing) {
+    /* Check the compile time parser */
+
+    using slog::fmt::parse_format;
+
+    constexpr slog::fmt::format_info info = parse_format("x={} y={:08.3f} {{}}", nullptr);
+    static_assert(info.valid && info.nbr_args == 2 && info.nbr_pieces == 6, "format parsed at compile time");
+
+    slog::fmt::format_piece pieces[6];
+    parse_format("x={} y={:08.3f} {{}}", pieces);
+    EXPECT_FALSE(pieces[0].is_arg);
+    EXPECT_EQ(pieces[0].len, 2u);
+    EXPECT_TRUE(pieces[3].is_arg);
+    EXPECT_EQ(pieces[3].arg, 1u);
+    EXPECT_EQ(pieces[3].fill, '0');
+    EXPECT_EQ(pieces[3].width, 8);
+    EXPECT_EQ(pieces[3].precision, 3);
+    EXPECT_EQ(pieces[3].type, 'f');
+
+    EXPECT_FALSE(parse_format("{", nullptr).valid);
+    EXPECT_FALSE(parse_format("}", nullptr).valid);
+    EXPECT_FALSE(parse_format("{:q}", nullptr).valid);
+    EXPECT_FALSE(parse_format("{:256}", nullptr).valid);
+    EXPECT_TRUE(parse_format("", nullptr).valid);
+}
+
+TEST(SmallLogFormatTest, logger_logf) {
+    /* Check the formatted records */
+
+    /* Create a logger */
+    auto logger = slog::logger("test_logger");
+
+    /* String to store the log output */
+    std::string out;
+    int nbr_records = 0;
+
+    /* Add the appender to the logger */
+    logger.add_appender([&out, &nbr_records](const char *msg) {
+        out = msg;
+        nbr_records += 1;
+    });
+
+    SLOG_LOGF(logger, slog::logger::level::info, "no arguments");
+    EXPECT_EQ(out, "\n[INFO ][test_logger] no arguments");
+
+    std::string name = "disk";
+    SLOG_LOGF(logger, slog::logger::level::warn, "{} {:s} at {:.1f}% in {}, {{code {:X}}}",
+              name, std::string_view("usage"), 93.25, std::chrono::seconds(5), 0xBEEF);
+    EXPECT_EQ(out, "\n[WARN ][test_logger] disk usage at 93.2% in 5s, {code 0xBEEF}");
+
+    /* Every placeholder starts from the default formatting */
+    SLOG_LOGF(logger, slog::logger::level::info, "{:x} {} {:05} {:b} {:e} {}", 255, 255, -42, 5, 1500.0, 0.1);
+    EXPECT_EQ(out, "\n[INFO ][test_logger] 0xff 255 -0042 0b101 1.500000e+03 0.1");
+
+    /* Filtered records don't evaluate the arguments */
+    nbr_records = 0;
+    int evaluated = 0;
+    SLOG_LOGF(logger, slog::logger::level::debug, "{}", ++evaluated);
+    EXPECT_EQ(evaluated, 0);
+    EXPECT_EQ(nbr_records, 0);
+
+    /* Called directly the level is still checked */
+    logger.logf(slog::logger::level::debug, SLOG_FMT("{}"), 1);
+    EXPECT_EQ(nbr_records, 0);
+    logger.logf(slog::logger::level::error, SLOG_FMT("{}"), 1);
+    EXPECT_EQ(nbr_records, 1);
+    EXPECT_EQ(out, "\n[ERROR][test_logger] 1");
+}
+
+/* Byte by byte reference of the escaping */
+static std::string escape_reference(const std::string& text, bool json) {
+    static const char* const hex = "0123456789abcdef";
+    std::string out;
+
+    for (unsigned char c : text) {
+        if (json && (c == '"' || c == '\\')) {
+            out += '\\';
+            out += static_cast<char>(c);
+        } else if (c == '\n' || c == '\r' || c == '\t') {
+            out += '\\';
+            out += c == '\n' ? 'n' : c == '\r' ? 'r' : 't';
+        } else if (json && (c == '\b' || c == '\f')) {
+            out += c == '\b' ? "\\b" : "\\f";
+        } else if (c < 0x20 || (!json && c == 0x7f)) {
+            out += json ? "\\u00" : "\\x";
+            out += hex[c >> 4];
+            out += hex[c & 0xf];
+        } else {
+            out += static_cast<char>(c);
+        }
+    }
+    return out;
+}
+
+TEST(SmallLogFormatTest, escaping) {
+    /* Check every length and position of the escaped byte, around the 16 and 32 byte blocks */
+
+    const std::string dirty = std::string("\n\r\t\b\f\x01\x1f\x7f\"\\") + "\xc3\xa9\x80\xff";
+    char out[512];
+
+    for (size_t len = 0; len <= 80; ++len) {
+        std::string text;
+        for (size_t i = 0; i < len; ++i) {
+            text += static_cast<char>('a' + i % 26);
+        }
+        EXPECT_EQ(std::string(out, slog::fmt::write_json_escaped(out, sizeof(out), text.data(), text.size())), text);
+        EXPECT_EQ(std::string(out, slog::fmt::write_sanitized(out, sizeof(out), text.data(), text.size())), text);
+
+        for (size_t pos = 0; pos < len; ++pos) {
+            for (char c : dirty) {
+                std::string mixed = text;
+                mixed[pos] = c;
+                EXPECT_EQ(std::string(out, slog::fmt::write_json_escaped(out, sizeof(out), mixed.data(), mixed.size())),
+                          escape_reference(mixed, true));
+                EXPECT_EQ(std::string(out, slog::fmt::write_sanitized(out, sizeof(out), mixed.data(), mixed.size())),
+                          escape_reference(mixed, false));
+            }
+        }
+    }
+
+    /* The output is cut before an escape sequence that doesn't fit */
+    const std::string text = "abc\ndef";
+    EXPECT_EQ(std::string(out, slog::fmt::write_sanitized(out, 4, text.data(), text.size())), "abc");
+    EXPECT_EQ(std::string(out, slog::fmt::write_sanitized(out, 5, text.data(), text.size())), "abc\\n");
+    EXPECT_EQ(std::string(out, slog::fmt::write_json_escaped(out, 8, "\x01\x02", 2)), "\\u0001");
+    EXPECT_EQ(slog::fmt::write_json_escaped(out, 0, text.data(), text.size()), 0u);
+}
+
+TEST(SmallLogFormatTest, logger_sanitize) {
+    /* Check the control characters of the user strings are escaped in the text layout */
+
+    auto logger = slog::logger("test_logger");
+    std::string out;
+    logger.add_appender([&out](const char *msg) { out = msg; });
+
+    logger.log(slog::logger::level::info, "user ") << "mallory\n[INFO ][test_logger] fake\x1b[2J";
+    EXPECT_EQ(out, "\n[INFO ][test_logger] user mallory\n[INFO ][test_logger] fake\x1b[2J");
+
+    logger.set_sanitize(true);
+    logger.log(slog::logger::level::info, "user ") << "mallory\n[INFO ][test_logger] fake\x1b[2J";
+    EXPECT_EQ(out, "\n[INFO ][test_logger] user mallory\\n[INFO ][test_logger] fake\\x1b[2J");
+
+    logger.log(slog::logger::level::info, "tab\t").kv("name", "a\tb") << "ignored";
+    EXPECT_EQ(out, "\n[INFO ][test_logger] tab\\t name=a\\tb");
+}
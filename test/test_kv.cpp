@@ -0,0 +1,225 @@
+#include "slog.h"
+
+#include "gtest/gtest.h"
+
+#include <chrono>
+#include <cmath>
+#include <string>
+#include <vector>
+
+
+/* Sink that keeps the records */
+class kv_sink : public slog::sink {
+public:
+    using slog::sink::write;
+
+    void write(const slog::record& rec) override {
+        records.emplace_back(rec.data, rec.size);
+    }
+
+    std::vector<std::string> records;
+};
+
+static uint64_t fake_ticks = 0;
+static uint64_t fake_tick_source() {
+    /* one millisecond per call */
+    fake_ticks += 1000;
+    return fake_ticks;
+}
+
+/* Log the same fields, used to compare the layouts */
+static void log_request(slog::logger& logger, slog::logger::level log_level) {
+    using namespace std::chrono_literals;
+
+    SLOG_LOG(logger, log_level, "request done").kv("status", 200).kv("latency", 3ms).kv("path", "/index")
+                                               .kv("ok", true).kv("ratio", 0.5).kv("delta", -7);
+}
+
+static void log_quote(slog::logger& logger) {
+    SLOG_DEBUG(logger, "quote \"").kv("user", "o\"brien") << " ignored";
+}
+
+
+TEST(SmallLogKvTest, text_layout) {
+    /* Check the fields follow the message as key=value */
+
+    kv_sink output;
+    auto logger = slog::logger("test_logger");
+    logger.add_sink(output);
+
+    log_request(logger, slog::logger::level::info);
+    SLOG_DEBUG(logger, "filtered").kv("status", 200);
+
+    ASSERT_EQ(output.records.size(), 1u);
+    EXPECT_EQ(output.records[0],
+              "\n[INFO ][test_logger] request done status=200 latency=3ms path=/index ok=true ratio=0.5 delta=-7");
+}
+
+TEST(SmallLogKvTest, json_layout) {
+    /* Check each record is a single line JSON object */
+
+    kv_sink output;
+    auto logger = slog::logger("test_logger");
+    logger.set_tick_source(fake_tick_source, 1000000);
+    logger.set_layout(slog::logger::layout::json);
+    logger.add_sink(output);
+
+    fake_ticks = 0;
+    log_request(logger, slog::logger::level::warn);
+    SLOG_INFO(logger, "no fields");
+
+    ASSERT_EQ(output.records.size(), 2u);
+    EXPECT_EQ(output.records[0],
+              "\n{\"time\":\"00:00:00.001\",\"level\":\"WARN\",\"logger\":\"test_logger\",\"msg\":\"request done\","
+              "\"status\":200,\"latency\":\"3ms\",\"path\":\"/index\",\"ok\":true,\"ratio\":0.5,\"delta\":-7}");
+    EXPECT_EQ(output.records[1],
+              "\n{\"time\":\"00:00:00.002\",\"level\":\"INFO\",\"logger\":\"test_logger\",\"msg\":\"no fields\"}");
+}
+
+TEST(SmallLogKvTest, json_without_time) {
+    /* Check the object starts with the level when there is no time source */
+
+    kv_sink output;
+    auto logger = slog::logger("test_logger");
+    logger.set_layout(slog::logger::layout::json);
+    logger.add_sink(output);
+
+    SLOG_ERROR(logger, "failed ") << 3 << " times";
+
+    ASSERT_EQ(output.records.size(), 1u);
+    EXPECT_EQ(output.records[0], "\n{\"level\":\"ERROR\",\"logger\":\"test_logger\",\"msg\":\"failed 3 times\"}");
+}
+
+TEST(SmallLogKvTest, json_escaping) {
+    /* Check the message and the string values are escaped */
+
+    kv_sink output;
+    auto logger = slog::logger("test_logger");
+    logger.set_layout(slog::logger::layout::json);
+    logger.add_sink(output);
+
+    SLOG_INFO(logger, "say \"hi\"\n") << "back\\slash\t\x01 caf\xc3\xa9";
+    SLOG_INFO(logger, "values").kv("user", "o\"brien").kv("ratio", std::nan("")).kv("limit", -INFINITY);
+
+    ASSERT_EQ(output.records.size(), 2u);
+    EXPECT_EQ(output.records[0], "\n{\"level\":\"INFO\",\"logger\":\"test_logger\","
+                                 "\"msg\":\"say \\\"hi\\\"\\nback\\\\slash\\t\\u0001 caf\xc3\xa9\"}");
+    EXPECT_EQ(output.records[1], "\n{\"level\":\"INFO\",\"logger\":\"test_logger\",\"msg\":\"values\","
+                                 "\"user\":\"o\\\"brien\",\"ratio\":\"nan\",\"limit\":\"-inf\"}");
+}
+
+TEST(SmallLogKvTest, fields_end_the_message) {
+    /* Check the fields are decimal, keep the line format and ignore the following operands */
+
+    kv_sink output;
+    auto logger = slog::logger("test_logger");
+    logger.add_sink(output);
+
+    (logger.log(slog::logger::level::info, "mask ") << slog::logger::radix::hex << 255)
+        .kv("n", 255).kv("width", static_cast<uint8_t>(8)) << " ignored " << 255;
+    SLOG_INFO(logger, "empty").kv("", "value").kv("sep", "");
+
+    ASSERT_EQ(output.records.size(), 2u);
+    EXPECT_EQ(output.records[0], "\n[INFO ][test_logger] mask 0xFF n=255 width=8");
+    EXPECT_EQ(output.records[1], "\n[INFO ][test_logger] empty =value sep=");
+}
+
+TEST(SmallLogKvTest, truncated_json_stays_valid) {
+    /* Check the closing characters are always written and the fields that don't fit are dropped */
+
+    kv_sink output;
+    auto logger = slog::logger("test_logger");
+    logger.set_layout(slog::logger::layout::json);
+    logger.add_sink(output);
+
+    const std::string text(400, 'a');
+    SLOG_INFO(logger, text).kv("status", 200);
+    SLOG_INFO(logger, "quotes ") << std::string(300, '"');
+    SLOG_INFO(logger, text.substr(0, 150)).kv("status", 200).kv("path", text).kv("code", 7);
+
+    ASSERT_EQ(output.records.size(), 3u);
+    for (const std::string& rec : output.records) {
+        EXPECT_LE(rec.size(), MAX_LOG_RECORD_LEN - 1u);
+        EXPECT_EQ(rec.substr(rec.size() - 2), "\"}");
+    }
+    EXPECT_EQ(output.records[0].find("status"), std::string::npos);
+    /* Escape sequences are never cut */
+    EXPECT_EQ(output.records[1].substr(output.records[1].size() - 4), "\\\"\"}");
+    EXPECT_NE(output.records[2].find(",\"status\":200,\"path\":\"aaa"), std::string::npos);
+}
+
+TEST(SmallLogKvTest, suppressed_field) {
+    /* Check the rate limited call sites report the suppressed calls as a field */
+
+    kv_sink output;
+    auto logger = slog::logger("test_logger");
+    logger.set_layout(slog::logger::layout::json);
+    logger.add_sink(output);
+
+    for (int i = 0; i < 4; ++i) {
+        SLOG_INFO_EVERY_N(logger, 3, "loop").kv("i", i);
+    }
+
+    ASSERT_EQ(output.records.size(), 2u);
+    EXPECT_EQ(output.records[0], "\n{\"level\":\"INFO\",\"logger\":\"test_logger\",\"msg\":\"loop\",\"i\":0}");
+    EXPECT_EQ(output.records[1],
+              "\n{\"level\":\"INFO\",\"logger\":\"test_logger\",\"msg\":\"loop\",\"i\":3,\"suppressed\":2}");
+}
+
+TEST(SmallLogKvTest, backtrace_replay) {
+    /* Check the replayed records have the same fields as the formatted ones */
+
+    static slog::backtrace_slot slots[8];
+    kv_sink formatted;
+    kv_sink replayed;
+
+    for (slog::logger::layout record_layout : {slog::logger::layout::text, slog::logger::layout::json}) {
+        auto reference = slog::logger("test_logger");
+        reference.set_tick_source(fake_tick_source, 1000000);
+        reference.set_layout(record_layout);
+        reference.set_Level(slog::logger::level::debug);
+        reference.add_sink(formatted);
+
+        auto logger = slog::logger("test_logger");
+        logger.set_tick_source(fake_tick_source, 1000000);
+        logger.set_layout(record_layout);
+        logger.enable_backtrace(slots, 8);
+        logger.add_sink(replayed);
+
+        fake_ticks = 0;
+        log_request(reference, slog::logger::level::debug);
+        log_quote(reference);
+        fake_ticks = 0;
+        log_request(logger, slog::logger::level::debug);
+        log_quote(logger);
+        SLOG_ERROR(logger, "trigger");
+    }
+
+    ASSERT_EQ(formatted.records.size(), 4u);
+    ASSERT_EQ(replayed.records.size(), 6u);
+    EXPECT_EQ(replayed.records[0], formatted.records[0]);
+    EXPECT_EQ(replayed.records[1], formatted.records[1]);
+    EXPECT_EQ(replayed.records[3], formatted.records[2]);
+    EXPECT_EQ(replayed.records[4], formatted.records[3]);
+    EXPECT_EQ(replayed.records[5].substr(0, 25), "\n{\"time\":\"00:00:00.003\",\"");
+}
+
+TEST(SmallLogKvTest, async_json) {
+    /* Check the worker renders the deferred timestamp inside the object */
+
+    static slog::async_slot slots[8];
+    kv_sink output;
+    auto logger = slog::logger("test_logger");
+    logger.set_tick_source(fake_tick_source, 1000000);
+    logger.set_layout(slog::logger::layout::json);
+    logger.add_sink(output);
+    ASSERT_TRUE(logger.start_async(slots, 8));
+
+    fake_ticks = 0;
+    SLOG_INFO(logger, "async").kv("n", 1);
+    logger.flush();
+
+    ASSERT_EQ(output.records.size(), 1u);
+    EXPECT_EQ(output.records[0],
+              "\n{\"time\":\"00:00:00.001\",\"level\":\"INFO\",\"logger\":\"test_logger\",\"msg\":\"async\",\"n\":1}");
+}
@@ -0,0 +1,202 @@
+#include "slog.h"
+
+#include "gtest/gtest.h"
+
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+
+/* Sink that adds up the size of the records */
+class size_sink : public slog::sink {
+public:
+    using slog::sink::write;
+
+    void write(const slog::record& rec) override {
+        bytes += rec.size;
+    }
+
+    uint64_t bytes = 0;
+};
+
+/* Sink that takes a fixed time per call */
+class slow_sink : public slog::sink {
+public:
+    void write(const slog::record& rec) override {
+        (void)rec;
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+
+    void write(slog::span<const slog::record> records) override {
+        (void)records;
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+};
+
+static size_t level_index(slog::logger::level log_level) {
+    return static_cast<size_t>(log_level);
+}
+
+static_assert(slog::metrics_snapshot::bucket_limit_ns(0) == 1);
+static_assert(slog::metrics_snapshot::bucket_limit_ns(10) == 1024);
+static_assert(slog::metrics_snapshot::bucket_limit_ns(METRICS_LATENCY_BUCKETS - 1) == UINT64_MAX);
+#ifndef SLOG_NO_METRICS
+/* The per logger cost given in the README */
+static_assert(sizeof(slog::logger_metrics) ==
+              64 + 128 * METRICS_SHARDS + 8 * MAX_NBR_LOG_APPENDER * METRICS_LATENCY_BUCKETS);
+#endif
+
+
+TEST(SmallLogMetricsTest, disabled_by_default) {
+    /* Check nothing is counted until the metrics are enabled */
+
+    size_sink output;
+    auto logger = slog::logger("test_logger");
+    logger.add_sink(output);
+
+    SLOG_INFO(logger, "written");
+    SLOG_DEBUG(logger, "filtered");
+
+    const slog::metrics_snapshot snapshot = logger.get_metrics();
+    EXPECT_EQ(snapshot.records[level_index(slog::logger::level::info)], 0u);
+    EXPECT_EQ(snapshot.filtered[level_index(slog::logger::level::debug)], 0u);
+    EXPECT_EQ(snapshot.bytes, 0u);
+    EXPECT_EQ(snapshot.calls(0), 0u);
+    EXPECT_EQ(snapshot.percentile_ns(0, 0.99), 0u);
+}
+
+TEST(SmallLogMetricsTest, counts) {
+    /* Check the records, filtered calls and bytes per level */
+
+#ifdef SLOG_NO_METRICS
+    GTEST_SKIP() << "metrics compiled out";
+#endif
+    size_sink output;
+    auto logger = slog::logger("test_logger");
+    logger.add_sink(output);
+    logger.set_metrics(true);
+
+    SLOG_INFO(logger, "first");
+    SLOG_INFO(logger, "second ") << 2;
+    SLOG_ERROR(logger, "failed");
+    SLOG_DEBUG(logger, "filtered");
+    SLOG_TRACE_EVERY_N(logger, 2, "filtered");
+    logger.log(slog::logger::level::debug, "filtered");
+    logger.logf(slog::logger::level::trace, SLOG_FMT("{}"), 1);
+
+    logger.set_metrics(false);
+    SLOG_INFO(logger, "not counted");
+
+    const slog::metrics_snapshot snapshot = logger.get_metrics();
+    EXPECT_EQ(snapshot.records[level_index(slog::logger::level::info)], 2u);
+    EXPECT_EQ(snapshot.records[level_index(slog::logger::level::error)], 1u);
+    EXPECT_EQ(snapshot.records[level_index(slog::logger::level::debug)], 0u);
+    EXPECT_EQ(snapshot.filtered[level_index(slog::logger::level::debug)], 2u);
+    EXPECT_EQ(snapshot.filtered[level_index(slog::logger::level::trace)], 2u);
+    EXPECT_EQ(snapshot.filtered[level_index(slog::logger::level::info)], 0u);
+    EXPECT_EQ(snapshot.bytes, output.bytes - std::string("\n[INFO ][test_logger] not counted").size());
+    EXPECT_EQ(snapshot.calls(0), 3u);
+    EXPECT_EQ(snapshot.calls(1), 0u);
+}
+
+TEST(SmallLogMetricsTest, sink_latency) {
+    /* Check each slot has its own histogram */
+
+#ifdef SLOG_NO_METRICS
+    GTEST_SKIP() << "metrics compiled out";
+#endif
+    size_sink fast;
+    slow_sink slow;
+    auto logger = slog::logger("test_logger");
+    logger.add_sink(fast);
+    logger.add_sink(slow);
+    logger.set_metrics(true);
+
+    for (int i = 0; i < 4; ++i) {
+        SLOG_WARN(logger, "record");
+    }
+
+    const slog::metrics_snapshot snapshot = logger.get_metrics();
+    EXPECT_EQ(snapshot.calls(0), 4u);
+    EXPECT_EQ(snapshot.calls(1), 4u);
+    EXPECT_GE(snapshot.percentile_ns(1, 0.5), 5000000u);
+    EXPECT_LT(snapshot.percentile_ns(0, 0.5), snapshot.percentile_ns(1, 0.5));
+    EXPECT_EQ(snapshot.percentile_ns(1, 0.0), snapshot.percentile_ns(1, 1.0));
+}
+
+TEST(SmallLogMetricsTest, threads) {
+    /* Check no count is lost, with more threads than shards */
+
+#ifdef SLOG_NO_METRICS
+    GTEST_SKIP() << "metrics compiled out";
+#endif
+    auto logger = slog::logger("test_logger");
+    logger.add_appender([](const char* msg) { (void)msg; });
+    logger.set_metrics(true);
+
+    const int nbr_threads = METRICS_SHARDS + 4;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < nbr_threads; ++t) {
+        threads.emplace_back([&logger]() {
+            for (int i = 0; i < 1000; ++i) {
+                SLOG_INFO(logger, "value ") << i;
+                SLOG_DEBUG(logger, "value ") << i;
+            }
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+
+    const slog::metrics_snapshot snapshot = logger.get_metrics();
+    EXPECT_EQ(snapshot.records[level_index(slog::logger::level::info)], nbr_threads * 1000u);
+    EXPECT_EQ(snapshot.filtered[level_index(slog::logger::level::debug)], nbr_threads * 1000u);
+    EXPECT_EQ(snapshot.calls(0), nbr_threads * 1000u);
+}
+
+TEST(SmallLogMetricsTest, async) {
+    /* Check the worker counts the records and times the batches */
+
+#ifdef SLOG_NO_METRICS
+    GTEST_SKIP() << "metrics compiled out";
+#endif
+    static slog::async_slot slots[16];
+    size_sink output;
+    auto logger = slog::logger("test_logger");
+    logger.add_sink(output);
+    logger.set_metrics(true);
+    ASSERT_TRUE(logger.start_async(slots, 16));
+
+    for (int i = 0; i < 10; ++i) {
+        SLOG_INFO(logger, "async ") << i;
+    }
+    logger.flush();
+
+    const slog::metrics_snapshot snapshot = logger.get_metrics();
+    EXPECT_EQ(snapshot.records[level_index(slog::logger::level::info)], 10u);
+    EXPECT_EQ(snapshot.bytes, output.bytes);
+    EXPECT_GE(snapshot.calls(0), 1u);
+    EXPECT_LE(snapshot.calls(0), 10u);
+    EXPECT_EQ(snapshot.async_dropped, 0u);
+}
+
+TEST(SmallLogMetricsTest, compiled_out) {
+    /* Check the metrics stay empty when they are compiled out */
+
+#ifndef SLOG_NO_METRICS
+    GTEST_SKIP() << "metrics compiled in";
+#endif
+    size_sink output;
+    auto logger = slog::logger("test_logger");
+    logger.add_sink(output);
+    logger.set_metrics(true);
+
+    SLOG_INFO(logger, "written");
+    SLOG_DEBUG(logger, "filtered");
+
+    const slog::metrics_snapshot snapshot = logger.get_metrics();
+    EXPECT_EQ(snapshot.records[level_index(slog::logger::level::info)], 0u);
+    EXPECT_EQ(snapshot.filtered[level_index(slog::logger::level::debug)], 0u);
+    EXPECT_EQ(snapshot.calls(0), 0u);
+}
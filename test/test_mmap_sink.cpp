@@ -0,0 +1,191 @@
+#include "mmap_sink.h"
+#include "slog.h"
+
+#include "gtest/gtest.h"
+
+#include <csignal>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+
+/* Temporary file removed at the end of the test */
+class temp_file {
+public:
+    temp_file() {
+        char path[] = "/tmp/slog_mmap_sink_XXXXXX";
+        int fd = mkstemp(path);
+        if (fd >= 0) {
+            ::close(fd);
+        }
+        m_path = path;
+    }
+    ~temp_file() { std::remove(m_path.c_str()); }
+
+    const char* path() const { return m_path.c_str(); }
+
+    std::string content() const {
+        std::ifstream file(m_path, std::ios::binary);
+        std::stringstream ss;
+        ss << file.rdbuf();
+        return ss.str();
+    }
+
+    off_t size() const {
+        struct stat st;
+        return stat(m_path.c_str(), &st) == 0 ? st.st_size : -1;
+    }
+
+private:
+    std::string m_path;
+};
+
+static slog::record make_record(const std::string& text) {
+    return slog::record{text.data(), text.size(), slog::level::info};
+}
+
+
+TEST(SmallLogMmapSinkTest, write_and_close) {
+    /* Check the records land in the file and close truncates it to their length */
+
+    temp_file file;
+    slog::mmap_sink sink(4096);
+    ASSERT_TRUE(sink.open(file.path(), true));
+
+    /* The whole segment is preallocated */
+    EXPECT_EQ(file.size(), 4096);
+
+    sink.write(make_record("\nfirst"));
+    sink.write(make_record("\nsecond"));
+    EXPECT_EQ(sink.get_size(), 13u);
+
+    /* The records are in the file before close, followed by the preallocated zeros */
+    EXPECT_EQ(file.content().substr(0, 14), std::string("\nfirst\nsecond\0", 14));
+
+    sink.close();
+    EXPECT_EQ(file.content(), "\nfirst\nsecond");
+
+    /* Closed sinks drop the records */
+    sink.write(make_record("\nlost"));
+    EXPECT_EQ(sink.get_dropped_bytes(), 5u);
+
+    /* Append continues after the last record */
+    ASSERT_TRUE(sink.open(file.path()));
+    sink.write(make_record("\nthird"));
+    sink.close();
+    EXPECT_EQ(file.content(), "\nfirst\nsecond\nthird");
+}
+
+TEST(SmallLogMmapSinkTest, roll_segments) {
+    /* Check the sink rolls to new segments without holes */
+
+    temp_file file;
+    slog::mmap_sink sink(MAX_LOG_RECORD_LEN);
+    ASSERT_TRUE(sink.open(file.path(), true));
+
+    std::string expected;
+    for (int i = 0; i < 100; ++i) {
+        std::string text = "\nrecord number " + std::to_string(i);
+        sink.write(make_record(text));
+        expected += text;
+    }
+    EXPECT_GT(sink.get_rolls(), 5u);
+    EXPECT_EQ(sink.get_size(), expected.size());
+
+    sink.close();
+    EXPECT_EQ(file.content(), expected);
+}
+
+TEST(SmallLogMmapSinkTest, concurrent_writers) {
+    /* Check records written by several threads across rolls are all there, complete */
+
+    temp_file file;
+    slog::mmap_sink sink(4096);
+    ASSERT_TRUE(sink.open(file.path(), true));
+
+    auto logger = slog::logger("test_logger");
+    EXPECT_TRUE(logger.add_sink(sink));
+
+    constexpr int nbr_threads = 4;
+    constexpr int nbr_records = 2000;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < nbr_threads; ++t) {
+        threads.emplace_back([&logger, t]() {
+            for (int i = 0; i < nbr_records; ++i) {
+                logger.log(slog::logger::level::info, "thread ") << t << " record " << i << " end";
+            }
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    sink.close();
+
+    const std::string content = file.content();
+    EXPECT_EQ(content.find('\0'), std::string::npos);
+
+    int count[nbr_threads] = {};
+    std::istringstream lines(content);
+    std::string line;
+    std::getline(lines, line); /* every record starts with a new line */
+    while (std::getline(lines, line)) {
+        int t = -1;
+        int i = -1;
+        ASSERT_EQ(std::sscanf(line.c_str(), "[INFO ][test_logger] thread %d record %d end", &t, &i), 2) << line;
+        ASSERT_TRUE(t >= 0 && t < nbr_threads);
+        /* each thread records are in order */
+        EXPECT_EQ(i, count[t]);
+        count[t] += 1;
+    }
+    for (int t = 0; t < nbr_threads; ++t) {
+        EXPECT_EQ(count[t], nbr_records);
+    }
+}
+
+TEST(SmallLogMmapSinkTest, crash_consistency) {
+    /* Check the records written before a crash survive it, and appending recovers the file */
+
+    temp_file file;
+    std::string expected;
+    for (int i = 0; i < 50; ++i) {
+        expected += "\nbefore crash " + std::to_string(i);
+    }
+
+    const pid_t pid = fork();
+    ASSERT_NE(pid, -1);
+    if (pid == 0) {
+        /* The child logs and dies without closing the sink */
+        slog::mmap_sink sink(MAX_LOG_RECORD_LEN * 2);
+        if (!sink.open(file.path(), true)) {
+            _exit(1);
+        }
+        for (int i = 0; i < 50; ++i) {
+            sink.write(make_record("\nbefore crash " + std::to_string(i)));
+        }
+        std::abort();
+    }
+
+    int status = 0;
+    ASSERT_EQ(waitpid(pid, &status, 0), pid);
+    ASSERT_TRUE(WIFSIGNALED(status));
+    EXPECT_EQ(WTERMSIG(status), SIGABRT);
+
+    /* Every record is there, followed by the zeros of the preallocated segment */
+    const std::string content = file.content();
+    ASSERT_GE(content.size(), expected.size());
+    EXPECT_EQ(content.substr(0, expected.size()), expected);
+    EXPECT_EQ(content.find_first_not_of('\0', expected.size()), std::string::npos);
+
+    /* Appending trims the zeros and continues after the last record */
+    slog::mmap_sink sink(MAX_LOG_RECORD_LEN * 2);
+    ASSERT_TRUE(sink.open(file.path()));
+    sink.write(make_record("\nafter crash"));
+    sink.close();
+    EXPECT_EQ(file.content(), expected + "\nafter crash");
+}
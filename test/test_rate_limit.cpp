@@ -0,0 +1,192 @@
+#include "slog.h"
+
+#include "gtest/gtest.h"
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+
+/* Sink that keeps the records */
+class rate_sink : public slog::sink {
+public:
+    using slog::sink::write;
+
+    void write(const slog::record& rec) override {
+        records.emplace_back(rec.data, rec.size);
+    }
+
+    std::vector<std::string> records;
+};
+
+static constexpr uint64_t ms = 1000000;
+
+
+TEST(SmallLogRateLimitTest, every_n_site) {
+    /* Check the first call and then one call out of n are allowed */
+
+    slog::every_n_site site;
+    std::vector<uint64_t> suppressed;
+    for (int i = 0; i < 10; ++i) {
+        uint64_t count = 0;
+        if (site.allow(4, count)) {
+            suppressed.push_back(count);
+        }
+    }
+    EXPECT_EQ(suppressed, std::vector<uint64_t>({0, 3, 3}));
+
+    /* 0 and 1 allow every call */
+    slog::every_n_site every;
+    for (int i = 0; i < 5; ++i) {
+        uint64_t count = 0;
+        EXPECT_TRUE(every.allow(i % 2, count));
+        EXPECT_EQ(count, 0u);
+    }
+}
+
+TEST(SmallLogRateLimitTest, every_ms_site) {
+    /* Check at most one call per interval is allowed */
+
+    slog::every_ms_site site;
+    uint64_t suppressed = 0;
+
+    EXPECT_TRUE(site.allow(10, 1000 * ms, suppressed));
+    EXPECT_EQ(suppressed, 0u);
+    EXPECT_FALSE(site.allow(10, 1001 * ms, suppressed));
+    EXPECT_FALSE(site.allow(10, 1009 * ms, suppressed));
+    EXPECT_TRUE(site.allow(10, 1010 * ms, suppressed));
+    EXPECT_EQ(suppressed, 2u);
+
+    /* The interval starts from the allowed call */
+    EXPECT_FALSE(site.allow(10, 1019 * ms, suppressed));
+    EXPECT_TRUE(site.allow(10, 1050 * ms, suppressed));
+    EXPECT_EQ(suppressed, 1u);
+}
+
+TEST(SmallLogRateLimitTest, token_bucket_site) {
+    /* Check the burst is allowed right away and the tokens refill at the rate */
+
+    slog::token_bucket_site site;
+    uint64_t suppressed = 0;
+    int allowed = 0;
+
+    /* 100 records per second, bursts of 5 */
+    for (int i = 0; i < 20; ++i) {
+        allowed += site.allow(100, 5, 1000 * ms, suppressed) ? 1 : 0;
+    }
+    EXPECT_EQ(allowed, 5);
+
+    /* One token every 10 ms */
+    EXPECT_FALSE(site.allow(100, 5, 1009 * ms, suppressed));
+    EXPECT_TRUE(site.allow(100, 5, 1010 * ms, suppressed));
+    EXPECT_EQ(suppressed, 16u);
+    EXPECT_FALSE(site.allow(100, 5, 1010 * ms, suppressed));
+
+    /* A quiet period refills the bucket up to the burst */
+    allowed = 0;
+    for (int i = 0; i < 20; ++i) {
+        allowed += site.allow(100, 5, 2000 * ms, suppressed) ? 1 : 0;
+    }
+    EXPECT_EQ(allowed, 5);
+
+    /* A rate of 0 suppresses every call */
+    slog::token_bucket_site closed;
+    EXPECT_FALSE(closed.allow(0, 5, 1000 * ms, suppressed));
+}
+
+TEST(SmallLogRateLimitTest, every_n_makro) {
+    /* Check suppressed calls are not formatted and the count is reported */
+
+    rate_sink output;
+    auto logger = slog::logger("test_logger");
+    logger.add_sink(output);
+
+    int nbr_evaluations = 0;
+    auto side_effect = [&nbr_evaluations]() {
+        nbr_evaluations += 1;
+        return 0xff;
+    };
+
+    for (int i = 0; i < 7; ++i) {
+        SLOG_WARN_EVERY_N(logger, 3, "loop ") << slog::logger::radix::hex << side_effect();
+    }
+    EXPECT_EQ(nbr_evaluations, 3);
+    ASSERT_EQ(output.records.size(), 3u);
+    EXPECT_EQ(output.records[0], "\n[WARN ][test_logger] loop 0xFF");
+    EXPECT_EQ(output.records[1], "\n[WARN ][test_logger] loop 0xFF [2 suppressed]");
+    EXPECT_EQ(output.records[2], "\n[WARN ][test_logger] loop 0xFF [2 suppressed]");
+
+    /* Filtered calls are neither counted nor formatted */
+    logger.set_Level(slog::logger::level::error);
+    for (int i = 0; i < 7; ++i) {
+        SLOG_WARN_EVERY_N(logger, 3, "filtered ") << side_effect();
+    }
+    EXPECT_EQ(nbr_evaluations, 3);
+    EXPECT_EQ(output.records.size(), 3u);
+
+    /* Each call site has its own state */
+    logger.set_Level(slog::logger::level::info);
+    for (int i = 0; i < 2; ++i) {
+        SLOG_INFO_EVERY_N(logger, 100, "first site");
+        SLOG_INFO_EVERY_N(logger, 100, "second site");
+    }
+    ASSERT_EQ(output.records.size(), 5u);
+    EXPECT_EQ(output.records[3], "\n[INFO ][test_logger] first site");
+    EXPECT_EQ(output.records[4], "\n[INFO ][test_logger] second site");
+}
+
+TEST(SmallLogRateLimitTest, time_makros) {
+    /* Check the time based makros let the first call through and suppress the burst after it */
+
+    rate_sink output;
+    auto logger = slog::logger("test_logger");
+    logger.add_sink(output);
+
+    for (int i = 0; i < 100; ++i) {
+        SLOG_INFO_EVERY_MS(logger, 60000, "every minute ") << i;
+        SLOG_ERROR_RATE(logger, 1, 3, "rate ") << i;
+    }
+    ASSERT_EQ(output.records.size(), 4u);
+    EXPECT_EQ(output.records[0], "\n[INFO ][test_logger] every minute 0");
+    EXPECT_EQ(output.records[1], "\n[ERROR][test_logger] rate 0");
+    EXPECT_EQ(output.records[2], "\n[ERROR][test_logger] rate 1");
+    EXPECT_EQ(output.records[3], "\n[ERROR][test_logger] rate 2");
+
+    /* Unbraced if statements keep working */
+    bool enabled = false;
+    if (enabled)
+        SLOG_INFO_EVERY_MS(logger, 0, "not logged");
+    else
+        SLOG_INFO_EVERY_MS(logger, 0, "logged");
+    EXPECT_EQ(output.records.back(), "\n[INFO ][test_logger] logged");
+}
+
+TEST(SmallLogRateLimitTest, concurrent_calls) {
+    /* Check no call is lost when threads share a call site */
+
+    std::atomic<int> nbr_records(0);
+    std::atomic<uint64_t> nbr_suppressed(0);
+    slog::every_ms_site site;
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&]() {
+            for (int i = 0; i < 10000; ++i) {
+                uint64_t suppressed = 0;
+                if (site.allow(1, slog::steady_clock_ns(), suppressed)) {
+                    nbr_records += 1;
+                    nbr_suppressed += suppressed;
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    /* The calls suppressed after the last record are still pending */
+    uint64_t pending = 0;
+    EXPECT_TRUE(site.allow(0, UINT64_MAX, pending));
+    EXPECT_EQ(nbr_records + nbr_suppressed + pending, 40000u);
+}
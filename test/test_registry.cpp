@@ -0,0 +1,210 @@
+#include "registry.h"
+
+#include "gtest/gtest.h"
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+
+TEST(SmallLogRegistryTest, find) {
+    /* Check the loggers are found by name */
+
+    slog::registry reg;
+    auto net = slog::logger("net");
+    auto tcp = slog::logger("net.tcp");
+    auto rx = slog::logger("net.tcp.rx");
+
+    EXPECT_TRUE(reg.add(net));
+    EXPECT_TRUE(reg.add(tcp));
+    EXPECT_TRUE(reg.add(rx));
+    EXPECT_EQ(reg.size(), 3u);
+
+    EXPECT_EQ(reg.find("net"), &net);
+    EXPECT_EQ(reg.find("net.tcp"), &tcp);
+    EXPECT_EQ(reg.find("net.tcp.rx"), &rx);
+    EXPECT_EQ(reg.find("net.udp"), nullptr);
+
+    /* The hash can be computed at compile time */
+    constexpr uint64_t hash = slog::name_hash("net.tcp.rx");
+    EXPECT_EQ(reg.find("net.tcp.rx", hash), &rx);
+
+    /* Names are unique */
+    auto other = slog::logger("net.tcp");
+    EXPECT_FALSE(reg.add(other));
+
+    /* Removed loggers are not found, the others still are */
+    EXPECT_TRUE(reg.remove(tcp));
+    EXPECT_FALSE(reg.remove(tcp));
+    EXPECT_EQ(reg.find("net.tcp"), nullptr);
+    EXPECT_EQ(reg.find("net.tcp.rx"), &rx);
+    EXPECT_TRUE(reg.add(other));
+    EXPECT_EQ(reg.find("net.tcp"), &other);
+    EXPECT_EQ(reg.size(), 3u);
+}
+
+TEST(SmallLogRegistryTest, capacity) {
+    /* Check the registry refuses loggers past its capacity, also after removals */
+
+    slog::registry reg;
+    std::vector<std::unique_ptr<slog::logger>> loggers;
+    for (int i = 0; i <= MAX_REGISTERED_LOGGERS; ++i) {
+        loggers.emplace_back(new slog::logger(("logger." + std::to_string(i)).c_str()));
+    }
+
+    for (int round = 0; round < 3; ++round) {
+        for (int i = 0; i < MAX_REGISTERED_LOGGERS; ++i) {
+            EXPECT_TRUE(reg.add(*loggers[i]));
+        }
+        EXPECT_FALSE(reg.add(*loggers[MAX_REGISTERED_LOGGERS]));
+
+        for (int i = 0; i < MAX_REGISTERED_LOGGERS; ++i) {
+            EXPECT_EQ(reg.find(loggers[i]->get_name()), loggers[i].get());
+            EXPECT_TRUE(reg.remove(*loggers[i]));
+        }
+        EXPECT_EQ(reg.size(), 0u);
+    }
+}
+
+TEST(SmallLogRegistryTest, churn) {
+    /* Check the slots of the removed loggers are reclaimed, with many distinct names */
+
+    slog::registry reg;
+    auto resident = slog::logger("resident");
+    EXPECT_TRUE(reg.add(resident));
+
+    for (int i = 0; i < 16 * MAX_REGISTERED_LOGGERS; ++i) {
+        auto temporary = slog::logger(("temporary." + std::to_string(i)).c_str());
+        ASSERT_TRUE(reg.add(temporary)) << i;
+        EXPECT_EQ(reg.find(temporary.get_name()), &temporary);
+        EXPECT_TRUE(reg.remove(temporary));
+        EXPECT_EQ(reg.find("resident"), &resident);
+    }
+    EXPECT_EQ(reg.size(), 1u);
+}
+
+TEST(SmallLogRegistryTest, concurrent_churn) {
+    /* Check the lookups keep finding a logger while the table is rebuilt */
+
+    slog::registry reg;
+    auto resident = slog::logger("resident");
+    reg.add(resident);
+
+    std::atomic<bool> stop(false);
+    std::atomic<int> misses(0);
+    std::thread reader([&]() {
+        while (!stop.load()) {
+            if (reg.find("resident") != &resident) {
+                misses.fetch_add(1);
+            }
+        }
+    });
+
+    for (int i = 0; i < 16 * MAX_REGISTERED_LOGGERS; ++i) {
+        auto temporary = slog::logger(("temporary." + std::to_string(i)).c_str());
+        EXPECT_TRUE(reg.add(temporary));
+        EXPECT_TRUE(reg.remove(temporary));
+    }
+    stop.store(true);
+    reader.join();
+
+    EXPECT_EQ(misses.load(), 0);
+}
+
+TEST(SmallLogRegistryTest, inherited_levels) {
+    /* Check the most specific pattern decides the level */
+
+    slog::registry reg;
+    auto app = slog::logger("app");
+    auto net = slog::logger("net");
+    auto tcp = slog::logger("net.tcp");
+    auto rx = slog::logger("net.tcp.rx");
+    auto network = slog::logger("network");
+    reg.add(app);
+    reg.add(net);
+    reg.add(tcp);
+    reg.add(rx);
+    reg.add(network);
+
+    /* A logger name sets it and its descendants */
+    EXPECT_TRUE(reg.set_level("net", slog::level::warn));
+    EXPECT_EQ(app.get_Level(), slog::level::info);
+    EXPECT_EQ(net.get_Level(), slog::level::warn);
+    EXPECT_EQ(tcp.get_Level(), slog::level::warn);
+    EXPECT_EQ(rx.get_Level(), slog::level::warn);
+    EXPECT_EQ(network.get_Level(), slog::level::info);
+
+    /* The wildcard only sets the descendants */
+    EXPECT_TRUE(reg.set_level("net.*", slog::level::debug));
+    EXPECT_EQ(net.get_Level(), slog::level::warn);
+    EXPECT_EQ(tcp.get_Level(), slog::level::debug);
+    EXPECT_EQ(rx.get_Level(), slog::level::debug);
+    EXPECT_TRUE(rx.is_enabled(slog::level::debug));
+
+    /* A more specific pattern wins, whatever the order */
+    EXPECT_TRUE(reg.set_level("net.tcp.rx", slog::level::error));
+    EXPECT_TRUE(reg.set_level("*", slog::level::trace));
+    EXPECT_EQ(app.get_Level(), slog::level::trace);
+    EXPECT_EQ(network.get_Level(), slog::level::trace);
+    EXPECT_EQ(net.get_Level(), slog::level::warn);
+    EXPECT_EQ(tcp.get_Level(), slog::level::debug);
+    EXPECT_EQ(rx.get_Level(), slog::level::error);
+
+    /* Changing a pattern updates its loggers */
+    EXPECT_TRUE(reg.set_level("net.*", slog::level::fatal));
+    EXPECT_EQ(tcp.get_Level(), slog::level::fatal);
+    EXPECT_EQ(rx.get_Level(), slog::level::error);
+
+    /* Loggers added later get the level of their patterns */
+    auto udp = slog::logger("net.udp");
+    EXPECT_TRUE(reg.add(udp));
+    EXPECT_EQ(udp.get_Level(), slog::level::fatal);
+}
+
+TEST(SmallLogRegistryTest, invalid_patterns) {
+    /* Check the wildcard is only accepted alone or after a dot at the end */
+
+    slog::registry reg;
+    EXPECT_FALSE(reg.set_level("", slog::level::debug));
+    EXPECT_FALSE(reg.set_level("net*", slog::level::debug));
+    EXPECT_FALSE(reg.set_level("*.tcp", slog::level::debug));
+    EXPECT_FALSE(reg.set_level("net.*.rx", slog::level::debug));
+    EXPECT_FALSE(reg.set_level(std::string(MAX_LOG_NAME_LEN + 2, 'x'), slog::level::debug));
+
+    for (int i = 0; i < MAX_LEVEL_RULES; ++i) {
+        EXPECT_TRUE(reg.set_level("rule" + std::to_string(i), slog::level::debug));
+    }
+    EXPECT_FALSE(reg.set_level("one.more", slog::level::debug));
+    EXPECT_TRUE(reg.set_level("rule0", slog::level::warn));
+}
+
+TEST(SmallLogRegistryTest, concurrent_lookup) {
+    /* Check lookups run while loggers are added and their levels change */
+
+    slog::registry reg;
+    auto net = slog::logger("net");
+    reg.add(net);
+
+    std::atomic<bool> stop(false);
+    std::thread reader([&]() {
+        while (!stop.load()) {
+            EXPECT_EQ(reg.find("net"), &net);
+        }
+    });
+
+    std::vector<std::unique_ptr<slog::logger>> loggers;
+    for (int i = 0; i < 32; ++i) {
+        loggers.emplace_back(new slog::logger(("net.child" + std::to_string(i)).c_str()));
+        EXPECT_TRUE(reg.add(*loggers.back()));
+        EXPECT_TRUE(reg.set_level("net.*", i % 2 == 0 ? slog::level::debug : slog::level::error));
+    }
+    stop.store(true);
+    reader.join();
+
+    for (auto& child : loggers) {
+        EXPECT_EQ(child->get_Level(), slog::level::error);
+        EXPECT_EQ(reg.find(child->get_name()), child.get());
+    }
+}
@@ -0,0 +1,300 @@
+#include "rotating_sink.h"
+#include "slog.h"
+
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <dirent.h>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+
+/* Temporary directory removed, with its files, at the end of the test */
+class temp_dir {
+public:
+    temp_dir() {
+        char path[] = "/tmp/slog_rotating_XXXXXX";
+        m_path = mkdtemp(path) != nullptr ? path : "/tmp";
+    }
+    ~temp_dir() {
+        for (const std::string& name : files()) {
+            std::remove((m_path + "/" + name).c_str());
+        }
+        rmdir(m_path.c_str());
+    }
+
+    std::string path(const char* name) const { return m_path + "/" + name; }
+
+    /* file names, sorted */
+    std::vector<std::string> files() const {
+        std::vector<std::string> names;
+        DIR* dir = opendir(m_path.c_str());
+        if (dir != nullptr) {
+            while (dirent* entry = readdir(dir)) {
+                std::string name = entry->d_name;
+                if (name != "." && name != "..") {
+                    names.push_back(name);
+                }
+            }
+            closedir(dir);
+        }
+        std::sort(names.begin(), names.end());
+        return names;
+    }
+
+    void create(const std::string& name, const std::string& text) const {
+        std::ofstream file(m_path + "/" + name);
+        file << text;
+    }
+
+    std::string content(const std::string& name) const {
+        std::ifstream file(m_path + "/" + name);
+        std::stringstream ss;
+        ss << file.rdbuf();
+        return ss.str();
+    }
+
+private:
+    std::string m_path;
+};
+
+/* Time provider moving one second per call, so each rotated file gets its own name */
+static slog::timedate next_second() {
+    static int counter = 0;
+    slog::timedate td;
+    td.setMYear(2024);
+    td.setMMonth(1);
+    td.setMDay(30);
+    td.setMHour(23);
+    td.setMMinute(static_cast<uint8_t>(counter / 60));
+    td.setMSecond(static_cast<uint8_t>(counter % 60));
+    counter += 1;
+    return td;
+}
+
+/* Time provider stuck at one millisecond, like a coarse clock */
+static slog::timedate same_time() {
+    slog::timedate td;
+    td.setMYear(2024);
+    td.setMMonth(1);
+    td.setMDay(30);
+    td.setMHour(23);
+    td.setMMinute(25);
+    td.setMSecond(16);
+    return td;
+}
+
+static slog::record make_record(const std::string& text) {
+    return slog::record{text.data(), text.size(), slog::level::info};
+}
+
+
+TEST(SmallLogRotatingSinkTest, size_rotation) {
+    /* Check the files are rotated by size and only the last generations are kept */
+
+    temp_dir dir;
+    slog::rotating_file_sink sink;
+    sink.set_max_size(30);
+    sink.set_max_files(2);
+    sink.set_time_provider(next_second);
+    ASSERT_TRUE(sink.open(dir.path("app.log").c_str()));
+
+    /* 3 records of 10 bytes per file, flush waits for each rotation */
+    for (int i = 0; i < 12; ++i) {
+        char text[16];
+        std::snprintf(text, sizeof(text), "\nrecord %02d", i);
+        sink.write(make_record(text));
+        sink.flush();
+    }
+    EXPECT_EQ(sink.get_rotations(), 3u);
+    sink.close();
+
+    /* The active file and the 2 last generations, the first one was deleted */
+    const std::vector<std::string> files = dir.files();
+    ASSERT_EQ(files.size(), 3u);
+    EXPECT_EQ(files[0], "app.log");
+    EXPECT_EQ(dir.content(files[0]), "\nrecord 09\nrecord 10\nrecord 11");
+    EXPECT_EQ(files[1].substr(0, 8), "app.log.");
+    EXPECT_EQ(dir.content(files[1]), "\nrecord 03\nrecord 04\nrecord 05");
+    EXPECT_EQ(dir.content(files[2]), "\nrecord 06\nrecord 07\nrecord 08");
+    EXPECT_LT(files[1], files[2]);
+    EXPECT_EQ(sink.get_dropped_bytes(), 0u);
+}
+
+TEST(SmallLogRotatingSinkTest, time_rotation) {
+    /* Check the files are rotated by the first record after the interval */
+
+    temp_dir dir;
+    slog::rotating_file_sink sink;
+    sink.set_interval(std::chrono::seconds(1));
+    sink.set_time_provider(next_second);
+    ASSERT_TRUE(sink.open(dir.path("app.log").c_str()));
+
+    sink.write(make_record("\nfirst"));
+    sink.flush();
+    EXPECT_EQ(sink.get_rotations(), 0u);
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(1100));
+    sink.write(make_record("\nsecond"));
+    sink.flush();
+    EXPECT_EQ(sink.get_rotations(), 1u);
+    sink.close();
+
+    const std::vector<std::string> files = dir.files();
+    ASSERT_EQ(files.size(), 2u);
+    EXPECT_EQ(dir.content(files[0]), "\nsecond");
+    EXPECT_EQ(dir.content(files[1]), "\nfirst");
+}
+
+TEST(SmallLogRotatingSinkTest, same_time_rotation) {
+    /* Check the rotations done at the same time don't overwrite each other */
+
+    temp_dir dir;
+    slog::rotating_file_sink sink;
+    sink.set_max_size(10);
+    sink.set_max_files(3);
+    sink.set_time_provider(same_time);
+    ASSERT_TRUE(sink.open(dir.path("app.log").c_str()));
+
+    for (int i = 0; i < 5; ++i) {
+        char text[16];
+        std::snprintf(text, sizeof(text), "\nrecord %02d", i);
+        sink.write(make_record(text));
+        sink.flush();
+    }
+    EXPECT_EQ(sink.get_rotations(), 4u);
+    sink.close();
+
+    /* The first generation was deleted, its name is free again */
+    const std::vector<std::string> files = dir.files();
+    ASSERT_EQ(files.size(), 4u);
+    EXPECT_EQ(dir.content("app.log"), "\nrecord 04");
+    EXPECT_EQ(dir.content("app.log.2024-01-30_23-25-16.000"), "\nrecord 03");
+    EXPECT_EQ(dir.content("app.log.2024-01-30_23-25-16.000.1"), "\nrecord 01");
+    EXPECT_EQ(dir.content("app.log.2024-01-30_23-25-16.000.2"), "\nrecord 02");
+}
+
+TEST(SmallLogRotatingSinkTest, standby_left_over) {
+    /* Check the records of a standby file left by a crash are kept on open */
+
+    temp_dir dir;
+    dir.create("app.log", "\nold");
+    dir.create("app.log.next", "\nswitched");
+    dir.create("other.log.next", "\nuntouched");
+
+    slog::rotating_file_sink sink;
+    ASSERT_TRUE(sink.open(dir.path("app.log").c_str()));
+    sink.write(make_record("\nnew"));
+    sink.close();
+
+    EXPECT_EQ(dir.content("app.log"), "\nold\nswitched\nnew");
+    EXPECT_EQ(dir.content("other.log.next"), "\nuntouched");
+
+    /* Stopped between the two renames, the standby file is the only one left */
+    temp_dir renamed_dir;
+    renamed_dir.create("app.log.next", "\nswitched");
+    ASSERT_TRUE(sink.open(renamed_dir.path("app.log").c_str()));
+    sink.close();
+    EXPECT_EQ(renamed_dir.content("app.log"), "\nswitched");
+    EXPECT_EQ(renamed_dir.files().size(), 1u);
+}
+
+TEST(SmallLogRotatingSinkTest, earlier_generations) {
+    /* Check the files rotated by an earlier run count as generations */
+
+    temp_dir dir;
+    dir.create("app.log.2024-01-30_23-25-11.000", "\n11");
+    dir.create("app.log.2024-01-30_23-25-12.000.2", "\n12.2");
+    dir.create("app.log.2024-01-30_23-25-12.000.10", "\n12.10");
+    dir.create("app.log.2024-01-30_23-25-10.000", "\n10");
+    dir.create("app.log.2024-01-30_23-25-13.000", "\n13");
+    dir.create("app.log.backup", "\nbackup");
+    dir.create("app.log.2024-01-30", "\nnot rotated");
+
+    slog::rotating_file_sink sink;
+    sink.set_max_size(10);
+    sink.set_max_files(3);
+    sink.set_time_provider(same_time);
+    ASSERT_TRUE(sink.open(dir.path("app.log").c_str()));
+
+    /* The oldest rotated files beyond the limit are deleted right away */
+    std::vector<std::string> files = dir.files();
+    ASSERT_EQ(files.size(), 7u);
+    EXPECT_EQ(files[0], "app.log");
+    EXPECT_EQ(files[1], "app.log.2024-01-30");
+    EXPECT_EQ(files[2], "app.log.2024-01-30_23-25-12.000.10");
+    EXPECT_EQ(files[3], "app.log.2024-01-30_23-25-12.000.2");
+    EXPECT_EQ(files[4], "app.log.2024-01-30_23-25-13.000");
+    EXPECT_EQ(files[5], "app.log.backup");
+    EXPECT_EQ(files[6], "app.log.next");
+
+    /* A rotation drops the oldest of them */
+    sink.write(make_record("\nrecord 01"));
+    sink.write(make_record("\nrecord 02"));
+    sink.flush();
+    EXPECT_EQ(sink.get_rotations(), 1u);
+    sink.close();
+
+    files = dir.files();
+    ASSERT_EQ(files.size(), 6u);
+    EXPECT_EQ(files[2], "app.log.2024-01-30_23-25-12.000.10");
+    EXPECT_EQ(files[3], "app.log.2024-01-30_23-25-13.000");
+    EXPECT_EQ(files[4], "app.log.2024-01-30_23-25-16.000");
+    EXPECT_EQ(dir.content("app.log.2024-01-30_23-25-16.000"), "\nrecord 01");
+}
+
+TEST(SmallLogRotatingSinkTest, bounded_latency) {
+    /* Check the records never wait for a rotation, even when it is slow */
+
+    temp_dir dir;
+    slog::rotating_file_sink sink;
+    sink.set_max_size(512);
+    sink.set_max_files(MAX_ROTATING_FILES);
+
+    /* Each rotation takes at least 30ms in the background thread */
+    sink.set_time_provider([]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(30));
+        return next_second();
+    });
+    ASSERT_TRUE(sink.open(dir.path("app.log").c_str()));
+
+    auto logger = slog::logger("test_logger");
+    EXPECT_TRUE(logger.add_sink(sink));
+
+    std::chrono::steady_clock::duration max_latency(0);
+    int nbr_records = 0;
+    const auto end = std::chrono::steady_clock::now() + std::chrono::milliseconds(300);
+    while (std::chrono::steady_clock::now() < end) {
+        const auto start = std::chrono::steady_clock::now();
+        logger.log(slog::logger::level::info, "record ") << nbr_records;
+        max_latency = std::max(max_latency, std::chrono::steady_clock::now() - start);
+        nbr_records += 1;
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    sink.close();
+
+    /* Several rotations happened, none of them was paid by a record */
+    EXPECT_GE(sink.get_rotations(), 3u);
+    EXPECT_LT(max_latency, std::chrono::milliseconds(15));
+
+    /* No record was lost, and each file is in order */
+    std::string all;
+    for (const std::string& name : dir.files()) {
+        if (name != "app.log") {
+            all += dir.content(name);
+        }
+    }
+    all += dir.content("app.log");
+    std::string expected;
+    for (int i = 0; i < nbr_records; ++i) {
+        expected += "\n[INFO ][test_logger] record " + std::to_string(i);
+    }
+    EXPECT_EQ(all, expected);
+}
@@ -885,3 +885,222 @@ TEST(SmallLogTest, logger_makros) {
     SLOG_FATAL(logger, "Fatal message ") << "test";
     EXPECT_EQ(ss.str(), "\n[23:25:16.753][FATAL][test_logger] Fatal message test");
 }
+
+
+/* Sink used to check how the records are delivered */
+class test_sink : public slog::sink {
+public:
+    using slog::sink::write;
+
+    void write(const slog::record& rec) override {
+        nbr_writes += 1;
+        last = std::string(rec.data, rec.size);
+        last_level = rec.lvl;
+    }
+
+    int nbr_writes = 0;
+    std::string last;
+    slog::logger::level last_level = slog::logger::level::disabled;
+};
+
+TEST(SmallLogTest, logger_sink_single_record) {
+    /* Check the sinks receive each record exactly once, complete and with its length */
+
+    /* Create a logger */
+    auto logger = slog::logger("test_logger");
+
+    /* Sink to receive the records */
+    test_sink sink;
+
+    /* Add the sink to the logger */
+    EXPECT_TRUE(logger.add_sink(sink));
+
+    /* A record built with the << operator is still delivered in one piece */
+    logger.log(slog::logger::level::info, "Operator << ") << slog::logger::radix::hex << 170 << " | " << std::chrono::milliseconds(5);
+    EXPECT_EQ(sink.nbr_writes, 1);
+    EXPECT_EQ(sink.last, "\n[INFO ][test_logger] Operator << 0xAA | 5ms");
+    EXPECT_EQ(sink.last_level, slog::logger::level::info);
+
+    /* Filtered records never reach the sink */
+    logger.log(slog::logger::level::debug, "Debug message ") << "test";
+    EXPECT_EQ(sink.nbr_writes, 1);
+
+    /* string_view messages are not required to be null terminated */
+    std::string_view str_vw = std::string_view("string_view test").substr(0, 11);
+    logger.log(slog::logger::level::warn, str_vw);
+    EXPECT_EQ(sink.nbr_writes, 2);
+    EXPECT_EQ(sink.last, "\n[WARN ][test_logger] string_view");
+}
+
+TEST(SmallLogTest, logger_sink_and_appender) {
+    /* Check sinks and appenders share the same slots and both get the whole record */
+
+    /* Create a logger */
+    auto logger = slog::logger("test_logger");
+
+    /* Appender that counts how many times it is called */
+    int nbr_calls = 0;
+    std::stringstream ss;
+    auto appender = [&ss, &nbr_calls](const char *msg) {
+        ss << msg;
+        nbr_calls += 1;
+    };
+
+    test_sink sink;
+
+    /* Add the appender and fill the remaining slots with the sink */
+    EXPECT_TRUE(logger.add_appender(appender));
+    for (int i = 1; i < MAX_NBR_LOG_APPENDER; i++) {
+        EXPECT_TRUE(logger.add_sink(sink));
+    }
+    EXPECT_FALSE(logger.add_sink(sink));
+
+    logger.log(slog::logger::level::error, "Error message ") << "test";
+    EXPECT_EQ(nbr_calls, 1);
+    EXPECT_EQ(ss.str(), "\n[ERROR][test_logger] Error message test");
+    EXPECT_EQ(sink.nbr_writes, MAX_NBR_LOG_APPENDER - 1);
+}
+
+TEST(SmallLogTest, logger_sink_batch) {
+    /* Check the default batch write delivers every record in order */
+
+    test_sink sink;
+
+    const slog::record records[] = {
+        {"\nfirst", 6, slog::logger::level::info},
+        {"\nsecond", 7, slog::logger::level::warn}
+    };
+
+    sink.write(slog::span<const slog::record>(records, 2));
+    EXPECT_EQ(sink.nbr_writes, 2);
+    EXPECT_EQ(sink.last, "\nsecond");
+    EXPECT_EQ(sink.last_level, slog::logger::level::warn);
+}
+
+TEST(SmallLogTest, logger_record_truncation) {
+    /* Check records longer than the record buffer are truncated */
+
+    /* Create a logger */
+    auto logger = slog::logger("test_logger");
+
+    test_sink sink;
+    logger.add_sink(sink);
+
+    std::string long_msg(2 * MAX_LOG_RECORD_LEN, 'x');
+    logger.log(slog::logger::level::info, long_msg) << "tail";
+    EXPECT_EQ(sink.nbr_writes, 1);
+    EXPECT_EQ(sink.last.size(), MAX_LOG_RECORD_LEN - 1);
+}
+
+TEST(SmallLogTest, logger_early_level_gate) {
+    /* Check filtered records don't call the time provider nor evaluate the makro arguments */
+
+    /* Create a logger */
+    auto logger = slog::logger("test_logger");
+
+    test_sink sink;
+    logger.add_sink(sink);
+
+    /* Time provider that counts how many times it is called */
+    int nbr_time_calls = 0;
+    logger.set_time_provider([&nbr_time_calls]() {
+        nbr_time_calls += 1;
+        return slog::timedate();
+    });
+
+    /* Function with side effects used as makro argument */
+    int nbr_evaluations = 0;
+    auto side_effect = [&nbr_evaluations]() {
+        nbr_evaluations += 1;
+        return "evaluated";
+    };
+
+    /* Default level is INFO */
+    EXPECT_FALSE(logger.is_enabled(slog::logger::level::trace));
+    EXPECT_FALSE(logger.is_enabled(slog::logger::level::debug));
+    EXPECT_TRUE(logger.is_enabled(slog::logger::level::info));
+    EXPECT_TRUE(logger.is_enabled(slog::logger::level::fatal));
+    EXPECT_FALSE(logger.is_enabled(slog::logger::level::disabled));
+
+    /* Filtered calls through log() don't format anything */
+    logger.log(slog::logger::level::debug, "Debug message ") << "test" << 42;
+    EXPECT_EQ(nbr_time_calls, 0);
+    EXPECT_EQ(sink.nbr_writes, 0);
+
+    /* Filtered makros don't even evaluate the message and the << operands */
+    SLOG_TRACE(logger, side_effect()) << side_effect();
+    SLOG_DEBUG(logger, side_effect()) << side_effect();
+    EXPECT_EQ(nbr_evaluations, 0);
+    EXPECT_EQ(nbr_time_calls, 0);
+    EXPECT_EQ(sink.nbr_writes, 0);
+
+    /* Enabled makros evaluate everything once */
+    SLOG_INFO(logger, side_effect()) << " " << side_effect();
+    EXPECT_EQ(nbr_evaluations, 2);
+    EXPECT_EQ(nbr_time_calls, 1);
+    EXPECT_EQ(sink.nbr_writes, 1);
+    EXPECT_EQ(sink.last, "\n[00:00:00.000][INFO ][test_logger] evaluated evaluated");
+
+    /* Disabled logger filters everything */
+    logger.set_Level(slog::logger::level::disabled);
+    EXPECT_FALSE(logger.is_enabled(slog::logger::level::fatal));
+    SLOG_FATAL(logger, side_effect());
+    EXPECT_EQ(nbr_evaluations, 2);
+
+    /* The makros can be used in unbraced if/else statements */
+    logger.set_Level(slog::logger::level::info);
+    bool branch = false;
+    if (nbr_evaluations == 0)
+        SLOG_INFO(logger, "not logged");
+    else
+        branch = true;
+    EXPECT_TRUE(branch);
+    EXPECT_EQ(sink.nbr_writes, 1);
+}
+
+/* Tick counter in milliseconds, starts at 2024/01/30 23:25:16.998 */
+static uint64_t tick_ms = 0;
+static uint64_t tick_source_ms() {
+    return tick_ms;
+}
+
+TEST(SmallLogTest, logger_tick_source) {
+    /* Check the raw tick source gives the same timestamps as the time provider */
+
+    /* Create a logger */
+    auto logger = slog::logger("test_logger");
+
+    test_sink sink;
+    logger.add_sink(sink);
+
+    /* Invalid sources are ignored */
+    logger.set_tick_source(nullptr, 1000);
+    logger.set_tick_source(tick_source_ms, 0);
+    logger.log(slog::logger::level::info, "no time");
+    EXPECT_EQ(sink.last, "\n[INFO ][test_logger] no time");
+
+    tick_ms = 1706657116998ull;
+    logger.set_tick_source(tick_source_ms, 1000);
+    logger.log(slog::logger::level::info, "tick ") << 1;
+    EXPECT_EQ(sink.last, "\n[23:25:16.998][INFO ][test_logger] tick 1");
+
+    /* Cross the second and the day boundaries */
+    tick_ms += 3;
+    logger.log(slog::logger::level::info, "tick ") << 2;
+    EXPECT_EQ(sink.last, "\n[23:25:17.001][INFO ][test_logger] tick 2");
+
+    logger.set_print_date(true);
+    tick_ms += 35 * 60 * 1000;
+    logger.log(slog::logger::level::info, "tick ") << 3;
+    EXPECT_EQ(sink.last, "\n[2024/01/31 00:00:17.001][INFO ][test_logger] tick 3");
+
+    /* A counter starting at 0 is printed as the elapsed time */
+    tick_ms = 90061001ull;
+    logger.log(slog::logger::level::info, "tick ") << 4;
+    EXPECT_EQ(sink.last, "\n[1970/01/02 01:01:01.001][INFO ][test_logger] tick 4");
+
+    /* Setting a time provider replaces the tick source */
+    logger.set_time_provider([]() { return slog::timedate(); });
+    logger.log(slog::logger::level::info, "tick ") << 5;
+    EXPECT_EQ(sink.last, "\n[2000/01/01 00:00:00.000][INFO ][test_logger] tick 5");
+}
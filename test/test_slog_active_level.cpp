@@ -0,0 +1,81 @@
+/* Everything below WARN is stripped at compile time in this translation unit */
+#define SLOG_ACTIVE_LEVEL SLOG_LEVEL_WARN
+
+#include "slog.h"
+
+#include "gtest/gtest.h"
+
+#include <string>
+
+
+/* Declared but never defined: if a stripped makro generated any code referencing it
+ * this test would fail to link */
+const char* never_defined_message();
+int never_defined_value();
+
+
+TEST(SmallLogActiveLevelTest, stripped_makros) {
+    /* Check the makros below SLOG_ACTIVE_LEVEL produce no code and no side effects,
+     * even if the runtime level would let them through */
+
+    /* Create a logger */
+    auto logger = slog::logger("test_logger");
+
+    /* Appender that counts how many times it is called */
+    int nbr_calls = 0;
+    std::string last;
+    logger.add_appender([&nbr_calls, &last](const char *msg) {
+        nbr_calls += 1;
+        last = msg;
+    });
+
+    /* Runtime level lets everything through */
+    logger.set_Level(slog::logger::level::trace);
+
+    /* Function with side effects used as makro argument */
+    int nbr_evaluations = 0;
+    auto side_effect = [&nbr_evaluations]() {
+        nbr_evaluations += 1;
+        return "evaluated";
+    };
+
+    /* Stripped calls */
+    SLOG_TRACE(logger, never_defined_message()) << never_defined_value();
+    SLOG_DEBUG(logger, never_defined_message()) << never_defined_value();
+    SLOG_INFO(logger, never_defined_message()) << never_defined_value();
+    SLOG_TRACE(logger, side_effect()) << side_effect();
+    SLOG_DEBUG(logger, side_effect()) << side_effect();
+    SLOG_INFO(logger, side_effect()) << side_effect();
+    SLOG_DEBUG_EVERY_N(logger, 2, never_defined_message()) << never_defined_value();
+    SLOG_INFO_EVERY_MS(logger, 10, side_effect()) << side_effect();
+    SLOG_INFO_RATE(logger, 10, 1, side_effect()) << side_effect();
+    EXPECT_EQ(nbr_evaluations, 0);
+    EXPECT_EQ(nbr_calls, 0);
+
+    /* Stripped makros are still safe inside unbraced if/else statements */
+    bool branch = false;
+    if (nbr_calls != 0)
+        SLOG_DEBUG(logger, "not logged");
+    else
+        branch = true;
+    EXPECT_TRUE(branch);
+
+    /* Calls at or above the active level are still compiled in */
+    SLOG_WARN(logger, side_effect());
+    EXPECT_EQ(nbr_evaluations, 1);
+    EXPECT_EQ(nbr_calls, 1);
+    EXPECT_EQ(last, "\n[WARN ][test_logger] evaluated");
+
+    SLOG_ERROR(logger, "Error message ") << "test";
+    EXPECT_EQ(last, "\n[ERROR][test_logger] Error message test");
+
+    SLOG_FATAL(logger, "Fatal message ") << "test";
+    EXPECT_EQ(nbr_calls, 3);
+    EXPECT_EQ(last, "\n[FATAL][test_logger] Fatal message test");
+
+    /* And they keep the runtime level check */
+    logger.set_Level(slog::logger::level::fatal);
+    SLOG_ERROR(logger, side_effect());
+    EXPECT_EQ(nbr_evaluations, 1);
+    EXPECT_EQ(nbr_calls, 3);
+}
@@ -0,0 +1,48 @@
+#include "timestamp.h"
+
+#include "gtest/gtest.h"
+
+#include <string>
+
+
+static slog::timedate make_time(uint16_t year, uint8_t month, uint8_t day,
+                                uint8_t hour, uint8_t minute, uint8_t second, uint16_t millisecond) {
+    slog::timedate td;
+    td.setMYear(year);
+    td.setMMonth(month);
+    td.setMDay(day);
+    td.setMHour(hour);
+    td.setMMinute(minute);
+    td.setMSecond(second);
+    td.setMMillisecond(millisecond);
+    return td;
+}
+
+static std::string render(slog::timestamp_cache& cache, const slog::timedate& td, bool print_date) {
+    char out[slog::timestamp_cache::max_len];
+    size_t len = cache.render(td, print_date, out);
+    return std::string(out, len);
+}
+
+
+TEST(SmallLogTimestampTest, cached_rendering) {
+    /* Check the cached timestamp always matches a full rendering */
+
+    slog::timestamp_cache cache;
+
+    /* Default time, nothing to rewrite */
+    EXPECT_EQ(render(cache, slog::timedate(), true), "[2000/01/01 00:00:00.000]");
+
+    EXPECT_EQ(render(cache, make_time(2024, 1, 30, 23, 25, 16, 753), true), "[2024/01/30 23:25:16.753]");
+    EXPECT_EQ(render(cache, make_time(2024, 1, 30, 23, 25, 16, 753), false), "[23:25:16.753]");
+
+    /* Only the milliseconds change */
+    EXPECT_EQ(render(cache, make_time(2024, 1, 30, 23, 25, 16, 754), false), "[23:25:16.754]");
+    EXPECT_EQ(render(cache, make_time(2024, 1, 30, 23, 25, 16, 7), true), "[2024/01/30 23:25:16.007]");
+
+    /* Every field rolls over */
+    EXPECT_EQ(render(cache, make_time(2025, 2, 1, 0, 0, 0, 0), true), "[2025/02/01 00:00:00.000]");
+    EXPECT_EQ(render(cache, make_time(9999, 12, 31, 23, 59, 59, 999), true), "[9999/12/31 23:59:59.999]");
+    EXPECT_EQ(render(cache, make_time(0, 1, 1, 0, 0, 0, 0), true), "[0000/01/01 00:00:00.000]");
+    EXPECT_EQ(render(cache, make_time(0, 1, 1, 0, 0, 0, 0), false), "[00:00:00.000]");
+}
@@ -0,0 +1,65 @@
+//
+// Created by lcrgo on 17/10/2026.
+//
+
+/* Offline decoder for the binary log streams written by slog::binary_logger.
+ * Usage: slog_decode [-d] [file]   (reads stdin when no file is given, -d prints the date) */
+
+#include "binlog.h"
+
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+int main(int argc, char* argv[]) {
+    slog::binary_decoder decoder;
+    const char* path = nullptr;
+
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "-d") == 0) {
+            decoder.set_print_date(true);
+        } else if (std::strcmp(argv[i], "-h") == 0 || path != nullptr) {
+            std::fprintf(stderr, "usage: %s [-d] [file]\n", argv[0]);
+            return 2;
+        } else {
+            path = argv[i];
+        }
+    }
+
+    FILE* input = path != nullptr ? std::fopen(path, "rb") : stdin;
+    if (input == nullptr) {
+        std::perror(path);
+        return 1;
+    }
+
+    /* Decode as the data arrives, keeping the incomplete tail for the next read */
+    std::vector<char> data;
+    char chunk[65536];
+    size_t nbr_read;
+    size_t decoded = 0;
+
+    while ((nbr_read = std::fread(chunk, 1, sizeof(chunk), input)) > 0) {
+        data.insert(data.end(), chunk, chunk + nbr_read);
+        const size_t used = decoder.decode(data.data(), data.size(), [](const slog::record& rec) {
+            std::fwrite(rec.data, 1, rec.size, stdout);
+        });
+        decoded += used;
+        data.erase(data.begin(), data.begin() + static_cast<std::ptrdiff_t>(used));
+    }
+    std::fputc('\n', stdout);
+
+    if (input != stdin) {
+        std::fclose(input);
+    }
+
+    if (decoder.get_skipped() != 0) {
+        std::fprintf(stderr, "slog_decode: %zu records of unknown call sites skipped\n", decoder.get_skipped());
+    }
+
+    if (!data.empty() || decoded == 0) {
+        std::fprintf(stderr, "slog_decode: %zu bytes could not be decoded\n", data.size());
+        return 1;
+    }
+
+    return 0;
+}